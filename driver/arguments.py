@@ -399,6 +399,18 @@ def parse_args():
     driver_other.add_argument(
         "--plan-file", metavar="FILE", default="sas_plan",
         help="write plan(s) to FILE (default: %(default)s; anytime configurations append .1, .2, ...)")
+    driver_other.add_argument(
+        "--heuristic-cache", metavar="FILE",
+        help="store estimates of heuristics with the option "
+            "cache_estimates_persistently=true in FILE, so that later "
+            "search runs on the same task (e.g., later portfolio "
+            "configurations) can reuse them")
+    driver_other.add_argument(
+        "--persistent-data-directory", metavar="DIR",
+        help="store precomputations of search components that support it "
+            "(e.g., PDBs of pattern generators with the option "
+            "cache_pdbs_persistently=true) in DIR, so that later search runs "
+            "on the same task can reuse them")
 
     driver_other.add_argument(
         "--sas-file", metavar="FILE",
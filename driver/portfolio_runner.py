@@ -62,9 +62,10 @@ def adapt_args(args, search_cost_type, heuristic_cost_type, plan_manager):
             break
 
 
-def run_search(executable, args, sas_file, plan_manager, time, memory):
+def run_search(executable, args, sas_file, plan_manager, time, memory,
+               persistence_args):
     complete_args = [executable] + args + [
-        "--internal-plan-file", plan_manager.get_plan_prefix()]
+        "--internal-plan-file", plan_manager.get_plan_prefix()] + persistence_args
     print("args: %s" % complete_args)
 
     try:
@@ -89,7 +90,8 @@ def compute_run_time(timeout, configs, pos):
 
 
 def run_sat_config(configs, pos, search_cost_type, heuristic_cost_type,
-                   executable, sas_file, plan_manager, timeout, memory):
+                   executable, sas_file, plan_manager, timeout, memory,
+                   persistence_args):
     run_time = compute_run_time(timeout, configs, pos)
     if run_time <= 0:
         return None
@@ -100,13 +102,14 @@ def run_sat_config(configs, pos, search_cost_type, heuristic_cost_type,
         args.extend([
             "--internal-previous-portfolio-plans",
             str(plan_manager.get_plan_counter())])
-    result = run_search(executable, args, sas_file, plan_manager, run_time, memory)
+    result = run_search(executable, args, sas_file, plan_manager, run_time,
+                        memory, persistence_args)
     plan_manager.process_new_plans()
     return result
 
 
 def run_sat(configs, executable, sas_file, plan_manager, final_config,
-            final_config_builder, timeout, memory):
+            final_config_builder, timeout, memory, persistence_args):
     # If the configuration contains S_COST_TYPE or H_COST_TRANSFORM and the task
     # has non-unit costs, we start by treating all costs as one. When we find
     # a solution, we rerun the successful config with real costs.
@@ -118,7 +121,8 @@ def run_sat(configs, executable, sas_file, plan_manager, final_config,
         for pos, (relative_time, args) in enumerate(configs):
             exitcode = run_sat_config(
                 configs, pos, search_cost_type, heuristic_cost_type,
-                executable, sas_file, plan_manager, timeout, memory)
+                executable, sas_file, plan_manager, timeout, memory,
+                persistence_args)
             if exitcode is None:
                 return
 
@@ -138,7 +142,8 @@ def run_sat(configs, executable, sas_file, plan_manager, final_config,
                     heuristic_cost_type = "plusone"
                     exitcode = run_sat_config(
                         configs, pos, search_cost_type, heuristic_cost_type,
-                        executable, sas_file, plan_manager, timeout, memory)
+                        executable, sas_file, plan_manager, timeout, memory,
+                        persistence_args)
                     if exitcode is None:
                         return
 
@@ -161,18 +166,19 @@ def run_sat(configs, executable, sas_file, plan_manager, final_config,
         exitcode = run_sat_config(
             [(1, final_config)], 0, search_cost_type,
             heuristic_cost_type, executable, sas_file, plan_manager,
-            timeout, memory)
+            timeout, memory, persistence_args)
         if exitcode is not None:
             yield exitcode
 
 
-def run_opt(configs, executable, sas_file, plan_manager, timeout, memory):
+def run_opt(configs, executable, sas_file, plan_manager, timeout, memory,
+            persistence_args):
     for pos, (relative_time, args) in enumerate(configs):
         run_time = compute_run_time(timeout, configs, pos)
         if run_time <= 0:
             return
         exitcode = run_search(executable, args, sas_file, plan_manager,
-                              run_time, memory)
+                              run_time, memory, persistence_args)
         yield exitcode
 
         if exitcode in [returncodes.SUCCESS, returncodes.SEARCH_UNSOLVABLE]:
@@ -201,13 +207,17 @@ def get_portfolio_attributes(portfolio):
     return attributes
 
 
-def run(portfolio, executable, sas_file, plan_manager, time, memory):
+def run(portfolio, executable, sas_file, plan_manager, time, memory,
+        persistence_args=()):
     """
     Run the configs in the given portfolio file.
 
     The portfolio is allowed to run for at most *time* seconds and may
-    use a maximum of *memory* bytes.
+    use a maximum of *memory* bytes. The arguments *persistence_args*
+    (e.g., a persistent heuristic cache file) are passed to all configs,
+    so that they can share data.
     """
+    persistence_args = list(persistence_args)
     attributes = get_portfolio_attributes(portfolio)
     configs = attributes["CONFIGS"]
     optimal = attributes["OPTIMAL"]
@@ -230,9 +240,10 @@ def run(portfolio, executable, sas_file, plan_manager, time, memory):
 
     if optimal:
         exitcodes = run_opt(
-            configs, executable, sas_file, plan_manager, timeout, memory)
+            configs, executable, sas_file, plan_manager, timeout, memory,
+            persistence_args)
     else:
         exitcodes = run_sat(
             configs, executable, sas_file, plan_manager, final_config,
-            final_config_builder, timeout, memory)
+            final_config_builder, timeout, memory, persistence_args)
     return returncodes.generate_portfolio_exitcode(list(exitcodes))
@@ -107,18 +107,26 @@ def run_search(args):
         single_plan=args.portfolio_single_plan)
     plan_manager.delete_existing_plans()
 
+    persistence_args = []
+    if args.heuristic_cache:
+        persistence_args.extend(["--heuristic-cache", args.heuristic_cache])
+    if args.persistent_data_directory:
+        persistence_args.extend(
+            ["--persistent-data-directory", args.persistent_data_directory])
+
     if args.portfolio:
         assert not args.search_options
         logging.info("search portfolio: %s" % args.portfolio)
         return portfolio_runner.run(
             args.portfolio, executable, args.search_input, plan_manager,
-            time_limit, memory_limit)
+            time_limit, memory_limit, persistence_args=persistence_args)
     else:
         if not args.search_options:
             returncodes.exit_with_driver_input_error(
                 "search needs --alias, --portfolio, or search options")
         if "--help" not in args.search_options:
             args.search_options.extend(["--internal-plan-file", args.plan_file])
+            args.search_options.extend(persistence_args)
         try:
             call.check_call(
                 "search",
@@ -0,0 +1,93 @@
+#! /usr/bin/env python3
+
+"""
+Measure the time for computing a single PDB for increasing pattern sizes
+and numbers of threads.
+
+The script translates the given task, computes a PDB with the greedy
+pattern generator for each combination of maximal PDB size and number
+of threads and reports the wall-clock time of each planner run. The
+search stops after evaluating the initial state, so the time is
+dominated by the PDB computation. Since the PDBs do not depend on the
+number of threads, the script also checks that all runs report the same
+initial heuristic value.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+DEFAULT_TASK = os.path.join(BENCHMARKS_DIR, "satellite", "p25-HC-pfile5.pddl")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "task", nargs="?", default=DEFAULT_TASK,
+        help="PDDL problem file (default: %(default)s)")
+    parser.add_argument(
+        "--build", default="release",
+        help="build used for running the planner (default: %(default)s)")
+    parser.add_argument(
+        "--sizes", type=int, nargs="+",
+        default=[10**4, 10**5, 10**6, 10**7],
+        help="maximal numbers of abstract states (default: %(default)s)")
+    parser.add_argument(
+        "--threads", type=int, nargs="+", default=[1, 2, 4],
+        help="numbers of threads (default: %(default)s)")
+    return parser.parse_args()
+
+
+def translate(task, sas_file, build):
+    subprocess.check_call(
+        [sys.executable, FAST_DOWNWARD, "--build", build,
+         "--sas-file", sas_file, "--translate", task],
+        stdout=subprocess.DEVNULL)
+
+
+def compute_pdb(sas_file, build, max_states, num_threads):
+    config = "astar(pdb(greedy(max_states={}, num_threads={})), bound=0)".format(
+        max_states, num_threads)
+    start = time.perf_counter()
+    output = subprocess.run(
+        [sys.executable, FAST_DOWNWARD, "--build", build, sas_file,
+         "--search", config],
+        stdout=subprocess.PIPE, universal_newlines=True).stdout
+    wall_time = time.perf_counter() - start
+    size = re.search(r"greedy pattern generator PDB size: (\d+)$", output, re.M)
+    h_value = re.search(r"Initial heuristic value for .*: (\S+)$", output, re.M)
+    if not size or not h_value:
+        sys.exit("Could not parse the planner output:\n{}".format(output))
+    return int(size.group(1)), h_value.group(1), wall_time
+
+
+def main():
+    args = parse_args()
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        sas_file = os.path.join(tmp_dir, "output.sas")
+        translate(args.task, sas_file, args.build)
+        print("{:>12} {:>8} {:>8} {:>10}".format(
+            "PDB size", "threads", "h", "time [s]"))
+        for max_states in args.sizes:
+            h_values = set()
+            for num_threads in args.threads:
+                size, h_value, wall_time = compute_pdb(
+                    sas_file, args.build, max_states, num_threads)
+                h_values.add(h_value)
+                print("{:>12} {:>8} {:>8} {:>10.2f}".format(
+                    size, num_threads, h_value, wall_time))
+            if len(h_values) > 1:
+                sys.exit("Initial heuristic values differ: {}".format(
+                    sorted(h_values)))
+
+
+if __name__ == "__main__":
+    main()
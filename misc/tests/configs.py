@@ -117,6 +117,38 @@ def configs_optimal_extended():
         "pdb": [
             "--search",
             "astar(pdb())"],
+        "astar_scp": [
+            "--search",
+            "astar(scp())"],
+        "astar_scp_projections_no_diversification": [
+            "--search",
+            "astar(scp(abstractions=[projections(systematic(2))],"
+            "diversify=false,max_orders=10))"],
+        "astar_scp_cartesian_no_diversification": [
+            "--search",
+            "astar(scp(abstractions=[cartesian()],diversify=false,"
+            "max_orders=10))"],
+        "astar_scp_merge_and_shrink": [
+            "--search",
+            "astar(scp(abstractions=[merge_and_shrink_abstractions("
+            "merge_strategy=merge_sccs(order_of_sccs=topological,"
+            "merge_selector=score_based_filtering(scoring_functions=["
+            "goal_relevance(),dfp(),total_order()])),"
+            "shrink_strategy=shrink_bisimulation(greedy=false),"
+            "label_reduction=exact(before_shrinking=true,"
+            "before_merging=false),max_states=50000,"
+            "threshold_before_merge=1,verbosity=silent)],"
+            "samples=100))"],
+        "astar_scp_all_no_diversification": [
+            "--search",
+            "astar(scp(abstractions=[projections(systematic(2)),cartesian(),"
+            "merge_and_shrink_abstractions("
+            "merge_strategy=merge_precomputed("
+            "merge_tree=linear(variable_order=reverse_level)),"
+            "shrink_strategy=shrink_bisimulation(greedy=false),"
+            "label_reduction=exact(before_shrinking=true,"
+            "before_merging=false),max_states=10000,"
+            "verbosity=silent)],diversify=false))"],
     }
 
 
@@ -64,6 +64,8 @@ fast_downward_plugin(
         per_state_bitset
         per_state_information
         per_task_information
+        persistent_data
+        persistent_heuristic_cache
         plan_manager
         pruning_method
         search_engine
@@ -122,6 +124,7 @@ fast_downward_plugin(
         utils/markup
         utils/math
         utils/memory
+        utils/parallel
         utils/rng
         utils/rng_options
         utils/strings
@@ -660,6 +663,19 @@ fast_downward_plugin(
     DEPENDS ADDITIVE_HEURISTIC DYNAMIC_BITSET EXTRA_TASKS LANDMARKS PRIORITY_QUEUES TASK_PROPERTIES
 )
 
+fast_downward_plugin(
+    NAME COST_SATURATION
+    HELP "Plugin containing the code for saturated cost partitioning heuristics"
+    SOURCES
+        cost_saturation/abstraction
+        cost_saturation/abstraction_generator
+        cost_saturation/cartesian_abstractions
+        cost_saturation/merge_and_shrink_abstractions
+        cost_saturation/projections
+        cost_saturation/saturated_cost_partitioning_heuristic
+    DEPENDS CEGAR MAS_HEURISTIC PDBS PRIORITY_QUEUES SAMPLING TASK_PROPERTIES
+)
+
 fast_downward_plugin(
     NAME MAS_HEURISTIC
     HELP "The Merge-and-Shrink heuristic"
@@ -672,6 +688,8 @@ fast_downward_plugin(
         merge_and_shrink/merge_and_shrink_algorithm
         merge_and_shrink/merge_and_shrink_heuristic
         merge_and_shrink/merge_and_shrink_representation
+        merge_and_shrink/merge_and_shrink_representation_files
+        merge_and_shrink/merge_score_cache
         merge_and_shrink/merge_scoring_function
         merge_and_shrink/merge_scoring_function_dfp
         merge_and_shrink/merge_scoring_function_goal_relevance
@@ -765,6 +783,7 @@ fast_downward_plugin(
         pdbs/pattern_collection_generator_multiple
         pdbs/pattern_collection_generator_systematic
         pdbs/pattern_database_factory
+        pdbs/pattern_database_files
         pdbs/pattern_database
         pdbs/pattern_generator_cegar
         pdbs/pattern_generator_greedy
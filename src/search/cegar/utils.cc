@@ -18,6 +18,7 @@ unique_ptr<additive_heuristic::AdditiveHeuristic> create_additive_heuristic(
     plugins::Options opts;
     opts.set<shared_ptr<AbstractTask>>("transform", task);
     opts.set<bool>("cache_estimates", false);
+    opts.set<bool>("cache_estimates_persistently", false);
     opts.set<utils::Verbosity>("verbosity", utils::Verbosity::SILENT);
     return utils::make_unique_ptr<additive_heuristic::AdditiveHeuristic>(opts);
 }
@@ -1,5 +1,7 @@
 #include "command_line.h"
 
+#include "persistent_data.h"
+#include "persistent_heuristic_cache.h"
 #include "plan_manager.h"
 #include "search_engine.h"
 
@@ -84,6 +86,11 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(const vector<string> &args) {
     string plan_filename = "sas_plan";
     int num_previously_generated_plans = 0;
     bool is_part_of_anytime_portfolio = false;
+    string heuristic_cache_filename;
+    int heuristic_cache_size_in_mb = 64;
+    string persistent_data_directory;
+    string search_arg;
+    bool has_search_arg = false;
 
     using SearchPtr = shared_ptr<SearchEngine>;
     SearchPtr engine = nullptr;
@@ -92,21 +99,13 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(const vector<string> &args) {
         string arg = args[i];
         bool is_last = (i == args.size() - 1);
         if (arg == "--search") {
-            if (engine)
+            if (has_search_arg)
                 input_error("multiple --search arguments defined");
             if (is_last)
                 input_error("missing argument after --search");
             ++i;
-            string search_arg = args[i];
-            try {
-                parser::TokenStream tokens = parser::split_tokens(search_arg);
-                parser::ASTNodePtr parsed = parser::parse(tokens);
-                parser::DecoratedASTNodePtr decorated = parsed->decorate();
-                plugins::Any constructed = decorated->construct();
-                engine = plugins::any_cast<SearchPtr>(constructed);
-            } catch (const utils::ContextError &e) {
-                input_error(e.get_message());
-            }
+            search_arg = args[i];
+            has_search_arg = true;
         } else if (arg == "--help") {
             cout << "Help:" << endl;
             bool txt2tags = false;
@@ -149,17 +148,58 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(const vector<string> &args) {
             num_previously_generated_plans = parse_int_arg(arg, args[i]);
             if (num_previously_generated_plans < 0)
                 input_error("argument for --internal-previous-portfolio-plans must be positive");
+        } else if (arg == "--heuristic-cache") {
+            if (is_last)
+                input_error("missing argument after --heuristic-cache");
+            ++i;
+            heuristic_cache_filename = args[i];
+        } else if (arg == "--heuristic-cache-size") {
+            if (is_last)
+                input_error("missing argument after --heuristic-cache-size");
+            ++i;
+            heuristic_cache_size_in_mb = parse_int_arg(arg, args[i]);
+            if (heuristic_cache_size_in_mb <= 0)
+                input_error("argument for --heuristic-cache-size must be positive");
+        } else if (arg == "--persistent-data-directory") {
+            if (is_last)
+                input_error("missing argument after --persistent-data-directory");
+            ++i;
+            persistent_data_directory = args[i];
         } else {
             input_error("unknown option " + arg);
         }
     }
 
+    /*
+      Components may already load or store persistent data while they
+      are constructed, so we construct the search engine after all other
+      arguments have been processed.
+    */
+    if (!persistent_data_directory.empty()) {
+        persistent_data::set_directory(persistent_data_directory);
+    }
+    if (has_search_arg) {
+        try {
+            parser::TokenStream tokens = parser::split_tokens(search_arg);
+            parser::ASTNodePtr parsed = parser::parse(tokens);
+            parser::DecoratedASTNodePtr decorated = parsed->decorate();
+            plugins::Any constructed = decorated->construct();
+            engine = plugins::any_cast<SearchPtr>(constructed);
+        } catch (const utils::ContextError &e) {
+            input_error(e.get_message());
+        }
+    }
+
     if (engine) {
         PlanManager &plan_manager = engine->get_plan_manager();
         plan_manager.set_plan_filename(plan_filename);
         plan_manager.set_num_previously_generated_plans(num_previously_generated_plans);
         plan_manager.set_is_part_of_anytime_portfolio(is_part_of_anytime_portfolio);
     }
+    if (!heuristic_cache_filename.empty()) {
+        persistent_heuristic_cache::set_cache_file(
+            heuristic_cache_filename, heuristic_cache_size_in_mb);
+    }
     return engine;
 }
 
@@ -200,5 +240,19 @@ string usage(const string &progname) {
            "    This planner call is part of a portfolio which already created\n"
            "    plan files FILENAME.1 up to FILENAME.COUNTER.\n"
            "    Start enumerating plan files with COUNTER+1, i.e. FILENAME.COUNTER+1\n\n"
+           "--heuristic-cache FILENAME\n"
+           "    Store the estimates of heuristics with the option\n"
+           "    cache_estimates_persistently=true in the file FILENAME and reuse\n"
+           "    the estimates stored there by previous runs on the same task.\n"
+           "    Concurrent runs may share the file. Files created for a\n"
+           "    different task are not used and have to be removed manually\n\n"
+           "--heuristic-cache-size SIZE\n"
+           "    Size in MiB of newly created heuristic cache files (default: 64)\n\n"
+           "--persistent-data-directory DIRECTORY\n"
+           "    Store precomputations of components that support it (e.g., PDBs\n"
+           "    of pattern generators with the option cache_pdbs_persistently=true\n"
+           "    and merge-and-shrink heuristics with the option\n"
+           "    cache_abstractions_persistently=true) in DIRECTORY and reuse those\n"
+           "    stored there by previous runs on the same task\n\n"
            "See https://www.fast-downward.org for details.";
 }
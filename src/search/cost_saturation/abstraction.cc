@@ -0,0 +1,134 @@
+#include "abstraction.h"
+
+#include "../algorithms/priority_queues.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace std;
+
+namespace cost_saturation {
+const int INF = numeric_limits<int>::max();
+
+Abstraction::Abstraction(
+    unique_ptr<AbstractionFunction> abstraction_function,
+    int num_states,
+    vector<int> &&goal_states,
+    const vector<vector<int>> &operators_by_label,
+    const vector<AbstractTransition> &transitions)
+    : abstraction_function(move(abstraction_function)),
+      num_states(num_states),
+      goal_states(move(goal_states)) {
+    label_operators_begin.reserve(operators_by_label.size() + 1);
+    for (const vector<int> &operators : operators_by_label) {
+        label_operators_begin.push_back(label_operators.size());
+        label_operators.insert(
+            label_operators.end(), operators.begin(), operators.end());
+    }
+    label_operators_begin.push_back(label_operators.size());
+
+    // Sort the non-looping transitions by target state (counting sort).
+    incoming_begin.assign(num_states + 1, 0);
+    for (const AbstractTransition &transition : transitions) {
+        if (transition.src != transition.target) {
+            ++incoming_begin[transition.target + 1];
+        }
+    }
+    for (int state = 0; state < num_states; ++state) {
+        incoming_begin[state + 1] += incoming_begin[state];
+    }
+    int num_transitions = incoming_begin[num_states];
+    incoming_labels.resize(num_transitions);
+    incoming_sources.resize(num_transitions);
+    vector<int> next_position(incoming_begin.begin(), incoming_begin.end() - 1);
+    for (const AbstractTransition &transition : transitions) {
+        if (transition.src != transition.target) {
+            int position = next_position[transition.target]++;
+            incoming_labels[position] = transition.label;
+            incoming_sources[position] = transition.src;
+        }
+    }
+}
+
+vector<int> Abstraction::compute_label_costs(
+    const vector<int> &operator_costs) const {
+    int num_labels = label_operators_begin.size() - 1;
+    vector<int> label_costs(num_labels, INF);
+    for (int label = 0; label < num_labels; ++label) {
+        for (int i = label_operators_begin[label];
+             i < label_operators_begin[label + 1]; ++i) {
+            label_costs[label] = min(
+                label_costs[label], operator_costs[label_operators[i]]);
+        }
+    }
+    return label_costs;
+}
+
+vector<int> Abstraction::compute_goal_distances(
+    const vector<int> &operator_costs) const {
+    vector<int> label_costs = compute_label_costs(operator_costs);
+    vector<int> distances(num_states, INF);
+    priority_queues::AdaptiveQueue<int> queue;
+    for (int goal : goal_states) {
+        distances[goal] = 0;
+        queue.push(0, goal);
+    }
+    while (!queue.empty()) {
+        pair<int, int> top_pair = queue.pop();
+        int distance = top_pair.first;
+        int state = top_pair.second;
+        if (distances[state] < distance) {
+            continue;
+        }
+        for (int i = incoming_begin[state]; i < incoming_begin[state + 1]; ++i) {
+            int cost = label_costs[incoming_labels[i]];
+            assert(cost >= 0);
+            if (cost == INF) {
+                continue;
+            }
+            int src_distance = distance + cost;
+            int src = incoming_sources[i];
+            if (src_distance < distances[src]) {
+                distances[src] = src_distance;
+                queue.push(src_distance, src);
+            }
+        }
+    }
+    return distances;
+}
+
+vector<int> Abstraction::compute_saturated_costs(
+    const vector<int> &goal_distances, int num_operators) const {
+    assert(static_cast<int>(goal_distances.size()) == num_states);
+    int num_labels = label_operators_begin.size() - 1;
+    vector<int> saturated_label_costs(num_labels, 0);
+    for (int target = 0; target < num_states; ++target) {
+        int target_h = goal_distances[target];
+        if (target_h == INF) {
+            // Transitions into dead ends need no cost.
+            continue;
+        }
+        for (int i = incoming_begin[target]; i < incoming_begin[target + 1]; ++i) {
+            int src_h = goal_distances[incoming_sources[i]];
+            if (src_h == INF) {
+                continue;
+            }
+            int &saturated_cost = saturated_label_costs[incoming_labels[i]];
+            saturated_cost = max(saturated_cost, src_h - target_h);
+        }
+    }
+    vector<int> saturated_costs(num_operators, 0);
+    for (int label = 0; label < num_labels; ++label) {
+        for (int i = label_operators_begin[label];
+             i < label_operators_begin[label + 1]; ++i) {
+            saturated_costs[label_operators[i]] = saturated_label_costs[label];
+        }
+    }
+    return saturated_costs;
+}
+
+unique_ptr<AbstractionFunction> Abstraction::extract_abstraction_function() {
+    return move(abstraction_function);
+}
+}
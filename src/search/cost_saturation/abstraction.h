@@ -0,0 +1,100 @@
+#ifndef COST_SATURATION_ABSTRACTION_H
+#define COST_SATURATION_ABSTRACTION_H
+
+#include <memory>
+#include <vector>
+
+class State;
+
+namespace cost_saturation {
+// Positive infinity. The name "INFINITY" is taken by an ISO C99 macro.
+extern const int INF;
+
+/*
+  Map concrete states to abstract state IDs. States that the abstraction
+  recognizes as dead ends without having an abstract state for them
+  (e.g., states pruned by merge-and-shrink) are mapped to -1.
+*/
+class AbstractionFunction {
+public:
+    virtual ~AbstractionFunction() = default;
+
+    virtual int get_abstract_state_id(const State &state) const = 0;
+};
+
+struct AbstractTransition {
+    int src;
+    int label;
+    int target;
+
+    AbstractTransition(int src, int label, int target)
+        : src(src), label(label), target(target) {
+    }
+};
+
+/*
+  Explicit abstract transition system that is independent of the kind of
+  abstraction it has been computed from.
+
+  Transitions are induced by labels, and each label stands for one or
+  more operators of the task. Projections and Cartesian abstractions use
+  one label per operator, while merge-and-shrink abstractions use the
+  labels that remain after label reduction. Self-loops are dropped since
+  they never matter for goal distances or saturated costs under
+  non-negative cost functions.
+
+  The incoming transitions of all states are stored in flat vectors:
+  the transitions into state s are at the positions
+  incoming_begin[s], ..., incoming_begin[s + 1] - 1 of incoming_labels
+  and incoming_sources.
+*/
+class Abstraction {
+    std::unique_ptr<AbstractionFunction> abstraction_function;
+    int num_states;
+    std::vector<int> goal_states;
+    std::vector<int> label_operators_begin;
+    std::vector<int> label_operators;
+    std::vector<int> incoming_begin;
+    std::vector<int> incoming_labels;
+    std::vector<int> incoming_sources;
+
+    std::vector<int> compute_label_costs(
+        const std::vector<int> &operator_costs) const;
+public:
+    Abstraction(
+        std::unique_ptr<AbstractionFunction> abstraction_function,
+        int num_states,
+        std::vector<int> &&goal_states,
+        const std::vector<std::vector<int>> &operators_by_label,
+        const std::vector<AbstractTransition> &transitions);
+
+    /*
+      Compute the goal distances of all abstract states under the given
+      operator costs. Unsolvable states have distance INF.
+    */
+    std::vector<int> compute_goal_distances(
+        const std::vector<int> &operator_costs) const;
+
+    /*
+      Compute the minimal non-negative operator costs that preserve the
+      given goal distances. The result never exceeds the costs under
+      which the goal distances have been computed.
+    */
+    std::vector<int> compute_saturated_costs(
+        const std::vector<int> &goal_distances, int num_operators) const;
+
+    std::unique_ptr<AbstractionFunction> extract_abstraction_function();
+
+    int get_num_states() const {
+        return num_states;
+    }
+
+    int get_num_transitions() const {
+        return incoming_labels.size();
+    }
+};
+
+using Abstractions = std::vector<std::unique_ptr<Abstraction>>;
+}
+
+#endif
@@ -0,0 +1,24 @@
+#include "abstraction_generator.h"
+
+#include "../plugins/plugin.h"
+
+using namespace std;
+
+namespace cost_saturation {
+AbstractionGenerator::AbstractionGenerator(const plugins::Options &opts)
+    : log(utils::get_log_from_options(opts)) {
+}
+
+void add_abstraction_generator_options_to_feature(plugins::Feature &feature) {
+    utils::add_log_options_to_feature(feature);
+}
+
+static class AbstractionGeneratorCategoryPlugin : public plugins::TypedCategoryPlugin<AbstractionGenerator> {
+public:
+    AbstractionGeneratorCategoryPlugin() : TypedCategoryPlugin("AbstractionGenerator") {
+        document_synopsis(
+            "Factory for abstractions (used by saturated cost partitioning).");
+    }
+}
+_category_plugin;
+}
@@ -0,0 +1,37 @@
+#ifndef COST_SATURATION_ABSTRACTION_GENERATOR_H
+#define COST_SATURATION_ABSTRACTION_GENERATOR_H
+
+#include "abstraction.h"
+
+#include "../utils/logging.h"
+
+#include <memory>
+
+class AbstractTask;
+
+namespace plugins {
+class Feature;
+class Options;
+}
+
+namespace cost_saturation {
+/*
+  Compute explicit abstractions of a task. Abstract transitions must be
+  labeled with operators of the given task.
+*/
+class AbstractionGenerator {
+protected:
+    mutable utils::LogProxy log;
+public:
+    explicit AbstractionGenerator(const plugins::Options &opts);
+    virtual ~AbstractionGenerator() = default;
+
+    virtual Abstractions generate_abstractions(
+        const std::shared_ptr<AbstractTask> &task) = 0;
+};
+
+extern void add_abstraction_generator_options_to_feature(
+    plugins::Feature &feature);
+}
+
+#endif
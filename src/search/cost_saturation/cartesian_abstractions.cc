@@ -0,0 +1,184 @@
+#include "cartesian_abstractions.h"
+
+#include "../cegar/abstract_state.h"
+#include "../cegar/abstraction.h"
+#include "../cegar/cegar.h"
+#include "../cegar/refinement_hierarchy.h"
+#include "../cegar/split_selector.h"
+#include "../cegar/subtask_generators.h"
+#include "../cegar/transition.h"
+#include "../cegar/transition_system.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/rng_options.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace cost_saturation {
+// See the comment on memory padding in cegar/cost_saturation.cc.
+static const int memory_padding_in_mb = 75;
+
+class CartesianAbstractionFunction : public AbstractionFunction {
+    unique_ptr<cegar::RefinementHierarchy> refinement_hierarchy;
+public:
+    explicit CartesianAbstractionFunction(
+        unique_ptr<cegar::RefinementHierarchy> refinement_hierarchy)
+        : refinement_hierarchy(move(refinement_hierarchy)) {
+    }
+
+    virtual int get_abstract_state_id(const State &state) const override {
+        return refinement_hierarchy->get_abstract_state_id(state);
+    }
+};
+
+static unique_ptr<Abstraction> convert_abstraction(
+    cegar::Abstraction &cartesian_abstraction, int num_operators) {
+    const cegar::TransitionSystem &transition_system =
+        cartesian_abstraction.get_transition_system();
+    vector<AbstractTransition> transitions;
+    transitions.reserve(transition_system.get_num_non_loops());
+    int num_states = cartesian_abstraction.get_num_states();
+    for (int state = 0; state < num_states; ++state) {
+        for (const cegar::Transition &transition :
+             transition_system.get_outgoing_transitions()[state]) {
+            transitions.emplace_back(
+                state, transition.op_id, transition.target_id);
+        }
+    }
+    const cegar::Goals &goals = cartesian_abstraction.get_goals();
+    vector<int> goal_states(goals.begin(), goals.end());
+    sort(goal_states.begin(), goal_states.end());
+    // Each operator is its own label.
+    vector<vector<int>> operators_by_label;
+    operators_by_label.reserve(num_operators);
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        operators_by_label.push_back({op_id});
+    }
+    return utils::make_unique_ptr<Abstraction>(
+        utils::make_unique_ptr<CartesianAbstractionFunction>(
+            cartesian_abstraction.extract_refinement_hierarchy()),
+        num_states,
+        move(goal_states),
+        operators_by_label,
+        transitions);
+}
+
+CartesianAbstractionGenerator::CartesianAbstractionGenerator(
+    const plugins::Options &opts)
+    : AbstractionGenerator(opts),
+      subtask_generators(
+          opts.get_list<shared_ptr<cegar::SubtaskGenerator>>("subtasks")),
+      max_states(opts.get<int>("max_states")),
+      max_transitions(opts.get<int>("max_transitions")),
+      max_time(opts.get<double>("max_time")),
+      pick_split(opts.get<cegar::PickSplit>("pick")),
+      rng(utils::parse_rng_from_options(opts)) {
+}
+
+Abstractions CartesianAbstractionGenerator::generate_abstractions(
+    const shared_ptr<AbstractTask> &task) {
+    utils::CountdownTimer timer(max_time);
+    TaskProxy task_proxy(*task);
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+    int num_operators = task_proxy.get_operators().size();
+
+    Abstractions abstractions;
+    int num_states = 0;
+    int num_transitions = 0;
+    auto should_abort = [&]() {
+            return num_states >= max_states ||
+                   num_transitions >= max_transitions ||
+                   timer.is_expired() ||
+                   !utils::extra_memory_padding_is_reserved();
+        };
+
+    utils::reserve_extra_memory_padding(memory_padding_in_mb);
+    for (const shared_ptr<cegar::SubtaskGenerator> &subtask_generator :
+         subtask_generators) {
+        cegar::SharedTasks subtasks = subtask_generator->get_subtasks(task, log);
+        int remaining_subtasks = subtasks.size();
+        for (const shared_ptr<AbstractTask> &subtask : subtasks) {
+            cegar::CEGAR cegar(
+                subtask,
+                max(1, (max_states - num_states) / remaining_subtasks),
+                max(1, (max_transitions - num_transitions) / remaining_subtasks),
+                timer.get_remaining_time() / remaining_subtasks,
+                pick_split,
+                *rng,
+                log);
+            unique_ptr<cegar::Abstraction> cartesian_abstraction =
+                cegar.extract_abstraction();
+            abstractions.push_back(
+                convert_abstraction(*cartesian_abstraction, num_operators));
+            num_states += abstractions.back()->get_num_states();
+            num_transitions += abstractions.back()->get_num_transitions();
+            if (should_abort()) {
+                break;
+            }
+            --remaining_subtasks;
+        }
+        if (should_abort()) {
+            break;
+        }
+    }
+    if (utils::extra_memory_padding_is_reserved()) {
+        utils::release_extra_memory_padding();
+    }
+
+    if (log.is_at_least_normal()) {
+        log << "Cartesian abstractions: " << abstractions.size() << endl;
+        log << "Cartesian states: " << num_states << endl;
+        log << "Cartesian transitions: " << num_transitions << endl;
+        log << "Time for computing Cartesian abstractions: "
+            << timer.get_elapsed_time() << endl;
+    }
+    return abstractions;
+}
+
+class CartesianAbstractionGeneratorFeature
+    : public plugins::TypedFeature<AbstractionGenerator, CartesianAbstractionGenerator> {
+public:
+    CartesianAbstractionGeneratorFeature() : TypedFeature("cartesian") {
+        document_title("Cartesian abstractions");
+        document_synopsis(
+            "Cartesian abstractions of the subtasks computed by the given "
+            "subtask generators, refined with CEGAR as for the additive "
+            "CEGAR heuristic.");
+
+        add_list_option<shared_ptr<cegar::SubtaskGenerator>>(
+            "subtasks",
+            "subtask generators",
+            "[landmarks(),goals()]");
+        add_option<int>(
+            "max_states",
+            "maximum sum of abstract states over all abstractions",
+            "infinity",
+            plugins::Bounds("1", "infinity"));
+        add_option<int>(
+            "max_transitions",
+            "maximum sum of real transitions (excluding self-loops) over "
+            "all abstractions",
+            "1M",
+            plugins::Bounds("0", "infinity"));
+        add_option<double>(
+            "max_time",
+            "maximum time in seconds for building abstractions",
+            "infinity",
+            plugins::Bounds("0.0", "infinity"));
+        add_option<cegar::PickSplit>(
+            "pick",
+            "how to choose on which variable to split the flaw state",
+            "max_refined");
+        utils::add_rng_options(*this);
+        add_abstraction_generator_options_to_feature(*this);
+    }
+};
+
+static plugins::FeaturePlugin<CartesianAbstractionGeneratorFeature> _plugin;
+}
@@ -0,0 +1,38 @@
+#ifndef COST_SATURATION_CARTESIAN_ABSTRACTIONS_H
+#define COST_SATURATION_CARTESIAN_ABSTRACTIONS_H
+
+#include "abstraction_generator.h"
+
+#include <vector>
+
+namespace cegar {
+enum class PickSplit;
+class SubtaskGenerator;
+}
+
+namespace utils {
+class RandomNumberGenerator;
+}
+
+namespace cost_saturation {
+/*
+  Build a Cartesian abstraction with CEGAR for each subtask. Unlike the
+  additive CEGAR heuristic, each abstraction is refined for the original
+  operator costs, since the cost partitioning is only computed later.
+*/
+class CartesianAbstractionGenerator : public AbstractionGenerator {
+    const std::vector<std::shared_ptr<cegar::SubtaskGenerator>> subtask_generators;
+    const int max_states;
+    const int max_transitions;
+    const double max_time;
+    const cegar::PickSplit pick_split;
+    std::shared_ptr<utils::RandomNumberGenerator> rng;
+public:
+    explicit CartesianAbstractionGenerator(const plugins::Options &opts);
+
+    virtual Abstractions generate_abstractions(
+        const std::shared_ptr<AbstractTask> &task) override;
+};
+}
+
+#endif
@@ -0,0 +1,150 @@
+#include "merge_and_shrink_abstractions.h"
+
+#include "../merge_and_shrink/distances.h"
+#include "../merge_and_shrink/factored_transition_system.h"
+#include "../merge_and_shrink/labels.h"
+#include "../merge_and_shrink/merge_and_shrink_algorithm.h"
+#include "../merge_and_shrink/merge_and_shrink_representation.h"
+#include "../merge_and_shrink/transition_system.h"
+#include "../merge_and_shrink/types.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/timer.h"
+
+using namespace std;
+
+namespace cost_saturation {
+class MergeAndShrinkAbstractionFunction : public AbstractionFunction {
+    merge_and_shrink::FlatMergeAndShrinkRepresentation representation;
+public:
+    explicit MergeAndShrinkAbstractionFunction(
+        const merge_and_shrink::MergeAndShrinkRepresentation &representation)
+        : representation(representation) {
+    }
+
+    virtual int get_abstract_state_id(const State &state) const override {
+        state.unpack();
+        int abstract_state_id =
+            representation.get_value(state.get_unpacked_values());
+        if (abstract_state_id == merge_and_shrink::PRUNED_STATE) {
+            return -1;
+        }
+        return abstract_state_id;
+    }
+};
+
+static unique_ptr<Abstraction> extract_abstraction(
+    merge_and_shrink::FactoredTransitionSystem &fts, int index,
+    const vector<int> &operator_labels) {
+    const merge_and_shrink::TransitionSystem &ts =
+        fts.get_transition_system(index);
+    const merge_and_shrink::Labels &labels = fts.get_labels();
+
+    vector<int> label_to_group(labels.get_num_total_labels(), -1);
+    vector<AbstractTransition> transitions;
+    int num_groups = 0;
+    for (const merge_and_shrink::LocalLabelInfo &local_label_info : ts) {
+        for (int label : local_label_info.get_label_group()) {
+            label_to_group[label] = num_groups;
+        }
+        for (const merge_and_shrink::Transition &transition :
+             local_label_info.get_transitions()) {
+            transitions.emplace_back(transition.src, num_groups, transition.target);
+        }
+        ++num_groups;
+    }
+    vector<vector<int>> operators_by_group(num_groups);
+    for (size_t op_id = 0; op_id < operator_labels.size(); ++op_id) {
+        int group = label_to_group[operator_labels[op_id]];
+        assert(group != -1);
+        operators_by_group[group].push_back(op_id);
+    }
+
+    vector<int> goal_states;
+    for (int state = 0; state < ts.get_size(); ++state) {
+        if (ts.is_goal_state(state)) {
+            goal_states.push_back(state);
+        }
+    }
+    int num_states = ts.get_size();
+    return utils::make_unique_ptr<Abstraction>(
+        utils::make_unique_ptr<MergeAndShrinkAbstractionFunction>(
+            *fts.extract_factor(index).first),
+        num_states,
+        move(goal_states),
+        operators_by_group,
+        transitions);
+}
+
+MergeAndShrinkAbstractionGenerator::MergeAndShrinkAbstractionGenerator(
+    const plugins::Options &opts)
+    : AbstractionGenerator(opts),
+      algorithm(make_shared<merge_and_shrink::MergeAndShrinkAlgorithm>(opts)) {
+}
+
+Abstractions MergeAndShrinkAbstractionGenerator::generate_abstractions(
+    const shared_ptr<AbstractTask> &task) {
+    utils::Timer timer;
+    TaskProxy task_proxy(*task);
+    task_properties::verify_no_axioms(task_proxy);
+    merge_and_shrink::FactoredTransitionSystem fts =
+        algorithm->build_factored_transition_system(task_proxy);
+
+    // The initial labels of the factored transition system are the operators.
+    const merge_and_shrink::Labels &labels = fts.get_labels();
+    int num_operators = task_proxy.get_operators().size();
+    vector<int> operator_labels;
+    operator_labels.reserve(num_operators);
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        operator_labels.push_back(labels.get_active_label(op_id));
+    }
+
+    Abstractions abstractions;
+    int num_states = 0;
+    int num_transitions = 0;
+    for (int index : fts) {
+        if (fts.is_factor_trivial(index)) {
+            continue;
+        }
+        abstractions.push_back(extract_abstraction(fts, index, operator_labels));
+        num_states += abstractions.back()->get_num_states();
+        num_transitions += abstractions.back()->get_num_transitions();
+    }
+    if (log.is_at_least_normal()) {
+        log << "Merge-and-shrink abstractions: " << abstractions.size() << endl;
+        log << "Merge-and-shrink states: " << num_states << endl;
+        log << "Merge-and-shrink transitions: " << num_transitions << endl;
+        log << "Time for computing merge-and-shrink abstractions: "
+            << timer << endl;
+    }
+    return abstractions;
+}
+
+class MergeAndShrinkAbstractionGeneratorFeature
+    : public plugins::TypedFeature<AbstractionGenerator, MergeAndShrinkAbstractionGenerator> {
+public:
+    MergeAndShrinkAbstractionGeneratorFeature() : TypedFeature("merge_and_shrink_abstractions") {
+        document_title("Merge-and-shrink abstractions");
+        document_synopsis(
+            "The nontrivial factors that remain after running the "
+            "merge-and-shrink algorithm. All options are the same as for the "
+            "merge-and-shrink heuristic, and label reduction is supported. If "
+            "the main loop stops early, each remaining factor becomes a "
+            "separate abstraction.");
+
+        merge_and_shrink::add_merge_and_shrink_algorithm_options_to_feature(*this);
+        add_abstraction_generator_options_to_feature(*this);
+    }
+
+    virtual shared_ptr<MergeAndShrinkAbstractionGenerator> create_component(
+        const plugins::Options &options, const utils::Context &context) const override {
+        plugins::Options options_copy(options);
+        merge_and_shrink::handle_shrink_limit_options_defaults(options_copy, context);
+        return make_shared<MergeAndShrinkAbstractionGenerator>(options_copy);
+    }
+};
+
+static plugins::FeaturePlugin<MergeAndShrinkAbstractionGeneratorFeature> _plugin;
+}
@@ -0,0 +1,27 @@
+#ifndef COST_SATURATION_MERGE_AND_SHRINK_ABSTRACTIONS_H
+#define COST_SATURATION_MERGE_AND_SHRINK_ABSTRACTIONS_H
+
+#include "abstraction_generator.h"
+
+namespace merge_and_shrink {
+class MergeAndShrinkAlgorithm;
+}
+
+namespace cost_saturation {
+/*
+  Run the merge-and-shrink algorithm and turn each remaining nontrivial
+  factor into an abstraction. Transitions are labeled with the label
+  groups of the factor, and each label group stands for all operators
+  whose labels have been reduced to a label in the group.
+*/
+class MergeAndShrinkAbstractionGenerator : public AbstractionGenerator {
+    std::shared_ptr<merge_and_shrink::MergeAndShrinkAlgorithm> algorithm;
+public:
+    explicit MergeAndShrinkAbstractionGenerator(const plugins::Options &opts);
+
+    virtual Abstractions generate_abstractions(
+        const std::shared_ptr<AbstractTask> &task) override;
+};
+}
+
+#endif
@@ -0,0 +1,260 @@
+#include "projections.h"
+
+#include "../plugins/plugin.h"
+#include "../pdbs/pattern_database.h"
+#include "../pdbs/pattern_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/math.h"
+#include "../utils/memory.h"
+#include "../utils/timer.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace cost_saturation {
+class ProjectionFunction : public AbstractionFunction {
+    const pdbs::Pattern pattern;
+    vector<int> hash_multipliers;
+public:
+    explicit ProjectionFunction(const pdbs::Projection &projection)
+        : pattern(projection.get_pattern()) {
+        hash_multipliers.reserve(pattern.size());
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            hash_multipliers.push_back(projection.get_multiplier(i));
+        }
+    }
+
+    virtual int get_abstract_state_id(const State &state) const override {
+        state.unpack();
+        const vector<int> &values = state.get_unpacked_values();
+        int index = 0;
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            index += hash_multipliers[i] * values[pattern[i]];
+        }
+        return index;
+    }
+};
+
+/*
+  Call callback(index, values) for all abstract states that agree with the
+  given values on all pattern positions whose value is not -1. The values
+  passed to the callback hold the values of all pattern variables.
+*/
+template<typename Callback>
+static void for_each_matching_state(
+    const pdbs::Projection &projection, const vector<int> &domain_sizes,
+    const vector<int> &fixed_values, const Callback &callback) {
+    int pattern_size = fixed_values.size();
+    vector<int> values(pattern_size);
+    vector<int> free_positions;
+    int index = 0;
+    for (int i = 0; i < pattern_size; ++i) {
+        if (fixed_values[i] == -1) {
+            free_positions.push_back(i);
+            values[i] = 0;
+        } else {
+            values[i] = fixed_values[i];
+            index += projection.get_multiplier(i) * values[i];
+        }
+    }
+    while (true) {
+        callback(index, values);
+        // Advance the free values like the digits of a mixed-radix number.
+        size_t j = 0;
+        for (; j < free_positions.size(); ++j) {
+            int pos = free_positions[j];
+            if (values[pos] + 1 < domain_sizes[pos]) {
+                ++values[pos];
+                index += projection.get_multiplier(pos);
+                break;
+            }
+            index -= values[pos] * projection.get_multiplier(pos);
+            values[pos] = 0;
+        }
+        if (j == free_positions.size()) {
+            break;
+        }
+    }
+}
+
+/*
+  Return nullptr if the projection has more than max_states abstract states
+  or more than max_transitions transitions (including self-loops of
+  operators that affect the pattern).
+*/
+static unique_ptr<Abstraction> compute_projection(
+    const TaskProxy &task_proxy, const pdbs::Pattern &pattern,
+    int max_states, int max_transitions) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_states = 1;
+    for (int var : pattern) {
+        int domain_size = variables[var].get_domain_size();
+        if (!utils::is_product_within_limit(num_states, domain_size, max_states)) {
+            return nullptr;
+        }
+        num_states *= domain_size;
+    }
+    pdbs::Projection projection(task_proxy, pattern);
+    int pattern_size = pattern.size();
+    vector<int> variable_to_position(variables.size(), -1);
+    vector<int> domain_sizes;
+    domain_sizes.reserve(pattern_size);
+    for (int i = 0; i < pattern_size; ++i) {
+        variable_to_position[pattern[i]] = i;
+        domain_sizes.push_back(variables[pattern[i]].get_domain_size());
+    }
+
+    vector<int> goal_values(pattern_size, -1);
+    for (FactProxy goal : task_proxy.get_goals()) {
+        int pos = variable_to_position[goal.get_variable().get_id()];
+        if (pos != -1) {
+            goal_values[pos] = goal.get_value();
+        }
+    }
+    vector<int> goal_states;
+    for_each_matching_state(
+        projection, domain_sizes, goal_values,
+        [&](int index, const vector<int> &) {
+            goal_states.push_back(index);
+        });
+
+    /*
+      Each operator that affects the pattern gets its own label. All other
+      operators only induce self-loops.
+    */
+    vector<vector<int>> operators_by_label;
+    vector<AbstractTransition> transitions;
+    vector<int> precondition_values(pattern_size);
+    vector<pair<int, int>> effects;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        effects.clear();
+        for (EffectProxy effect : op.get_effects()) {
+            FactPair fact = effect.get_fact().get_pair();
+            int pos = variable_to_position[fact.var];
+            if (pos != -1) {
+                effects.emplace_back(pos, fact.value);
+            }
+        }
+        if (effects.empty()) {
+            continue;
+        }
+        fill(precondition_values.begin(), precondition_values.end(), -1);
+        for (FactProxy precondition : op.get_preconditions()) {
+            FactPair fact = precondition.get_pair();
+            int pos = variable_to_position[fact.var];
+            if (pos != -1) {
+                precondition_values[pos] = fact.value;
+            }
+        }
+        // Check the limit before materializing the transitions of op.
+        int num_op_transitions = num_states;
+        for (int pos = 0; pos < pattern_size; ++pos) {
+            if (precondition_values[pos] != -1) {
+                num_op_transitions /= domain_sizes[pos];
+            }
+        }
+        int num_remaining_transitions =
+            max_transitions - static_cast<int>(transitions.size());
+        if (num_op_transitions > num_remaining_transitions) {
+            return nullptr;
+        }
+        int label = operators_by_label.size();
+        operators_by_label.push_back({op.get_id()});
+        for_each_matching_state(
+            projection, domain_sizes, precondition_values,
+            [&](int index, const vector<int> &values) {
+                int successor_index = index;
+                for (const pair<int, int> &effect : effects) {
+                    int pos = effect.first;
+                    successor_index += projection.get_multiplier(pos) *
+                        (effect.second - values[pos]);
+                }
+                transitions.emplace_back(index, label, successor_index);
+            });
+    }
+
+    return utils::make_unique_ptr<Abstraction>(
+        utils::make_unique_ptr<ProjectionFunction>(projection),
+        projection.get_num_abstract_states(),
+        move(goal_states),
+        operators_by_label,
+        transitions);
+}
+
+ProjectionGenerator::ProjectionGenerator(const plugins::Options &opts)
+    : AbstractionGenerator(opts),
+      pattern_generator(
+          opts.get<shared_ptr<pdbs::PatternCollectionGenerator>>("patterns")),
+      max_states(opts.get<int>("max_states")),
+      max_transitions(opts.get<int>("max_transitions")) {
+}
+
+Abstractions ProjectionGenerator::generate_abstractions(
+    const shared_ptr<AbstractTask> &task) {
+    utils::Timer timer;
+    TaskProxy task_proxy(*task);
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+
+    shared_ptr<pdbs::PatternCollection> patterns =
+        pattern_generator->generate(task).get_patterns();
+    Abstractions abstractions;
+    abstractions.reserve(patterns->size());
+    int num_states = 0;
+    int num_transitions = 0;
+    int num_skipped_patterns = 0;
+    for (const pdbs::Pattern &pattern : *patterns) {
+        unique_ptr<Abstraction> abstraction = compute_projection(
+            task_proxy, pattern, max_states, max_transitions);
+        if (!abstraction) {
+            ++num_skipped_patterns;
+            continue;
+        }
+        num_states += abstraction->get_num_states();
+        num_transitions += abstraction->get_num_transitions();
+        abstractions.push_back(move(abstraction));
+    }
+    if (log.is_at_least_normal()) {
+        log << "Projections: " << abstractions.size() << endl;
+        log << "Skipped patterns exceeding the size limits: "
+            << num_skipped_patterns << endl;
+        log << "Projection states: " << num_states << endl;
+        log << "Projection transitions: " << num_transitions << endl;
+        log << "Time for computing projections: " << timer << endl;
+    }
+    return abstractions;
+}
+
+class ProjectionGeneratorFeature : public plugins::TypedFeature<AbstractionGenerator, ProjectionGenerator> {
+public:
+    ProjectionGeneratorFeature() : TypedFeature("projections") {
+        document_title("Projections");
+        document_synopsis(
+            "Projections of the task to the patterns of a pattern collection. "
+            "Only the patterns are used; their PDBs are never computed.");
+
+        add_option<shared_ptr<pdbs::PatternCollectionGenerator>>(
+            "patterns",
+            "pattern generation method",
+            "systematic(2)");
+        add_option<int>(
+            "max_states",
+            "maximum number of abstract states of a projection. Patterns "
+            "with larger projections are skipped.",
+            "1M",
+            plugins::Bounds("1", "infinity"));
+        add_option<int>(
+            "max_transitions",
+            "maximum number of transitions of a projection (including "
+            "self-loops of operators that affect the pattern). Patterns "
+            "with more transitions are skipped.",
+            "10M",
+            plugins::Bounds("0", "infinity"));
+        add_abstraction_generator_options_to_feature(*this);
+    }
+};
+
+static plugins::FeaturePlugin<ProjectionGeneratorFeature> _plugin;
+}
@@ -0,0 +1,23 @@
+#ifndef COST_SATURATION_PROJECTIONS_H
+#define COST_SATURATION_PROJECTIONS_H
+
+#include "abstraction_generator.h"
+
+namespace pdbs {
+class PatternCollectionGenerator;
+}
+
+namespace cost_saturation {
+class ProjectionGenerator : public AbstractionGenerator {
+    const std::shared_ptr<pdbs::PatternCollectionGenerator> pattern_generator;
+    const int max_states;
+    const int max_transitions;
+public:
+    explicit ProjectionGenerator(const plugins::Options &opts);
+
+    virtual Abstractions generate_abstractions(
+        const std::shared_ptr<AbstractTask> &task) override;
+};
+}
+
+#endif
@@ -0,0 +1,349 @@
+#include "saturated_cost_partitioning_heuristic.h"
+
+#include "abstraction_generator.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/sampling.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+#include "../utils/markup.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+using namespace std;
+
+namespace cost_saturation {
+/*
+  Compute the saturated cost partitioning for the given order and store
+  the goal distances of all abstractions in one lookup table.
+*/
+static vector<int> compute_saturated_cost_partitioning(
+    const Abstractions &abstractions, const vector<int> &order,
+    const vector<int> &operator_costs, const vector<int> &table_offsets) {
+    int num_operators = operator_costs.size();
+    vector<int> remaining_costs = operator_costs;
+    vector<int> h_values(table_offsets.back());
+    for (int abstraction_id : order) {
+        const Abstraction &abstraction = *abstractions[abstraction_id];
+        vector<int> goal_distances =
+            abstraction.compute_goal_distances(remaining_costs);
+        vector<int> saturated_costs = abstraction.compute_saturated_costs(
+            goal_distances, num_operators);
+        copy(goal_distances.begin(), goal_distances.end(),
+             h_values.begin() + table_offsets[abstraction_id]);
+        for (int op_id = 0; op_id < num_operators; ++op_id) {
+            assert(saturated_costs[op_id] <= remaining_costs[op_id]);
+            remaining_costs[op_id] -= saturated_costs[op_id];
+        }
+    }
+    return h_values;
+}
+
+/*
+  Order the abstractions by the ratio of the heuristic value of the
+  initial state and the costs they need to preserve it, both for the
+  original costs. Abstractions that achieve high estimates while leaving
+  much of the costs to the others come first.
+*/
+static vector<int> compute_greedy_order(
+    const Abstractions &abstractions, const vector<int> &operator_costs,
+    const vector<int> &initial_abstract_state_ids) {
+    int num_abstractions = abstractions.size();
+    int num_operators = operator_costs.size();
+    vector<double> scores;
+    scores.reserve(num_abstractions);
+    for (int i = 0; i < num_abstractions; ++i) {
+        vector<int> goal_distances =
+            abstractions[i]->compute_goal_distances(operator_costs);
+        vector<int> saturated_costs = abstractions[i]->compute_saturated_costs(
+            goal_distances, num_operators);
+        int init_id = initial_abstract_state_ids[i];
+        int init_h = (init_id == -1) ? INF : goal_distances[init_id];
+        double used_costs = accumulate(
+            saturated_costs.begin(), saturated_costs.end(), 0.0);
+        scores.push_back(init_h / (used_costs + 1.0));
+    }
+    vector<int> order(num_abstractions);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int i, int j) {
+                    return scores[i] > scores[j];
+                });
+    return order;
+}
+
+SaturatedCostPartitioningHeuristic::SaturatedCostPartitioningHeuristic(
+    const plugins::Options &opts)
+    : Heuristic(opts) {
+    if (log.is_at_least_normal()) {
+        log << "Initializing saturated cost partitioning heuristic..." << endl;
+    }
+    Abstractions abstractions;
+    for (const shared_ptr<AbstractionGenerator> &generator :
+         opts.get_list<shared_ptr<AbstractionGenerator>>("abstractions")) {
+        Abstractions new_abstractions = generator->generate_abstractions(task);
+        move(new_abstractions.begin(), new_abstractions.end(),
+             back_inserter(abstractions));
+    }
+    utils::CountdownTimer timer(opts.get<double>("max_time"));
+
+    int num_abstractions = abstractions.size();
+    table_offsets.reserve(num_abstractions + 1);
+    table_offsets.push_back(0);
+    for (const unique_ptr<Abstraction> &abstraction : abstractions) {
+        abstraction_functions.push_back(
+            abstraction->extract_abstraction_function());
+        table_offsets.push_back(
+            table_offsets.back() + abstraction->get_num_states());
+    }
+    table_indices.resize(num_abstractions);
+
+    State initial_state = task_proxy.get_initial_state();
+    vector<int> initial_abstract_state_ids;
+    initial_abstract_state_ids.reserve(num_abstractions);
+    for (const unique_ptr<AbstractionFunction> &function : abstraction_functions) {
+        initial_abstract_state_ids.push_back(
+            function->get_abstract_state_id(initial_state));
+    }
+
+    vector<int> operator_costs = task_properties::get_operator_costs(task_proxy);
+    vector<int> order = compute_greedy_order(
+        abstractions, operator_costs, initial_abstract_state_ids);
+    h_values_by_order.push_back(compute_saturated_cost_partitioning(
+                                    abstractions, order, operator_costs, table_offsets));
+
+    int max_orders = opts.get<int>("max_orders");
+    bool diversify = opts.get<bool>("diversify");
+    int init_h = compute_value(initial_state, INF);
+    shared_ptr<utils::RandomNumberGenerator> rng =
+        utils::parse_rng_from_options(opts);
+    /*
+      For diversification, we store the positions of the abstract states
+      of all samples in the lookup tables one sample after the other,
+      together with the maximum heuristic value of each sample over all
+      orders kept so far.
+    */
+    vector<int> sample_table_indices;
+    vector<int> sample_h_values;
+    if (diversify && init_h != DEAD_END && max_orders > 1) {
+        sampling::RandomWalkSampler sampler(task_proxy, *rng);
+        int num_samples = opts.get<int>("samples");
+        sample_table_indices.reserve(num_samples * num_abstractions);
+        for (int i = 0; i < num_samples && !timer.is_expired(); ++i) {
+            State sample = sampler.sample_state(
+                init_h, [this](const State &state) {
+                    return compute_value(state, INF) == DEAD_END;
+                });
+            if (compute_table_indices(sample)) {
+                sample_table_indices.insert(
+                    sample_table_indices.end(),
+                    table_indices.begin(), table_indices.end());
+                sample_h_values.push_back(compute_value(sample, INF));
+            }
+        }
+    }
+    int num_samples = sample_h_values.size();
+
+    int num_orders = 1;
+    while (num_orders < max_orders && !timer.is_expired() &&
+           !(diversify && num_samples == 0)) {
+        rng->shuffle(order);
+        vector<int> h_values = compute_saturated_cost_partitioning(
+            abstractions, order, operator_costs, table_offsets);
+        ++num_orders;
+        bool is_useful = !diversify;
+        for (int i = 0; i < num_samples; ++i) {
+            int h = 0;
+            for (int j = 0; j < num_abstractions; ++j) {
+                h += h_values[sample_table_indices[i * num_abstractions + j]];
+            }
+            if (h > sample_h_values[i]) {
+                sample_h_values[i] = h;
+                is_useful = true;
+            }
+        }
+        if (is_useful) {
+            h_values_by_order.push_back(move(h_values));
+        }
+    }
+    remove_useless_abstractions();
+
+    if (log.is_at_least_normal()) {
+        log << "Abstractions: " << num_abstractions << endl;
+        log << "Abstractions kept: " << abstraction_functions.size() << endl;
+        log << "Samples for diversification: " << num_samples << endl;
+        log << "Orders: " << num_orders << endl;
+        log << "Orders kept: " << h_values_by_order.size() << endl;
+        log << "Stored heuristic values: "
+            << h_values_by_order.size() * table_offsets.back() << endl;
+        log << "Time for computing orders: " << timer.get_elapsed_time() << endl;
+        log << "Done initializing saturated cost partitioning heuristic."
+            << endl << endl;
+    }
+}
+
+bool SaturatedCostPartitioningHeuristic::compute_table_indices(
+    const State &state) {
+    int num_abstractions = abstraction_functions.size();
+    for (int i = 0; i < num_abstractions; ++i) {
+        int abstract_state_id =
+            abstraction_functions[i]->get_abstract_state_id(state);
+        if (abstract_state_id == -1) {
+            return false;
+        }
+        table_indices[i] = table_offsets[i] + abstract_state_id;
+    }
+    return true;
+}
+
+void SaturatedCostPartitioningHeuristic::remove_useless_abstractions() {
+    /*
+      An abstraction whose heuristic values are 0 for all states in all
+      orders never contributes to the heuristic, so we do not need to
+      map states to its abstract states. Abstractions with infinite
+      values detect dead ends and are kept.
+    */
+    int num_abstractions = abstraction_functions.size();
+    vector<unique_ptr<AbstractionFunction>> useful_functions;
+    vector<int> useful_offsets = {0};
+    vector<vector<int>> useful_h_values_by_order(h_values_by_order.size());
+    for (int i = 0; i < num_abstractions; ++i) {
+        bool is_useful = false;
+        for (const vector<int> &h_values : h_values_by_order) {
+            if (any_of(h_values.begin() + table_offsets[i],
+                       h_values.begin() + table_offsets[i + 1],
+                       [](int h) {return h != 0;})) {
+                is_useful = true;
+                break;
+            }
+        }
+        if (!is_useful) {
+            continue;
+        }
+        useful_functions.push_back(move(abstraction_functions[i]));
+        useful_offsets.push_back(
+            useful_offsets.back() + table_offsets[i + 1] - table_offsets[i]);
+        for (size_t order = 0; order < h_values_by_order.size(); ++order) {
+            const vector<int> &h_values = h_values_by_order[order];
+            useful_h_values_by_order[order].insert(
+                useful_h_values_by_order[order].end(),
+                h_values.begin() + table_offsets[i],
+                h_values.begin() + table_offsets[i + 1]);
+        }
+    }
+    abstraction_functions.swap(useful_functions);
+    table_offsets.swap(useful_offsets);
+    h_values_by_order.swap(useful_h_values_by_order);
+    table_indices.resize(abstraction_functions.size());
+}
+
+int SaturatedCostPartitioningHeuristic::compute_value(
+    const State &state, int cutoff) {
+    if (!compute_table_indices(state)) {
+        return DEAD_END;
+    }
+    int max_h = 0;
+    for (const vector<int> &h_values : h_values_by_order) {
+        int h = 0;
+        for (int index : table_indices) {
+            int value = h_values[index];
+            if (value == INF) {
+                // Dead ends are detected independently of the costs.
+                return DEAD_END;
+            }
+            h += value;
+        }
+        max_h = max(max_h, h);
+        if (max_h >= cutoff) {
+            break;
+        }
+    }
+    return max_h;
+}
+
+int SaturatedCostPartitioningHeuristic::compute_heuristic(
+    const State &ancestor_state) {
+    return compute_value(convert_ancestor_state(ancestor_state), INF);
+}
+
+int SaturatedCostPartitioningHeuristic::compute_heuristic_with_cutoff(
+    const State &ancestor_state, int cutoff) {
+    return compute_value(convert_ancestor_state(ancestor_state), cutoff);
+}
+
+class SaturatedCostPartitioningHeuristicFeature
+    : public plugins::TypedFeature<Evaluator, SaturatedCostPartitioningHeuristic> {
+public:
+    SaturatedCostPartitioningHeuristicFeature() : TypedFeature("scp") {
+        document_title("Saturated cost partitioning");
+        document_synopsis(
+            "Maximum over saturated cost partitionings of explicit "
+            "abstractions (projections, Cartesian abstractions and "
+            "merge-and-shrink abstractions) for several orders. See" +
+            utils::format_journal_reference(
+                {"Jendrik Seipp", "Thomas Keller", "Malte Helmert"},
+                "Saturated Cost Partitioning for Optimal Classical Planning",
+                "https://ai.dmi.unibas.ch/papers/seipp-et-al-jair2020.pdf",
+                "Journal of Artificial Intelligence Research",
+                "67",
+                "129-167",
+                "2020"));
+
+        add_list_option<shared_ptr<AbstractionGenerator>>(
+            "abstractions",
+            "abstraction generators",
+            "[projections(systematic(2)),cartesian()]");
+        add_option<int>(
+            "max_orders",
+            "maximum number of orders for which cost partitionings are "
+            "computed. The first order is computed greedily, all others "
+            "are random.",
+            "50",
+            plugins::Bounds("1", "infinity"));
+        add_option<bool>(
+            "diversify",
+            "only keep the cost partitioning of an order if it yields a "
+            "higher heuristic value than all previously kept ones for at "
+            "least one sample state",
+            "true");
+        add_option<int>(
+            "samples",
+            "number of states sampled with random walks for diversification",
+            "1000",
+            plugins::Bounds("1", "infinity"));
+        add_option<double>(
+            "max_time",
+            "maximum time in seconds for sampling states and computing cost "
+            "partitionings for random orders (the abstractions and the "
+            "greedy order are always computed)",
+            "infinity",
+            plugins::Bounds("0.0", "infinity"));
+        utils::add_rng_options(*this);
+        Heuristic::add_options_to_feature(*this);
+
+        document_note(
+            "Evaluation",
+            "The heuristic values of all abstract states are precomputed in "
+            "one lookup table per kept order. Evaluating a state maps it to "
+            "its abstract states once and then reads one table entry per "
+            "abstraction and order.");
+
+        document_language_support("action costs", "supported");
+        document_language_support(
+            "conditional effects",
+            "supported by merge-and-shrink abstractions only");
+        document_language_support("axioms", "not supported");
+
+        document_property("admissible", "yes");
+        document_property("consistent", "yes");
+        document_property("safe", "yes");
+        document_property("preferred operators", "no");
+    }
+};
+
+static plugins::FeaturePlugin<SaturatedCostPartitioningHeuristicFeature> _plugin;
+}
@@ -0,0 +1,44 @@
+#ifndef COST_SATURATION_SATURATED_COST_PARTITIONING_HEURISTIC_H
+#define COST_SATURATION_SATURATED_COST_PARTITIONING_HEURISTIC_H
+
+#include "abstraction.h"
+
+#include "../heuristic.h"
+
+#include <memory>
+#include <vector>
+
+namespace cost_saturation {
+/*
+  Maximum over saturated cost partitionings for several orders of the
+  abstractions.
+
+  The heuristic values of all abstract states under the cost
+  partitioning for one order are stored in one flat lookup table, in
+  which the values of abstraction i start at table_offsets[i]. Evaluating
+  a state maps it to its abstract states once and then sums up one table
+  entry per abstraction for each order.
+*/
+class SaturatedCostPartitioningHeuristic : public Heuristic {
+    std::vector<std::unique_ptr<AbstractionFunction>> abstraction_functions;
+    std::vector<int> table_offsets;
+    std::vector<std::vector<int>> h_values_by_order;
+    // Positions of the abstract states of the evaluated state in the tables.
+    std::vector<int> table_indices;
+
+    bool compute_table_indices(const State &state);
+    void remove_useless_abstractions();
+    // Compute the heuristic value of a state of the heuristic's task.
+    int compute_value(const State &state, int cutoff);
+
+protected:
+    virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual int compute_heuristic_with_cutoff(
+        const State &ancestor_state, int cutoff) override;
+
+public:
+    explicit SaturatedCostPartitioningHeuristic(const plugins::Options &opts);
+};
+}
+
+#endif
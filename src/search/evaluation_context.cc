@@ -11,13 +11,15 @@ using namespace std;
 EvaluationContext::EvaluationContext(
     const EvaluatorCache &cache, const State &state, int g_value,
     bool is_preferred, SearchStatistics *statistics,
-    bool calculate_preferred)
+    bool calculate_preferred, int cutoff)
     : cache(cache),
       state(state),
       g_value(g_value),
       preferred(is_preferred),
       statistics(statistics),
-      calculate_preferred(calculate_preferred) {
+      calculate_preferred(calculate_preferred),
+      cutoff(cutoff) {
+    assert(cutoff >= 0);
 }
 
 
@@ -25,21 +27,23 @@ EvaluationContext::EvaluationContext(
     const EvaluationContext &other, int g_value,
     bool is_preferred, SearchStatistics *statistics, bool calculate_preferred)
     : EvaluationContext(other.cache, other.state, g_value, is_preferred,
-                        statistics, calculate_preferred) {
+                        statistics, calculate_preferred,
+                        EvaluationResult::INFTY) {
 }
 
 EvaluationContext::EvaluationContext(
     const State &state, int g_value, bool is_preferred,
-    SearchStatistics *statistics, bool calculate_preferred)
+    SearchStatistics *statistics, bool calculate_preferred, int cutoff)
     : EvaluationContext(EvaluatorCache(), state, g_value, is_preferred,
-                        statistics, calculate_preferred) {
+                        statistics, calculate_preferred, cutoff) {
 }
 
 EvaluationContext::EvaluationContext(
     const State &state,
     SearchStatistics *statistics, bool calculate_preferred)
     : EvaluationContext(EvaluatorCache(), state, INVALID, false,
-                        statistics, calculate_preferred) {
+                        statistics, calculate_preferred,
+                        EvaluationResult::INFTY) {
 }
 
 const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
@@ -96,3 +100,7 @@ EvaluationContext::get_preferred_operators(Evaluator *eval) {
 bool EvaluationContext::get_calculate_preferred() const {
     return calculate_preferred;
 }
+
+int EvaluationContext::get_cutoff() const {
+    return cutoff;
+}
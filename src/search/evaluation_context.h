@@ -47,13 +47,14 @@ class EvaluationContext {
     bool preferred;
     SearchStatistics *statistics;
     bool calculate_preferred;
+    int cutoff;
 
     static const int INVALID = -1;
 
     EvaluationContext(
         const EvaluatorCache &cache, const State &state, int g_value,
         bool is_preferred, SearchStatistics *statistics,
-        bool calculate_preferred);
+        bool calculate_preferred, int cutoff);
 public:
     /*
       Copy existing heuristic cache and use it to look up heuristic values.
@@ -68,10 +69,17 @@ public:
     /*
       Create new heuristic cache for caching heuristic values. Used for example
       by eager search.
+
+      If the search is only interested in heuristic values below some
+      cutoff (e.g., because all states with g + h >= bound are useless),
+      it can pass this cutoff. Heuristics may then stop their computation
+      early and report any admissible value that is at least the cutoff
+      (see Heuristic::compute_heuristic_with_cutoff).
     */
     EvaluationContext(
         const State &state, int g_value, bool is_preferred,
-        SearchStatistics *statistics, bool calculate_preferred = false);
+        SearchStatistics *statistics, bool calculate_preferred = false,
+        int cutoff = EvaluationResult::INFTY);
     /*
       Use the following constructor when you don't care about g values,
       preferredness (and statistics), e.g. when sampling states for heuristics.
@@ -110,6 +118,7 @@ public:
     int get_evaluator_value_or_infinity(Evaluator *eval);
     const std::vector<OperatorID> &get_preferred_operators(Evaluator *eval);
     bool get_calculate_preferred() const;
+    int get_cutoff() const;
 };
 
 #endif
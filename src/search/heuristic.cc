@@ -2,6 +2,7 @@
 
 #include "evaluation_context.h"
 #include "evaluation_result.h"
+#include "persistent_heuristic_cache.h"
 
 #include "plugins/plugin.h"
 #include "task_utils/task_properties.h"
@@ -11,6 +12,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <limits>
+#include <set>
 
 using namespace std;
 
@@ -18,17 +20,92 @@ Heuristic::Heuristic(const plugins::Options &opts)
     : Evaluator(opts, true, true, true),
       heuristic_cache(HEntry(NO_VALUE, true)), //TODO: is true really a good idea here?
       cache_evaluator_values(opts.get<bool>("cache_estimates")),
+      cache_estimates_persistently(
+          opts.get<bool>("cache_estimates_persistently")),
+      persistent_cache_initialized(false),
+      persistent_cache(nullptr),
+      persistent_cache_key(0),
+      persistent_cache_hits(0),
+      persistent_cache_misses(0),
       task(opts.get<shared_ptr<AbstractTask>>("transform")),
       task_proxy(*task) {
 }
 
 Heuristic::~Heuristic() {
+    if (persistent_cache && log.is_at_least_normal()) {
+        log << "Persistent cache hits for " << get_description() << ": "
+            << persistent_cache_hits << " of "
+            << persistent_cache_hits + persistent_cache_misses
+            << " lookups" << endl;
+    }
 }
 
 void Heuristic::set_preferred(const OperatorProxy &op) {
     preferred_operators.insert(op.get_ancestor_operator_id(tasks::g_root_task.get()));
 }
 
+int Heuristic::compute_heuristic_with_cutoff(
+    const State &ancestor_state, int /*cutoff*/) {
+    return compute_heuristic(ancestor_state);
+}
+
+void Heuristic::initialize_persistent_cache(const State &state) {
+    assert(!persistent_cache_initialized);
+    persistent_cache_initialized = true;
+    if (!cache_estimates_persistently) {
+        return;
+    }
+    if (get_description().empty()) {
+        /*
+          The description identifies the estimates in the cache, so
+          heuristics without one (e.g., created from hand-built options)
+          would share their entries.
+        */
+        if (log.is_warning()) {
+            log << "Warning: a heuristic without configuration string "
+                << "cannot cache its values persistently." << endl;
+        }
+        return;
+    }
+    set<Evaluator *> path_dependent_evaluators;
+    get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        if (log.is_warning()) {
+            log << "Warning: the values of " << get_description()
+                << " depend on the path to a state, so they are not "
+                << "cached persistently." << endl;
+        }
+        return;
+    }
+    persistent_cache = persistent_heuristic_cache::get_cache(state, log);
+    if (!persistent_cache && log.is_warning()) {
+        log << "Warning: " << get_description()
+            << " should cache its values persistently, but no usable cache "
+            << "file was given (see --heuristic-cache)." << endl;
+    }
+    persistent_cache_key = persistent_heuristic_cache::compute_key(
+        get_description());
+}
+
+bool Heuristic::lookup_persistent_cache(const State &state, int &value) {
+    if (persistent_cache->lookup(
+            persistent_cache_key, state.get_buffer(), value)) {
+        ++persistent_cache_hits;
+        return true;
+    }
+    ++persistent_cache_misses;
+    return false;
+}
+
+void Heuristic::store_in_cache(const State &state, int value, bool cut_off) {
+    if (HEntry::can_store(value, cut_off)) {
+        heuristic_cache[state] = HEntry(value, false, cut_off);
+    } else {
+        // Values that do not fit into the cache entry are recomputed.
+        heuristic_cache[state] = HEntry(NO_VALUE, true);
+    }
+}
+
 State Heuristic::convert_ancestor_state(const State &ancestor_state) const {
     return task_proxy.convert_ancestor_state(ancestor_state);
 }
@@ -41,6 +118,19 @@ void Heuristic::add_options_to_feature(plugins::Feature &feature) {
         " Currently, adapt_costs() and no_transform() are available.",
         "no_transform()");
     feature.add_option<bool>("cache_estimates", "cache heuristic estimates", "true");
+    feature.add_option<bool>(
+        "cache_estimates_persistently",
+        "additionally store heuristic estimates in the file given with the "
+        "command line option --heuristic-cache, so that they can be reused "
+        "by later searches and planner runs on the same task (e.g., by "
+        "later phases of iterated searches or later configurations of "
+        "portfolios). Estimates are associated with the configuration "
+        "string of the heuristic, so this should only be used for "
+        "heuristics whose estimates only depend on the state and this "
+        "string.",
+        "false");
+    feature.mark_result_independent("cache_estimates");
+    feature.mark_result_independent("cache_estimates_persistently");
 }
 
 EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
@@ -52,15 +142,47 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     bool calculate_preferred = eval_context.get_calculate_preferred();
 
     int heuristic = NO_VALUE;
+    int cutoff = eval_context.get_cutoff();
+
+    if (!persistent_cache_initialized) {
+        initialize_persistent_cache(state);
+    }
+    bool use_persistent_cache = persistent_cache && !calculate_preferred &&
+        state.get_registry();
 
+    /*
+      Values that may have been cut off (see below) can be reused if the
+      current cutoff is not larger than the cached value.
+    */
     if (!calculate_preferred && cache_evaluator_values &&
-        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
-        heuristic = heuristic_cache[state].h;
+        heuristic_cache[state].h != NO_VALUE &&
+        !heuristic_cache[state].dirty &&
+        (!heuristic_cache[state].is_cut_off() ||
+         heuristic_cache[state].get_value() >= cutoff)) {
+        heuristic = heuristic_cache[state].get_value();
+        result.set_count_evaluation(false);
+    } else if (use_persistent_cache &&
+               lookup_persistent_cache(state, heuristic)) {
+        if (cache_evaluator_values) {
+            store_in_cache(state, heuristic, false);
+        }
         result.set_count_evaluation(false);
     } else {
-        heuristic = compute_heuristic(state);
+        heuristic = compute_heuristic_with_cutoff(state, cutoff);
+        /*
+          Values at or above the cutoff may be lower than the actual
+          heuristic value, so we mark them as cut off to recompute them
+          if needed with a larger cutoff and do not store them
+          persistently.
+        */
+        bool may_be_cut_off = cutoff != EvaluationResult::INFTY &&
+            heuristic != DEAD_END && heuristic >= cutoff;
         if (cache_evaluator_values) {
-            heuristic_cache[state] = HEntry(heuristic, false);
+            store_in_cache(state, heuristic, may_be_cut_off);
+        }
+        if (use_persistent_cache && !may_be_cut_off) {
+            persistent_cache->store(
+                persistent_cache_key, state.get_buffer(), heuristic, log);
         }
         result.set_count_evaluation(true);
     }
@@ -105,5 +227,5 @@ bool Heuristic::is_estimate_cached(const State &state) const {
 
 int Heuristic::get_cached_estimate(const State &state) const {
     assert(is_estimate_cached(state));
-    return heuristic_cache[state].h;
+    return heuristic_cache[state].get_value();
 }
@@ -8,11 +8,17 @@
 
 #include "algorithms/ordered_set.h"
 
+#include <cassert>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 class TaskProxy;
 
+namespace persistent_heuristic_cache {
+class PersistentHeuristicCache;
+}
+
 namespace plugins {
 class Feature;
 class Options;
@@ -21,12 +27,42 @@ class Options;
 class Heuristic : public Evaluator {
     struct HEntry {
         /* dirty is conceptually a bool, but Visual C++ does not support
-           packing ints and bools together in a bitfield. */
+           packing ints and bools together in a bitfield.
+
+           dirty marks values that must be recomputed. Values that were
+           computed with a cutoff no larger than the value are only lower
+           bounds and may only be reused for cutoffs not larger than the
+           value. We store such values below NO_VALUE (see encode()) to
+           keep the full range of h for all other values. */
         int h : 31;
         unsigned int dirty : 1;
 
-        HEntry(int h, bool dirty)
-            : h(h), dirty(dirty) {
+        static const int MIN_STORED_VALUE = -(1 << 30);
+        static const int MAX_STORED_VALUE = (1 << 30) - 1;
+
+        static int encode(int value, bool cut_off) {
+            return cut_off ? NO_VALUE - 1 - value : value;
+        }
+
+        static bool can_store(int value, bool cut_off) {
+            if (cut_off) {
+                return value >= 0 &&
+                       value <= NO_VALUE - 1 - MIN_STORED_VALUE;
+            }
+            return value <= MAX_STORED_VALUE;
+        }
+
+        HEntry(int value, bool dirty, bool cut_off = false)
+            : h(encode(value, cut_off)), dirty(dirty) {
+            assert(can_store(value, cut_off));
+        }
+
+        bool is_cut_off() const {
+            return h < NO_VALUE;
+        }
+
+        int get_value() const {
+            return is_cut_off() ? NO_VALUE - 1 - h : h;
         }
     };
     static_assert(sizeof(HEntry) == 4, "HEntry has unexpected size.");
@@ -54,6 +90,18 @@ protected:
     PerStateInformation<HEntry> heuristic_cache;
     bool cache_evaluator_values;
 
+    /*
+      Values of registered states can additionally be stored in the
+      persistent heuristic cache (if a cache file is given), which is
+      opened when the first state is evaluated.
+    */
+    bool cache_estimates_persistently;
+    bool persistent_cache_initialized;
+    persistent_heuristic_cache::PersistentHeuristicCache *persistent_cache;
+    std::uint64_t persistent_cache_key;
+    std::int64_t persistent_cache_hits;
+    std::int64_t persistent_cache_misses;
+
     // Hold a reference to the task implementation and pass it to objects that need it.
     const std::shared_ptr<AbstractTask> task;
     // Use task_proxy to access task information.
@@ -63,6 +111,16 @@ protected:
 
     virtual int compute_heuristic(const State &ancestor_state) = 0;
 
+    /*
+      Like compute_heuristic, but the caller is only interested in the
+      exact heuristic value if it is below cutoff. If it is not, heuristics
+      may stop their computation early and return any value h' with
+      cutoff <= h' <= h, so admissible heuristics remain admissible.
+      The default implementation ignores the cutoff.
+    */
+    virtual int compute_heuristic_with_cutoff(
+        const State &ancestor_state, int cutoff);
+
     /*
       Usage note: Marking the same operator as preferred multiple times
       is OK -- it will only appear once in the list of preferred
@@ -72,6 +130,11 @@ protected:
 
     State convert_ancestor_state(const State &ancestor_state) const;
 
+private:
+    void store_in_cache(const State &state, int value, bool cut_off);
+    void initialize_persistent_cache(const State &state);
+    bool lookup_persistent_cache(const State &state, int &value);
+
 public:
     explicit Heuristic(const plugins::Options &opts);
     virtual ~Heuristic() override;
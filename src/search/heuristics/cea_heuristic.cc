@@ -7,6 +7,7 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <vector>
@@ -80,7 +81,8 @@ struct LocalProblemNode {
     // Dynamic attributes (modified during heuristic computation).
     int cost;
     bool expanded;
-    vector<short> context;
+    // Points into the context buffer of the owner.
+    short *context;
 
     LocalTransition *reached_by;
     /* Before a node is expanded, reached_by is the "current best"
@@ -93,11 +95,11 @@ struct LocalProblemNode {
 
     vector<LocalTransition *> waiting_list;
 
-    LocalProblemNode(LocalProblem *owner_, int context_size)
+    LocalProblemNode(LocalProblem *owner_, short *context_)
         : owner(owner_),
           cost(-1),
           expanded(false),
-          context(context_size, -1),
+          context(context_),
           reached_by(0) {
     }
 
@@ -107,11 +109,31 @@ struct LocalProblemNode {
 
 struct LocalProblem {
     int base_priority;
+    /*
+      The local problem is set up for the current heuristic computation
+      iff epoch matches the current epoch of the heuristic. This way, we
+      do not need to reset all local problems for every evaluation.
+    */
+    int epoch;
     vector<LocalProblemNode> nodes;
     vector<int> *context_variables;
+    // The contexts of all nodes, stored contiguously to avoid one
+    // allocation per node.
+    vector<short> contexts;
 public:
     LocalProblem()
-        : base_priority(-1) {
+        : base_priority(-1),
+          epoch(-1) {
+    }
+
+    void create_nodes(int num_values) {
+        int context_size = context_variables->size();
+        contexts.assign(num_values * context_size, -1);
+        nodes.reserve(num_values);
+        for (int value = 0; value < num_values; ++value) {
+            nodes.push_back(LocalProblemNode(
+                                this, contexts.data() + value * context_size));
+        }
     }
 
     ~LocalProblem() {
@@ -136,11 +158,8 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
 
     problem->context_variables = &dtg->local_to_global_child;
 
-    int num_parents = problem->context_variables->size();
     size_t num_values = task_proxy.get_variables()[var_no].get_domain_size();
-    problem->nodes.reserve(num_values);
-    for (size_t value = 0; value < num_values; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, num_parents));
+    problem->create_nodes(num_values);
 
     // Compile the DTG arcs into LocalTransition objects.
     for (size_t value = 0; value < num_values; ++value) {
@@ -171,8 +190,7 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
     for (FactProxy goal : goals_proxy)
         problem->context_variables->push_back(goal.get_variable().get_id());
 
-    for (size_t value = 0; value < 2; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, goals_proxy.size()));
+    problem->create_nodes(2);
 
     vector<LocalAssignment> goals;
     for (size_t goal_no = 0; goal_no < goals_proxy.size(); ++goal_no) {
@@ -209,14 +227,15 @@ inline void ContextEnhancedAdditiveHeuristic::add_to_heap(
 
 bool ContextEnhancedAdditiveHeuristic::is_local_problem_set_up(
     const LocalProblem *problem) const {
-    return problem->base_priority != -1;
+    return problem->epoch == current_epoch;
 }
 
 void ContextEnhancedAdditiveHeuristic::set_up_local_problem(
     LocalProblem *problem, int base_priority,
     int start_value, const State &state) {
-    assert(problem->base_priority == -1);
+    assert(!is_local_problem_set_up(problem));
     problem->base_priority = base_priority;
+    problem->epoch = current_epoch;
 
     for (auto &to_node : problem->nodes) {
         to_node.expanded = false;
@@ -251,8 +270,10 @@ void ContextEnhancedAdditiveHeuristic::expand_node(LocalProblemNode *node) {
     LocalTransition *reached_by = node->reached_by;
     if (reached_by) {
         LocalProblemNode *parent = reached_by->source;
-        vector<short> &context = node->context;
-        context = parent->context;
+        short *context = node->context;
+        copy(parent->context,
+             parent->context + node->owner->context_variables->size(),
+             context);
         const vector<LocalAssignment> &precond = reached_by->label->precond;
         for (size_t i = 0; i < precond.size(); ++i)
             context[precond[i].local_var] = precond[i].value;
@@ -298,7 +319,7 @@ void ContextEnhancedAdditiveHeuristic::expand_transition(
         curr_precond = precond.begin(),
         last_precond = precond.end();
 
-    vector<short>::const_iterator context = trans->source->context.begin();
+    const short *context = trans->source->context;
     vector<int>::const_iterator parent_vars =
         trans->source->owner->context_variables->begin();
 
@@ -394,9 +415,7 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
     const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     initialize_heap();
-    goal_problem->base_priority = -1;
-    for (LocalProblem *problem : local_problems)
-        problem->base_priority = -1;
+    ++current_epoch;
 
     set_up_local_problem(goal_problem, 0, 0, state);
 
@@ -411,7 +430,8 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
 ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
     const plugins::Options &opts)
     : Heuristic(opts),
-      min_action_cost(task_properties::get_min_operator_cost(task_proxy)) {
+      min_action_cost(task_properties::get_min_operator_cost(task_proxy)),
+      current_epoch(0) {
     if (log.is_at_least_normal()) {
         log << "Initializing context-enhanced additive heuristic..." << endl;
     }
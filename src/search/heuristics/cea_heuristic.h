@@ -23,6 +23,8 @@ class ContextEnhancedAdditiveHeuristic : public Heuristic {
     LocalProblem *goal_problem;
     LocalProblemNode *goal_node;
     int min_action_cost;
+    // Incremented for every evaluation; see LocalProblem::epoch.
+    int current_epoch;
 
     priority_queues::AdaptiveQueue<LocalProblemNode *> node_queue;
 
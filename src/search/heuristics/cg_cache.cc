@@ -4,6 +4,7 @@
 
 #include "../task_utils/causal_graph.h"
 #include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
 
@@ -13,12 +14,26 @@
 #include <vector>
 
 using namespace std;
+using domain_transition_graph::ValueTransitionLabel;
 
 namespace cg_heuristic {
 const int CGCache::NOT_COMPUTED;
+const uint64_t CGCache::EMPTY_KEY;
+const int CGCache::NUM_WAYS;
+const size_t CGCache::INITIAL_NUM_SETS;
 
-CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log)
-    : task_proxy(task_proxy) {
+CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size,
+                 size_t max_cache_memory, utils::LogProxy &log)
+    : task_proxy(task_proxy),
+      num_sets(0),
+      max_num_sets(0),
+      num_shared_entries(0),
+      dense_memory(0),
+      num_dense_variables(0),
+      num_shared_variables(0),
+      num_uncached_variables(0),
+      num_shared_insertions(0),
+      num_evictions(0) {
     if (log.is_at_least_normal()) {
         log << "Initializing heuristic cache... " << flush;
     }
@@ -56,18 +71,47 @@ CGCache::CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProx
 
     cache.resize(var_count);
     helpful_transition_cache.resize(var_count);
+    uses_shared_table.resize(var_count, false);
 
+    size_t dense_entry_size =
+        sizeof(int) + sizeof(ValueTransitionLabel *);
     for (int var = 0; var < var_count; ++var) {
         int required_cache_size = compute_required_cache_size(
             var, depends_on[var], max_cache_size);
-        if (required_cache_size != -1) {
+        if (required_cache_size != -1 &&
+            dense_memory + required_cache_size * dense_entry_size <= max_cache_memory) {
             cache[var].resize(required_cache_size, NOT_COMPUTED);
             helpful_transition_cache[var].resize(required_cache_size, nullptr);
+            dense_memory += required_cache_size * dense_entry_size;
+            ++num_dense_variables;
+        } else if (has_shared_key(var)) {
+            uses_shared_table[var] = true;
+            ++num_shared_variables;
+        } else {
+            ++num_uncached_variables;
+        }
+    }
+
+    if (num_shared_variables > 0) {
+        max_num_sets = (max_cache_memory - dense_memory) /
+            (NUM_WAYS * sizeof(SharedEntry) + sizeof(uint8_t));
+        if (max_num_sets == 0) {
+            // Not even a single set fits into the remaining budget.
+            uses_shared_table.assign(var_count, false);
+            num_uncached_variables += num_shared_variables;
+            num_shared_variables = 0;
+        } else {
+            // The shared table grows on demand up to max_num_sets sets.
+            resize_shared_table(min(max_num_sets, INITIAL_NUM_SETS));
         }
     }
 
     if (log.is_at_least_normal()) {
         log << "done!" << endl;
+        log << "Directly cached variables: " << num_dense_variables << endl;
+        log << "Variables in shared cache: " << num_shared_variables << endl;
+        log << "Uncached variables: " << num_uncached_variables << endl;
+        log << "Maximum shared cache entries: " << max_num_sets * NUM_WAYS << endl;
     }
 }
 
@@ -78,10 +122,9 @@ int CGCache::compute_required_cache_size(
     int var_id, const vector<int> &depends_on, int max_cache_size) const {
     /*
       Compute the size of the cache required for variable with ID "var_id",
-      which depends on the variables in "depends_on". Requires that the caches
-      for all variables in "depends_on" have already been allocated. Returns -1
-      if the variable cannot be cached because the required cache size would be
-      too large.
+      which depends on the variables in "depends_on". Returns -1 if the
+      variable cannot be cached directly because the required cache size
+      would be too large.
     */
 
     VariablesProxy variables = task_proxy.get_variables();
@@ -95,16 +138,6 @@ int CGCache::compute_required_cache_size(
     for (int depend_var_id : depends_on) {
         int depend_var_domain = variables[depend_var_id].get_domain_size();
 
-        /*
-          If var depends on a variable var_i that is not cached, then
-          it cannot be cached. This is possible even if var would have
-          an acceptable cache size because the domain of var_i
-          contributes quadratically to its own cache size but only
-          linearly to the cache size of var.
-        */
-        if (cache[depend_var_id].empty())
-            return -1;
-
         if (!utils::is_product_within_limit(required_size, depend_var_domain,
                                             max_cache_size))
             return -1;
@@ -117,7 +150,7 @@ int CGCache::compute_required_cache_size(
 
 int CGCache::get_index(int var, const State &state,
                        int from_val, int to_val) const {
-    assert(is_cached(var));
+    assert(!cache[var].empty());
     assert(from_val != to_val);
     int index = from_val;
     int multiplier = task_proxy.get_variables()[var].get_domain_size();
@@ -131,4 +164,154 @@ int CGCache::get_index(int var, const State &state,
     assert(utils::in_bounds(index, cache[var]));
     return index;
 }
+
+bool CGCache::has_shared_key(int var) const {
+    /*
+      The key of a transition of var enumerates the (context, start,
+      target) combinations of all shared variables as mixed-radix numbers
+      like get_index and interleaves the variables. It must stay below
+      EMPTY_KEY.
+    */
+    VariablesProxy variables = task_proxy.get_variables();
+    uint64_t num_vars = variables.size();
+    uint64_t limit = EMPTY_KEY / num_vars;
+    uint64_t var_domain = variables[var].get_domain_size();
+    uint64_t num_combinations = var_domain * (var_domain - 1);
+    for (int dep_var : depends_on[var]) {
+        uint64_t dep_domain = variables[dep_var].get_domain_size();
+        if (num_combinations > limit / dep_domain)
+            return false;
+        num_combinations *= dep_domain;
+    }
+    return num_combinations <= limit;
+}
+
+uint64_t CGCache::get_key(int var, const State &state,
+                          int from_val, int to_val) const {
+    assert(uses_shared_table[var]);
+    assert(from_val != to_val);
+    VariablesProxy variables = task_proxy.get_variables();
+    uint64_t index = from_val;
+    uint64_t multiplier = variables[var].get_domain_size();
+    for (int dep_var : depends_on[var]) {
+        index += state[dep_var].get_value() * multiplier;
+        multiplier *= variables[dep_var].get_domain_size();
+    }
+    if (to_val > from_val)
+        --to_val;
+    index += to_val * multiplier;
+    uint64_t key = index * variables.size() + var;
+    assert(key != EMPTY_KEY);
+    return key;
+}
+
+size_t CGCache::get_set_id(uint64_t key) const {
+    return utils::get_hash64(key) % num_sets;
+}
+
+CGCache::SharedEntry *CGCache::find_shared_entry(uint64_t key) {
+    SharedEntry *set = &shared_entries[get_set_id(key) * NUM_WAYS];
+    for (int way = 0; way < NUM_WAYS; ++way) {
+        if (set[way].key == key)
+            return &set[way];
+    }
+    return nullptr;
+}
+
+bool CGCache::lookup(int var, const State &state, int from_val, int to_val,
+                     int &cost, ValueTransitionLabel *&helpful_transition) {
+    assert(is_cached(var));
+    if (uses_shared_table[var]) {
+        SharedEntry *entry = find_shared_entry(get_key(var, state, from_val, to_val));
+        if (!entry)
+            return false;
+        entry->referenced = true;
+        cost = entry->cost;
+        helpful_transition = entry->helpful_transition;
+        return true;
+    }
+    int index = get_index(var, state, from_val, to_val);
+    if (cache[var][index] == NOT_COMPUTED)
+        return false;
+    cost = cache[var][index];
+    helpful_transition = helpful_transition_cache[var][index];
+    return true;
+}
+
+void CGCache::store(int var, const State &state, int from_val, int to_val,
+                    int cost, ValueTransitionLabel *helpful_transition) {
+    assert(is_cached(var));
+    if (!uses_shared_table[var]) {
+        int index = get_index(var, state, from_val, to_val);
+        cache[var][index] = cost;
+        helpful_transition_cache[var][index] = helpful_transition;
+        return;
+    }
+
+    uint64_t key = get_key(var, state, from_val, to_val);
+    SharedEntry *entry = find_shared_entry(key);
+    if (!entry) {
+        if (num_sets < max_num_sets &&
+            2 * num_shared_entries >= num_sets * NUM_WAYS) {
+            resize_shared_table(min(max_num_sets, 2 * num_sets));
+        }
+        entry = insert_shared_entry(key);
+        ++num_shared_insertions;
+    }
+    entry->cost = cost;
+    entry->helpful_transition = helpful_transition;
+}
+
+CGCache::SharedEntry *CGCache::insert_shared_entry(uint64_t key) {
+    size_t set_id = get_set_id(key);
+    SharedEntry *set = &shared_entries[set_id * NUM_WAYS];
+    SharedEntry *entry = nullptr;
+    for (int way = 0; way < NUM_WAYS; ++way) {
+        if (set[way].key == EMPTY_KEY) {
+            entry = &set[way];
+            ++num_shared_entries;
+            break;
+        }
+    }
+    if (!entry) {
+        // Clock eviction: skip (and unmark) recently referenced entries.
+        uint8_t &hand = clock_hands[set_id];
+        while (set[hand].referenced) {
+            set[hand].referenced = false;
+            hand = (hand + 1) % NUM_WAYS;
+        }
+        entry = &set[hand];
+        hand = (hand + 1) % NUM_WAYS;
+        ++num_evictions;
+    }
+    entry->key = key;
+    entry->referenced = false;
+    return entry;
+}
+
+void CGCache::resize_shared_table(size_t new_num_sets) {
+    vector<SharedEntry> old_entries(
+        new_num_sets * NUM_WAYS, {EMPTY_KEY, nullptr, 0, false});
+    old_entries.swap(shared_entries);
+    clock_hands.assign(new_num_sets, 0);
+    num_sets = new_num_sets;
+    num_shared_entries = 0;
+    for (const SharedEntry &old_entry : old_entries) {
+        if (old_entry.key != EMPTY_KEY) {
+            SharedEntry *entry = insert_shared_entry(old_entry.key);
+            *entry = old_entry;
+        }
+    }
+}
+
+void CGCache::print_statistics(utils::LogProxy &log) const {
+    size_t shared_memory =
+        shared_entries.size() * sizeof(SharedEntry) + clock_hands.size();
+    log << "CG cache memory for direct tables: " << dense_memory / 1024
+        << " KB" << endl;
+    log << "CG cache memory for shared table: " << shared_memory / 1024
+        << " KB" << endl;
+    log << "CG cache shared insertions: " << num_shared_insertions << endl;
+    log << "CG cache shared evictions: " << num_evictions << endl;
+}
 }
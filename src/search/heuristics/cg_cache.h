@@ -3,6 +3,8 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 namespace domain_transition_graph {
@@ -14,46 +16,94 @@ class LogProxy;
 }
 
 namespace cg_heuristic {
+/*
+  Cache for the transition costs and helpful transitions computed by the
+  causal graph heuristic. The cached values for a variable depend on its
+  start and target value and on the values of all variables it
+  (transitively) depends on in the pruned causal graph (its "context").
+
+  Variables with at most max_cache_size different (context, start, target)
+  combinations are cached in directly indexed tables as long as these fit
+  into the memory budget. The remaining budget is used for a table that is
+  shared by all other variables. Its entries store the variable, context,
+  start and target value as an exact 64-bit key, so lookups never confuse
+  different transitions. (Variables with too many combinations for such a
+  key are not cached.) The table is indexed by a hash of the key, is split
+  into small sets of entries and grows on demand. Once it has reached the
+  memory budget, it evicts entries with the clock (second chance) strategy
+  within a set.
+  Since entries of the shared table can be evicted at any time, lookups
+  may fail even for values that have been stored before.
+*/
 class CGCache {
+    struct SharedEntry {
+        std::uint64_t key;
+        domain_transition_graph::ValueTransitionLabel *helpful_transition;
+        int cost;
+        bool referenced;
+    };
+
+    static const std::uint64_t EMPTY_KEY =
+        std::numeric_limits<std::uint64_t>::max();
+    static const int NUM_WAYS = 4;
+    static const std::size_t INITIAL_NUM_SETS = 1024;
+
     TaskProxy task_proxy;
     std::vector<std::vector<int>> cache;
     std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>> helpful_transition_cache;
     std::vector<std::vector<int>> depends_on;
 
+    std::vector<bool> uses_shared_table;
+    std::vector<SharedEntry> shared_entries;
+    std::vector<std::uint8_t> clock_hands;
+    std::size_t num_sets;
+    std::size_t max_num_sets;
+    std::size_t num_shared_entries;
+
+    std::size_t dense_memory;
+    int num_dense_variables;
+    int num_shared_variables;
+    int num_uncached_variables;
+    std::int64_t num_shared_insertions;
+    std::int64_t num_evictions;
+
     int get_index(int var, const State &state, int from_val, int to_val) const;
+    bool has_shared_key(int var) const;
+    std::uint64_t get_key(int var, const State &state, int from_val, int to_val) const;
+    std::size_t get_set_id(std::uint64_t key) const;
+    SharedEntry *find_shared_entry(std::uint64_t key);
+    SharedEntry *insert_shared_entry(std::uint64_t key);
+    void resize_shared_table(std::size_t new_num_sets);
     int compute_required_cache_size(
         int var_id, const std::vector<int> &depends_on, int max_cache_size) const;
 public:
     static const int NOT_COMPUTED = -2;
 
-    CGCache(const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log);
+    /*
+      max_cache_size bounds the number of entries of directly indexed
+      tables, max_cache_memory bounds the total memory (in bytes) used by
+      all tables.
+    */
+    CGCache(const TaskProxy &task_proxy, int max_cache_size,
+            std::size_t max_cache_memory, utils::LogProxy &log);
     ~CGCache();
 
     bool is_cached(int var) const {
-        return !cache[var].empty();
+        return !cache[var].empty() || uses_shared_table[var];
     }
 
-    int lookup(int var, const State &state, int from_val, int to_val) const {
-        return cache[var][get_index(var, state, from_val, to_val)];
-    }
+    /*
+      Return true and set cost and helpful_transition if a value for the
+      given transition is cached. Return false otherwise.
+    */
+    bool lookup(int var, const State &state, int from_val, int to_val,
+                int &cost,
+                domain_transition_graph::ValueTransitionLabel *&helpful_transition);
 
-    void store(int var, const State &state,
-               int from_val, int to_val, int cost) {
-        cache[var][get_index(var, state, from_val, to_val)] = cost;
-    }
+    void store(int var, const State &state, int from_val, int to_val, int cost,
+               domain_transition_graph::ValueTransitionLabel *helpful_transition);
 
-    domain_transition_graph::ValueTransitionLabel *lookup_helpful_transition(
-        int var, const State &state, int from_val, int to_val) const {
-        int index = get_index(var, state, from_val, to_val);
-        return helpful_transition_cache[var][index];
-    }
-
-    void store_helpful_transition(
-        int var, const State &state, int from_val, int to_val,
-        domain_transition_graph::ValueTransitionLabel *helpful_transition) {
-        int index = get_index(var, state, from_val, to_val);
-        helpful_transition_cache[var][index] = helpful_transition;
-    }
+    void print_statistics(utils::LogProxy &log) const;
 };
 }
 
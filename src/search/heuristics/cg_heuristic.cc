@@ -27,8 +27,12 @@ CGHeuristic::CGHeuristic(const plugins::Options &opts)
     }
 
     int max_cache_size = opts.get<int>("max_cache_size");
-    if (max_cache_size > 0)
-        cache = utils::make_unique_ptr<CGCache>(task_proxy, max_cache_size, log);
+    int max_cache_memory = opts.get<int>("max_cache_memory");
+    if (max_cache_size > 0 && max_cache_memory > 0) {
+        cache = utils::make_unique_ptr<CGCache>(
+            task_proxy, max_cache_size,
+            static_cast<size_t>(max_cache_memory) * 1024 * 1024, log);
+    }
 
     unsigned int num_vars = task_proxy.get_variables().size();
     prio_queues.reserve(num_vars);
@@ -42,6 +46,20 @@ CGHeuristic::CGHeuristic(const plugins::Options &opts)
 }
 
 CGHeuristic::~CGHeuristic() {
+    print_statistics();
+}
+
+void CGHeuristic::print_statistics() const {
+    if (cache && log.is_at_least_normal()) {
+        int64_t num_lookups = cache_hits + cache_misses;
+        log << "CG cache hits: " << cache_hits << endl;
+        log << "CG cache misses: " << cache_misses << endl;
+        if (num_lookups > 0) {
+            log << "CG cache hit rate: "
+                << static_cast<double>(cache_hits) / num_lookups << endl;
+        }
+        cache->print_statistics(log);
+    }
 }
 
 bool CGHeuristic::dead_ends_are_reliable() const {
@@ -92,12 +110,13 @@ int CGHeuristic::get_transition_cost(const State &state,
     // Check cache.
     bool use_the_cache = cache && cache->is_cached(var_no);
     if (use_the_cache) {
-        int cached_val = cache->lookup(var_no, state, start_val, goal_val);
-        if (cached_val != CGCache::NOT_COMPUTED) {
+        int cached_val;
+        ValueTransitionLabel *cached_helpful;
+        if (cache->lookup(var_no, state, start_val, goal_val,
+                          cached_val, cached_helpful)) {
             ++cache_hits;
             return cached_val;
         }
-    } else {
         ++cache_misses;
     }
 
@@ -212,9 +231,7 @@ int CGHeuristic::get_transition_cost(const State &state,
             ValueTransitionLabel *helpful = start->helpful_transitions[val];
             // We should have a helpful transition iff distance is infinite.
             assert((distance == numeric_limits<int>::max()) == !helpful);
-            cache->store(var_no, state, start_val, val, distance);
-            cache->store_helpful_transition(
-                var_no, state, start_val, val, helpful);
+            cache->store(var_no, state, start_val, val, distance, helpful);
         }
     }
 
@@ -255,12 +272,18 @@ void CGHeuristic::mark_helpful_transitions(const State &state,
     ValueTransitionLabel *helpful;
     int cost;
     // Check cache.
-    if (cache && cache->is_cached(var_no)) {
-        helpful = cache->lookup_helpful_transition(var_no, state, from, to);
-        cost = cache->lookup(var_no, state, from, to);
+    if (cache && cache->is_cached(var_no) &&
+        cache->lookup(var_no, state, from, to, cost, helpful)) {
         assert(helpful);
     } else {
         ValueNode *start_node = &dtg->nodes[from];
+        if (start_node->helpful_transitions.empty()) {
+            /*
+              The transition cost was read from the cache, but the entry
+              has been evicted since then.
+            */
+            get_transition_cost(state, dtg, from, to);
+        }
         assert(!start_node->helpful_transitions.empty());
         helpful = start_node->helpful_transitions[to];
         cost = start_node->distances[to];
@@ -292,9 +315,18 @@ public:
 
         add_option<int>(
             "max_cache_size",
-            "maximum number of cached entries per variable (set to 0 to disable cache)",
+            "maximum number of cached entries per variable for variables that "
+            "are cached in directly indexed tables; the values of all other "
+            "variables share a hash table with clock eviction "
+            "(set to 0 to disable cache)",
             "1000000",
             plugins::Bounds("0", "infinity"));
+        add_option<int>(
+            "max_cache_memory",
+            "maximum memory in MiB used by all cache tables together "
+            "(set to 0 to disable cache)",
+            "512",
+            plugins::Bounds("0", "infinity"));
         Heuristic::add_options_to_feature(*this);
 
         document_language_support("action costs", "supported");
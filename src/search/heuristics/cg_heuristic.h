@@ -5,6 +5,7 @@
 
 #include "../algorithms/priority_queues.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -23,8 +24,8 @@ class CGHeuristic : public Heuristic {
     std::vector<std::unique_ptr<domain_transition_graph::DomainTransitionGraph>> transition_graphs;
 
     std::unique_ptr<CGCache> cache;
-    int cache_hits;
-    int cache_misses;
+    std::int64_t cache_hits;
+    std::int64_t cache_misses;
 
     int helpful_transition_extraction_counter;
 
@@ -40,6 +41,7 @@ class CGHeuristic : public Heuristic {
         const State &state,
         domain_transition_graph::DomainTransitionGraph *dtg,
         int to);
+    void print_statistics() const;
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
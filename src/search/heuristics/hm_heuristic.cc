@@ -7,11 +7,12 @@
 
 #include <cassert>
 #include <limits>
-#include <set>
 
 using namespace std;
 
 namespace hm_heuristic {
+static const int INF = numeric_limits<int>::max();
+
 HMHeuristic::HMHeuristic(const plugins::Options &opts)
     : Heuristic(opts),
       m(opts.get<int>("m")),
@@ -19,11 +20,10 @@ HMHeuristic::HMHeuristic(const plugins::Options &opts)
       goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
     if (log.is_at_least_normal()) {
         log << "Using h^" << m << "." << endl;
-        log << "The implementation of the h^m heuristic is preliminary." << endl
-            << "It is SLOOOOOOOOOOOW." << endl
-            << "Please do not use this for comparison!" << endl;
     }
-    generate_all_tuples();
+    compute_ranking();
+    build_operators();
+    goal_facts = get_fact_tuple(goals);
 }
 
 
@@ -32,224 +32,372 @@ bool HMHeuristic::dead_ends_are_reliable() const {
 }
 
 
+void HMHeuristic::compute_ranking() {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    fact_offsets.reserve(num_variables);
+    num_facts = 0;
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(num_facts);
+        int domain_size = var.get_domain_size();
+        for (int value = 0; value < domain_size; ++value) {
+            fact_variables.push_back(var.get_id());
+        }
+        num_facts += domain_size;
+    }
+
+    binomials.assign((num_facts + 1) * (m + 1), 0);
+    for (int n = 0; n <= num_facts; ++n) {
+        binomials[n * (m + 1)] = 1;
+        for (int k = 1; k <= m && n > 0; ++k) {
+            binomials[n * (m + 1) + k] =
+                get_binomial(n - 1, k - 1) + get_binomial(n - 1, k);
+        }
+    }
+
+    size_offsets.assign(m + 2, 0);
+    for (int k = 1; k <= m; ++k) {
+        size_offsets[k + 1] = size_offsets[k] + get_binomial(num_facts, k);
+    }
+    hm_table.resize(size_offsets[m + 1]);
+    if (log.is_at_least_normal()) {
+        log << "h^m table size: " << hm_table.size() << endl;
+    }
+
+    fact_is_dirty.assign(num_facts, false);
+    fact_is_new_dirty.assign(num_facts, false);
+    effect_value_of_var.assign(num_variables, -1);
+    precondition_value_of_var.assign(num_variables, -1);
+    var_in_tuple.assign(num_variables, false);
+}
+
+
+void HMHeuristic::build_operators() {
+    OperatorsProxy ops = task_proxy.get_operators();
+    operators.reserve(ops.size());
+    for (OperatorProxy op : ops) {
+        FactTuple preconditions = get_fact_tuple(
+            task_properties::get_fact_pairs(op.get_preconditions()));
+        FactTuple effects;
+        for (EffectProxy eff : op.get_effects()) {
+            effects.push_back(get_fact_id(eff.get_fact().get_pair()));
+        }
+        sort(effects.begin(), effects.end());
+        effects.erase(unique(effects.begin(), effects.end()), effects.end());
+        operators.push_back({move(preconditions), move(effects), op.get_cost()});
+    }
+}
+
+
+HMHeuristic::FactTuple HMHeuristic::get_fact_tuple(const Tuple &tuple) const {
+    FactTuple fact_tuple;
+    fact_tuple.reserve(tuple.size());
+    for (const FactPair &fact : tuple) {
+        fact_tuple.push_back(get_fact_id(fact));
+    }
+    sort(fact_tuple.begin(), fact_tuple.end());
+    return fact_tuple;
+}
+
+
+size_t HMHeuristic::rank_tuple(const FactTuple &tuple) const {
+    assert(!tuple.empty() && static_cast<int>(tuple.size()) <= m);
+    size_t rank = size_offsets[tuple.size()];
+    for (size_t i = 0; i < tuple.size(); ++i) {
+        rank += get_binomial(tuple[i], i + 1);
+    }
+    return rank;
+}
+
+
+/*
+  Call callback with the rank of every non-empty subset of at most m
+  elements of the sorted fact tuple facts. The first size elements of the
+  subset have already been chosen from facts[0..start) and contribute
+  partial_rank.
+*/
+template<typename Callback>
+void HMHeuristic::for_each_subtuple_rank(
+    const FactTuple &facts, int start, int size, size_t partial_rank,
+    const Callback &callback) const {
+    for (size_t i = start; i < facts.size(); ++i) {
+        size_t rank = partial_rank + get_binomial(facts[i], size + 1);
+        callback(size_offsets[size + 1] + rank);
+        if (size + 1 < m) {
+            for_each_subtuple_rank(facts, i + 1, size + 1, rank, callback);
+        }
+    }
+}
+
+
 int HMHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     if (task_properties::is_goal_state(task_proxy, state)) {
         return 0;
     } else {
-        Tuple s_tup = task_properties::get_fact_pairs(state);
+        state.unpack();
+        const vector<int> &values = state.get_unpacked_values();
+        FactTuple state_facts(values.size());
+        for (size_t var = 0; var < values.size(); ++var) {
+            state_facts[var] = fact_offsets[var] + values[var];
+        }
 
-        init_hm_table(s_tup);
+        init_hm_table(state_facts);
         update_hm_table();
 
-        int h = eval(goals);
+        int h = eval(goal_facts);
 
-        if (h == numeric_limits<int>::max())
+        if (h == INF)
             return DEAD_END;
         return h;
     }
 }
 
 
-void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
-    }
+void HMHeuristic::init_hm_table(const FactTuple &state_facts) {
+    fill(hm_table.begin(), hm_table.end(), INF);
+    for_each_subtuple_rank(
+        state_facts, 0, 0, 0, [&](size_t rank) {hm_table[rank] = 0;});
 }
 
 
 void HMHeuristic::update_hm_table() {
-    int round = 0;
-    do {
-        ++round;
-        was_updated = false;
-
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
-
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
-
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
-                }
+    bool all_dirty = true;
+    while (true) {
+        for (const HMOperator &op : operators) {
+            bool precondition_is_dirty = all_dirty || any_of(
+                op.preconditions.begin(), op.preconditions.end(),
+                [&](int fact) {return fact_is_dirty[fact];});
+            if (precondition_is_dirty || !dirty_facts.empty()) {
+                process_operator(op, precondition_is_dirty);
             }
         }
-    } while (was_updated);
-}
 
-
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
-            }
+        for (int fact : dirty_facts) {
+            fact_is_dirty[fact] = false;
         }
-        if (!contradict && (tuple.size() > t.size()) && (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
-                    }
-                }
-            }
+        dirty_facts.clear();
+        if (new_dirty_facts.empty()) {
+            break;
+        }
+        swap(dirty_facts, new_dirty_facts);
+        swap(fact_is_dirty, fact_is_new_dirty);
+        all_dirty = false;
+    }
+}
 
-            sort(pre.begin(), pre.end());
 
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
-                }
-                vars.insert(fact.var);
-            }
+void HMHeuristic::process_operator(
+    const HMOperator &op, bool precondition_is_dirty) {
+    int c1 = eval(op.preconditions);
+    if (c1 == INF) {
+        return;
+    }
 
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
-                }
-            }
+    for (int fact : op.preconditions) {
+        int var = fact_variables[fact];
+        precondition_value_of_var[var] = fact - fact_offsets[var];
+    }
+    for (int fact : op.effects) {
+        int var = fact_variables[fact];
+        int value = fact - fact_offsets[var];
+        if (effect_value_of_var[var] == -1) {
+            effect_value_of_var[var] = value;
+        } else if (effect_value_of_var[var] != value) {
+            // Conditional effects with different values contradict all facts.
+            effect_value_of_var[var] = -2;
         }
     }
+
+    process_partial_effects(op, 0, c1, precondition_is_dirty);
+
+    for (int fact : op.preconditions) {
+        precondition_value_of_var[fact_variables[fact]] = -1;
+    }
+    for (int fact : op.effects) {
+        effect_value_of_var[fact_variables[fact]] = -1;
+    }
 }
 
 
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
+void HMHeuristic::process_partial_effects(
+    const HMOperator &op, int start, int c1, bool precondition_is_dirty) {
+    for (size_t i = start; i < op.effects.size(); ++i) {
+        int fact = op.effects[i];
+        int var = fact_variables[fact];
+        if (var_in_tuple[var]) {
+            continue;
+        }
+        partial_effect.push_back(fact);
+        var_in_tuple[var] = true;
 
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
+        if (precondition_is_dirty) {
+            update_hm_entry(partial_effect, c1 + op.cost);
+        }
+        if (static_cast<int>(partial_effect.size()) < m) {
+            extend_tuple(op, c1, precondition_is_dirty);
+            process_partial_effects(op, i + 1, c1, precondition_is_dirty);
         }
+
+        var_in_tuple[var] = false;
+        partial_effect.pop_back();
     }
-    return max;
 }
 
 
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
+void HMHeuristic::extend_tuple(
+    const HMOperator &op, int c1, bool precondition_is_dirty) {
+    int max_size = m - partial_effect.size();
+    if (precondition_is_dirty) {
+        extend_tuple_aux(op, c1, 0, max_size, -1);
+    } else {
+        /*
+          Only tuples including a dirty fact can lead to new values. Every
+          such extension is generated exactly once from its smallest dirty
+          fact (the anchor).
+        */
+        for (int anchor : dirty_facts) {
+            if (!can_extend_by(anchor)) {
+                continue;
+            }
+            int var = fact_variables[anchor];
+            extension.push_back(anchor);
+            var_in_tuple[var] = true;
+            apply_extension(op, c1);
+            if (max_size > 1) {
+                extend_tuple_aux(op, c1, 0, max_size, anchor);
+            }
+            var_in_tuple[var] = false;
+            extension.pop_back();
+        }
     }
-    return val;
 }
 
 
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
-                break;
-            }
+void HMHeuristic::extend_tuple_aux(
+    const HMOperator &op, int c1, int start_var, int max_size, int anchor) {
+    int num_variables = fact_offsets.size();
+    for (int var = start_var; var < num_variables; ++var) {
+        if (var_in_tuple[var]) {
+            continue;
         }
-        if (!found) {
-            return numeric_limits<int>::max();
+        int end = (var + 1 < num_variables) ? fact_offsets[var + 1] : num_facts;
+        for (int fact = fact_offsets[var]; fact < end; ++fact) {
+            if (!can_extend_by(fact) ||
+                (anchor != -1 && fact_is_dirty[fact] && fact < anchor)) {
+                continue;
+            }
+            extension.push_back(fact);
+            var_in_tuple[var] = true;
+            apply_extension(op, c1);
+            if (static_cast<int>(extension.size()) < max_size) {
+                extend_tuple_aux(op, c1, var + 1, max_size, anchor);
+            }
+            var_in_tuple[var] = false;
+            extension.pop_back();
         }
     }
-    return 0;
 }
 
 
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(const OperatorProxy &op) const {
-    Tuple preconditions = task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
+bool HMHeuristic::can_extend_by(int fact) const {
+    int var = fact_variables[fact];
+    int value = fact - fact_offsets[var];
+    // The singleton tuple {fact} has rank fact.
+    return !var_in_tuple[var] && hm_table[fact] != INF &&
+           (effect_value_of_var[var] == -1 ||
+            effect_value_of_var[var] == value) &&
+           (precondition_value_of_var[var] == -1 ||
+            precondition_value_of_var[var] == value);
 }
 
 
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
+void HMHeuristic::apply_extension(const HMOperator &op, int c1) {
+    tuple_buffer.assign(partial_effect.begin(), partial_effect.end());
+    tuple_buffer.insert(tuple_buffer.end(), extension.begin(), extension.end());
+    sort(tuple_buffer.begin(), tuple_buffer.end());
+    int &entry = hm_table[rank_tuple(tuple_buffer)];
+    /*
+      The precondition of the extended operator includes op.preconditions,
+      so its cost is at least c1. We are only interested in costs below
+      bound.
+    */
+    int bound = (entry == INF) ? INF : entry - op.cost;
+    if (c1 >= bound) {
+        return;
     }
-    sort(effects.begin(), effects.end());
-    return effects;
-}
 
-
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
-            return true;
-        }
+    merge_extension(op.preconditions);
+    // Subsets of op.preconditions are already accounted for by c1.
+    int c2 = c1;
+    if (!eval_extension(0, 0, 0, false, bound, c2)) {
+        update_hm_entry(tuple_buffer, c2 + op.cost);
     }
-    return false;
 }
 
 
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
+void HMHeuristic::merge_extension(const FactTuple &preconditions) {
+    precondition_buffer.assign(preconditions.begin(), preconditions.end());
+    for (int fact : extension) {
+        if (!binary_search(preconditions.begin(), preconditions.end(), fact)) {
+            precondition_buffer.push_back(fact);
+        }
+    }
+    sort(precondition_buffer.begin(), precondition_buffer.end());
+    is_extension_fact.clear();
+    for (int fact : precondition_buffer) {
+        is_extension_fact.push_back(
+            !binary_search(preconditions.begin(), preconditions.end(), fact));
+    }
 }
 
 
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
+bool HMHeuristic::eval_extension(
+    int start, int size, size_t partial_rank, bool contains_extension_fact,
+    int bound, int &max) const {
+    for (size_t i = start; i < precondition_buffer.size(); ++i) {
+        size_t rank = partial_rank + get_binomial(precondition_buffer[i], size + 1);
+        bool contains = contains_extension_fact || is_extension_fact[i];
+        if (contains) {
+            int h = hm_table[size_offsets[size + 1] + rank];
+            if (h > max) {
+                max = h;
+                if (max >= bound) {
+                    return true;
+                }
             }
         }
+        if (size + 1 < m && eval_extension(
+                i + 1, size + 1, rank, contains, bound, max)) {
+            return true;
+        }
     }
+    return false;
 }
 
 
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
+int HMHeuristic::eval(const FactTuple &t) const {
+    int max = 0;
+    for_each_subtuple_rank(
+        t, 0, 0, 0, [&](size_t rank) {
+            int h = hm_table[rank];
+            if (h > max) {
+                max = h;
+            }
+        });
+    return max;
 }
 
 
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz, vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-        }
-    } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(base_tuple, tuple, i + 1, sz - 1, res);
+void HMHeuristic::update_hm_entry(const FactTuple &t, int val) {
+    int &entry = hm_table[rank_tuple(t)];
+    if (entry > val) {
+        entry = val;
+        for (int fact : t) {
+            if (!fact_is_new_dirty[fact]) {
+                fact_is_new_dirty[fact] = true;
+                new_dirty_facts.push_back(fact);
+            }
         }
     }
 }
@@ -257,8 +405,28 @@ void HMHeuristic::generate_all_partial_tuples_aux(
 
 void HMHeuristic::dump_table() const {
     if (log.is_at_least_debug()) {
-        for (auto &hm_ent : hm_table) {
-            log << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
+        Tuple tuple;
+        FactTuple fact_tuple;
+        dump_table_aux(0, tuple, fact_tuple);
+    }
+}
+
+
+void HMHeuristic::dump_table_aux(
+    int var, Tuple &tuple, FactTuple &fact_tuple) const {
+    int num_variables = fact_offsets.size();
+    for (int i = var; i < num_variables; ++i) {
+        int domain_size = task_proxy.get_variables()[i].get_domain_size();
+        for (int j = 0; j < domain_size; ++j) {
+            tuple.emplace_back(i, j);
+            fact_tuple.push_back(fact_offsets[i] + j);
+            log << "h(" << tuple << ") = "
+                << hm_table[rank_tuple(fact_tuple)] << endl;
+            if (static_cast<int>(tuple.size()) < m) {
+                dump_table_aux(i + 1, tuple, fact_tuple);
+            }
+            fact_tuple.pop_back();
+            tuple.pop_back();
         }
     }
 }
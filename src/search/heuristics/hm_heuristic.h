@@ -5,7 +5,6 @@
 
 #include <algorithm>
 #include <iostream>
-#include <map>
 #include <string>
 #include <vector>
 
@@ -17,45 +16,106 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  Facts are numbered densely (ordered by variable, then value), and an
+  m-tuple is represented as the sorted vector of its fact IDs. Tuples are
+  ranked with the combinatorial number system, so the h^m table is a flat
+  array with one entry for every set of at most m facts. (Entries for sets
+  that mention a variable twice are never accessed.)
+
+  The fixpoint is computed in rounds over all operators like in the
+  original implementation, but each round only reconsiders the work that
+  can be affected by table entries that changed in the previous round:
+  we keep the set of "dirty" facts that occur in updated tuples. Operators
+  with a dirty precondition are processed completely; all other operators
+  are only extended by tuples containing at least one dirty fact.
 */
 
 class HMHeuristic : public Heuristic {
     using Tuple = std::vector<FactPair>;
+    // Sorted vector of fact IDs.
+    using FactTuple = std::vector<int>;
+
+    struct HMOperator {
+        FactTuple preconditions;
+        FactTuple effects;
+        int cost;
+    };
+
     // parameters
     const int m;
     const bool has_cond_effects;
 
     const Tuple goals;
 
-    // h^m table
-    std::map<Tuple, int> hm_table;
-    bool was_updated;
+    // fact_offsets[var]: ID of the first fact of variable var
+    std::vector<int> fact_offsets;
+    std::vector<int> fact_variables;
+    int num_facts;
+    FactTuple goal_facts;
+    std::vector<HMOperator> operators;
+
+    // binomials[n * (m + 1) + k] = n choose k for n <= num_facts, k <= m
+    std::vector<size_t> binomials;
+    // size_offsets[k]: rank of the first tuple of size k (1 <= k <= m + 1)
+    std::vector<size_t> size_offsets;
+
+    // h^m table, indexed by tuple rank
+    std::vector<int> hm_table;
+
+    // Facts occurring in tuples updated in the previous and current round.
+    std::vector<bool> fact_is_dirty;
+    std::vector<int> dirty_facts;
+    std::vector<bool> fact_is_new_dirty;
+    std::vector<int> new_dirty_facts;
+
+    // Scratch space used while processing a single operator.
+    std::vector<int> effect_value_of_var;
+    std::vector<int> precondition_value_of_var;
+    std::vector<bool> var_in_tuple;
+    FactTuple partial_effect;
+    FactTuple extension;
+    FactTuple tuple_buffer;
+    FactTuple precondition_buffer;
+    std::vector<bool> is_extension_fact;
+
+    size_t get_binomial(int n, int k) const {
+        return binomials[n * (m + 1) + k];
+    }
+    int get_fact_id(const FactPair &fact) const {
+        return fact_offsets[fact.var] + fact.value;
+    }
+    FactTuple get_fact_tuple(const Tuple &tuple) const;
+    size_t rank_tuple(const FactTuple &tuple) const;
+
+    template<typename Callback>
+    void for_each_subtuple_rank(
+        const FactTuple &facts, int start, int size, size_t partial_rank,
+        const Callback &callback) const;
+
+    void compute_ranking();
+    void build_operators();
 
     // auxiliary methods
-    void init_hm_table(const Tuple &t);
+    void init_hm_table(const FactTuple &state_facts);
     void update_hm_table();
-    int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(const Tuple &base_tuple,
-                                     std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(const Tuple &base_tuple, const Tuple &t, int index,
-                                         int sz, std::vector<Tuple> &res) const;
+    int eval(const FactTuple &t) const;
+    void update_hm_entry(const FactTuple &t, int val);
+
+    void process_operator(const HMOperator &op, bool precondition_is_dirty);
+    void process_partial_effects(
+        const HMOperator &op, int start, int c1, bool precondition_is_dirty);
+    void extend_tuple(const HMOperator &op, int c1, bool precondition_is_dirty);
+    void extend_tuple_aux(
+        const HMOperator &op, int c1, int start_var, int max_size, int anchor);
+    bool can_extend_by(int fact) const;
+    void apply_extension(const HMOperator &op, int c1);
+    void merge_extension(const FactTuple &preconditions);
+    bool eval_extension(
+        int start, int size, size_t partial_rank,
+        bool contains_extension_fact, int bound, int &max) const;
 
     void dump_table() const;
+    void dump_table_aux(int var, Tuple &tuple, FactTuple &fact_tuple) const;
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
@@ -10,6 +10,7 @@
 #include "../utils/memory.h"
 
 #include <iostream>
+#include <limits>
 
 using namespace std;
 
@@ -26,12 +27,18 @@ LandmarkCutHeuristic::~LandmarkCutHeuristic() {
 }
 
 int LandmarkCutHeuristic::compute_heuristic(const State &ancestor_state) {
+    return compute_heuristic_with_cutoff(
+        ancestor_state, numeric_limits<int>::max());
+}
+
+int LandmarkCutHeuristic::compute_heuristic_with_cutoff(
+    const State &ancestor_state, int cutoff) {
     State state = convert_ancestor_state(ancestor_state);
     int total_cost = 0;
     bool dead_end = landmark_generator->compute_landmarks(
         state,
         [&total_cost](int cut_cost) {total_cost += cut_cost;},
-        nullptr);
+        nullptr, cutoff);
 
     if (dead_end)
         return DEAD_END;
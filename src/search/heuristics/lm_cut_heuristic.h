@@ -16,6 +16,8 @@ class LandmarkCutHeuristic : public Heuristic {
     std::unique_ptr<LandmarkCutLandmarks> landmark_generator;
 
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual int compute_heuristic_with_cutoff(
+        const State &ancestor_state, int cutoff) override;
 public:
     explicit LandmarkCutHeuristic(const plugins::Options &opts);
     virtual ~LandmarkCutHeuristic() override;
@@ -275,7 +275,7 @@ void LandmarkCutLandmarks::validate_h_max() const {
 
 bool LandmarkCutLandmarks::compute_landmarks(
     const State &state, CostCallback cost_callback,
-    LandmarkCallback landmark_callback) {
+    LandmarkCallback landmark_callback, int cutoff) {
     for (RelaxedOperator &op : relaxed_operators) {
         op.cost = op.base_cost;
     }
@@ -292,7 +292,19 @@ bool LandmarkCutLandmarks::compute_landmarks(
         return true;
 
     int num_iterations = 0;
+    int total_cost = 0;
     while (artificial_goal.h_max_cost != 0) {
+        if (artificial_goal.h_max_cost >= cutoff - total_cost) {
+            /*
+              The h^max value for the remaining costs is admissible for
+              them, so the landmarks found so far together with it form a
+              cost partitioning.
+            */
+            if (cost_callback) {
+                cost_callback(artificial_goal.h_max_cost);
+            }
+            break;
+        }
         ++num_iterations;
         mark_goal_plateau(&artificial_goal);
         assert(cut.empty());
@@ -303,6 +315,7 @@ bool LandmarkCutLandmarks::compute_landmarks(
             cut_cost = min(cut_cost, op->cost);
         for (RelaxedOperator *op : cut)
             op->cost -= cut_cost;
+        total_cost += cut_cost;
 
         if (cost_callback) {
             cost_callback(cut_cost);
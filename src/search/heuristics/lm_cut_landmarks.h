@@ -7,6 +7,7 @@
 
 #include <cassert>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -101,10 +102,17 @@ public:
       making a copy of the landmark, so cost_callback should be used if only the
       cost of the landmark is needed.
 
+      If the sum of the landmark costs found so far plus the h^max value of
+      the remaining cost function reaches cutoff, the computation stops early
+      and cost_callback is called a final time with this h^max value (which
+      is not the cost of a landmark). The total reported cost is then
+      admissible and at least cutoff.
+
       Returns true iff state is detected as a dead end.
     */
     bool compute_landmarks(const State &state, CostCallback cost_callback,
-                           LandmarkCallback landmark_callback);
+                           LandmarkCallback landmark_callback,
+                           int cutoff = std::numeric_limits<int>::max());
 };
 
 inline void RelaxedOperator::update_h_max_supporter() {
@@ -384,6 +384,15 @@ void LPSolver::set_mip_gap(double gap) {
     lp::set_mip_gap(lp_solver.get(), gap);
 }
 
+void LPSolver::set_objective_limit(double limit) {
+    try {
+        lp_solver->setDblParam(OsiDualObjectiveLimit, limit);
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+    is_solved = false;
+}
+
 void LPSolver::solve() {
     try {
         if (is_initialized) {
@@ -456,6 +465,15 @@ bool LPSolver::is_infeasible() const {
     }
 }
 
+bool LPSolver::is_objective_limit_reached() const {
+    assert(is_solved);
+    try {
+        return lp_solver->isDualObjectiveLimitReached();
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
 bool LPSolver::is_unbounded() const {
     assert(is_solved);
     try {
@@ -164,11 +164,19 @@ public:
 
     LP_METHOD(void set_mip_gap(double gap))
 
+    /*
+      Allow the solver to stop as soon as it has proven that the objective
+      value of a minimization problem is at least the given limit. Use
+      get_infinity() to remove the limit. This only affects LPs, not MIPs.
+    */
+    LP_METHOD(void set_objective_limit(double limit))
+
     LP_METHOD(void solve())
     LP_METHOD(void write_lp(const std::string &filename) const)
     LP_METHOD(void print_failure_analysis() const)
     LP_METHOD(bool is_infeasible() const)
     LP_METHOD(bool is_unbounded() const)
+    LP_METHOD(bool is_objective_limit_reached() const)
 
     /*
       Return true if the solving the LP showed that it is bounded feasible and
@@ -5,8 +5,8 @@
 #include "../algorithms/priority_queues.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
-#include <deque>
 
 using namespace std;
 
@@ -45,58 +45,91 @@ bool Distances::is_unit_cost() const {
     return true;
 }
 
-static void breadth_first_search(
-    const vector<vector<int>> &graph, deque<int> &queue,
-    vector<int> &distances) {
-    while (!queue.empty()) {
-        int state = queue.front();
-        queue.pop_front();
-        for (size_t i = 0; i < graph[state].size(); ++i) {
-            int successor = graph[state][i];
-            if (distances[successor] > distances[state] + 1) {
-                distances[successor] = distances[state] + 1;
-                queue.push_back(successor);
-            }
-        }
+/*
+  Transitions of a transition system in compressed sparse row format, in
+  forward or backward direction. The neighbors of state s and the costs
+  of the corresponding transitions are at the positions begin[s], ...,
+  begin[s + 1] - 1. For unit-cost transition systems, costs is empty.
+*/
+struct Graph {
+    vector<int> begin;
+    vector<int> neighbors;
+    vector<int> costs;
+
+    int get_cost(int pos) const {
+        return costs.empty() ? 1 : costs[pos];
     }
-}
+};
 
-void Distances::compute_init_distances_unit_cost() {
-    vector<vector<int>> forward_graph(get_num_states());
-    for (const LocalLabelInfo &local_label_info : transition_system) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
-        for (const Transition &transition : transitions) {
-            forward_graph[transition.src].push_back(transition.target);
+static Graph build_graph(
+    const TransitionSystem &ts, bool forward, bool unit_cost,
+    const vector<int> &lower_bounds) {
+    /*
+      A search never assigns a finite distance to a state with infinite
+      lower bound, so we leave out all transitions from or to such states.
+    */
+    auto is_used = [&](const Transition &transition) {
+            return lower_bounds.empty() ||
+                   (lower_bounds[transition.src] != INF &&
+                    lower_bounds[transition.target] != INF);
+        };
+
+    int num_states = ts.get_size();
+    Graph graph;
+    graph.begin.assign(num_states + 1, 0);
+    for (const LocalLabelInfo &local_label_info : ts) {
+        for (const Transition &transition : local_label_info.get_transitions()) {
+            if (is_used(transition)) {
+                ++graph.begin[(forward ? transition.src : transition.target) + 1];
+            }
         }
     }
-
-    deque<int> queue;
-    queue.push_back(transition_system.get_init_state());
-    init_distances[transition_system.get_init_state()] = 0;
-    breadth_first_search(forward_graph, queue, init_distances);
-}
-
-void Distances::compute_goal_distances_unit_cost() {
-    vector<vector<int>> backward_graph(get_num_states());
-    for (const LocalLabelInfo &local_label_info : transition_system) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
-        for (const Transition &transition : transitions) {
-            backward_graph[transition.target].push_back(transition.src);
+    for (int state = 0; state < num_states; ++state) {
+        graph.begin[state + 1] += graph.begin[state];
+    }
+    int num_edges = graph.begin[num_states];
+    graph.neighbors.resize(num_edges);
+    if (!unit_cost) {
+        graph.costs.resize(num_edges);
+    }
+    vector<int> next_pos(graph.begin.begin(), graph.begin.end() - 1);
+    for (const LocalLabelInfo &local_label_info : ts) {
+        int cost = local_label_info.get_cost();
+        for (const Transition &transition : local_label_info.get_transitions()) {
+            if (is_used(transition)) {
+                int pos = next_pos[forward ? transition.src : transition.target]++;
+                graph.neighbors[pos] = forward ? transition.target : transition.src;
+                if (!unit_cost) {
+                    graph.costs[pos] = cost;
+                }
+            }
         }
     }
+    return graph;
+}
 
-    deque<int> queue;
-    for (int state = 0; state < get_num_states(); ++state) {
-        if (transition_system.is_goal_state(state)) {
-            goal_distances[state] = 0;
-            queue.push_back(state);
+static void breadth_first_search(
+    const Graph &graph, vector<int> &queue, vector<int> &distances) {
+    for (size_t i = 0; i < queue.size(); ++i) {
+        int state = queue[i];
+        int successor_distance = distances[state] + 1;
+        for (int pos = graph.begin[state]; pos < graph.begin[state + 1]; ++pos) {
+            int successor = graph.neighbors[pos];
+            if (distances[successor] > successor_distance) {
+                distances[successor] = successor_distance;
+                queue.push_back(successor);
+            }
         }
     }
-    breadth_first_search(backward_graph, queue, goal_distances);
 }
 
+/*
+  The adaptive queue is a bucket queue as long as the keys are small
+  compared to the number of pushes, which is the common case for the
+  small integer costs of most planning tasks.
+*/
 static void dijkstra_search(
-    const vector<vector<pair<int, int>>> &graph,
+    const Graph &graph,
     priority_queues::AdaptiveQueue<int> &queue,
     vector<int> &distances) {
     while (!queue.empty()) {
@@ -107,11 +140,9 @@ static void dijkstra_search(
         assert(state_distance <= distance);
         if (state_distance < distance)
             continue;
-        for (size_t i = 0; i < graph[state].size(); ++i) {
-            const pair<int, int> &transition = graph[state][i];
-            int successor = transition.first;
-            int cost = transition.second;
-            int successor_cost = state_distance + cost;
+        for (int pos = graph.begin[state]; pos < graph.begin[state + 1]; ++pos) {
+            int successor = graph.neighbors[pos];
+            int successor_cost = state_distance + graph.get_cost(pos);
             if (distances[successor] > successor_cost) {
                 distances[successor] = successor_cost;
                 queue.push(successor_cost, successor);
@@ -120,51 +151,134 @@ static void dijkstra_search(
     }
 }
 
-void Distances::compute_init_distances_general_cost() {
-    vector<vector<pair<int, int>>> forward_graph(get_num_states());
-    for (const LocalLabelInfo &local_label_info : transition_system) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
-        int cost = local_label_info.get_cost();
-        for (const Transition &transition : transitions) {
-            forward_graph[transition.src].push_back(
-                make_pair(transition.target, cost));
+/*
+  Turn upper bounds into exact distances. The upper bounds must be the
+  costs of actual paths. Only states whose bound decreases enter the
+  queue, so this is cheaper than a search from scratch when few
+  distances change.
+*/
+static void repair_distances(const Graph &graph, vector<int> &distances) {
+    priority_queues::AdaptiveQueue<int> queue;
+    int num_states = distances.size();
+    for (int state = 0; state < num_states; ++state) {
+        if (distances[state] == INF) {
+            continue;
+        }
+        for (int pos = graph.begin[state]; pos < graph.begin[state + 1]; ++pos) {
+            int successor = graph.neighbors[pos];
+            int successor_cost = distances[state] + graph.get_cost(pos);
+            if (distances[successor] > successor_cost) {
+                distances[successor] = successor_cost;
+                queue.push(successor_cost, successor);
+            }
         }
     }
+    dijkstra_search(graph, queue, distances);
+}
 
-    // TODO: Reuse the same queue for multiple computations to save speed?
-    //       Also see compute_goal_distances_general_cost.
-    priority_queues::AdaptiveQueue<int> queue;
-    init_distances[transition_system.get_init_state()] = 0;
-    queue.push(0, transition_system.get_init_state());
-    dijkstra_search(forward_graph, queue, init_distances);
+void Distances::search_init_distances(
+    bool unit_cost, const vector<int> &lower_bounds) {
+    Graph forward_graph = build_graph(
+        transition_system, true, unit_cost, lower_bounds);
+    int init_state = transition_system.get_init_state();
+    init_distances[init_state] = 0;
+    if (unit_cost) {
+        vector<int> queue;
+        queue.push_back(init_state);
+        breadth_first_search(forward_graph, queue, init_distances);
+    } else {
+        priority_queues::AdaptiveQueue<int> queue;
+        queue.push(0, init_state);
+        dijkstra_search(forward_graph, queue, init_distances);
+    }
 }
 
-void Distances::compute_goal_distances_general_cost() {
-    vector<vector<pair<int, int>>> backward_graph(get_num_states());
-    for (const LocalLabelInfo &local_label_info : transition_system) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
-        int cost = local_label_info.get_cost();
-        for (const Transition &transition : transitions) {
-            backward_graph[transition.target].push_back(
-                make_pair(transition.src, cost));
+void Distances::search_goal_distances(
+    bool unit_cost, const vector<int> &lower_bounds) {
+    Graph backward_graph = build_graph(
+        transition_system, false, unit_cost, lower_bounds);
+    if (unit_cost) {
+        vector<int> queue;
+        for (int state = 0; state < get_num_states(); ++state) {
+            if (transition_system.is_goal_state(state)) {
+                goal_distances[state] = 0;
+                queue.push_back(state);
+            }
         }
+        breadth_first_search(backward_graph, queue, goal_distances);
+    } else {
+        priority_queues::AdaptiveQueue<int> queue;
+        for (int state = 0; state < get_num_states(); ++state) {
+            if (transition_system.is_goal_state(state)) {
+                goal_distances[state] = 0;
+                queue.push(0, state);
+            }
+        }
+        dijkstra_search(backward_graph, queue, goal_distances);
     }
+}
 
-    // TODO: Reuse the same queue for multiple computations to save speed?
-    //       Also see compute_init_distances_general_cost.
-    priority_queues::AdaptiveQueue<int> queue;
-    for (int state = 0; state < get_num_states(); ++state) {
-        if (transition_system.is_goal_state(state)) {
-            goal_distances[state] = 0;
-            queue.push(0, state);
-        }
+void Distances::compute_distances(
+    bool compute_init_distances,
+    bool compute_goal_distances,
+    utils::LogProxy &log) {
+    compute_distances(
+        compute_init_distances, compute_goal_distances, vector<int>(),
+        vector<int>(), log);
+}
+
+void Distances::compute_distances_of_product(
+    const Distances &distances1,
+    const Distances &distances2,
+    bool compute_init_distances,
+    bool compute_goal_distances,
+    utils::LogProxy &log) {
+    /*
+      The distances of a product state are bounded from below by the
+      distances of its components in the factors. This follows the
+      numbering of product states in TransitionSystem::merge.
+    */
+    int num_states1 = distances1.get_num_states();
+    int num_states2 = distances2.get_num_states();
+    assert(get_num_states() == num_states1 * num_states2);
+    auto compute_lower_bounds = [&](
+        const vector<int> &factor_distances1,
+        const vector<int> &factor_distances2) {
+            vector<int> lower_bounds;
+            lower_bounds.reserve(num_states1 * num_states2);
+            for (int state1 = 0; state1 < num_states1; ++state1) {
+                for (int state2 = 0; state2 < num_states2; ++state2) {
+                    lower_bounds.push_back(max(
+                        factor_distances1[state1], factor_distances2[state2]));
+                }
+            }
+            return lower_bounds;
+        };
+
+    vector<int> init_lower_bounds;
+    if (compute_init_distances) {
+        assert(distances1.are_init_distances_computed());
+        assert(distances2.are_init_distances_computed());
+        init_lower_bounds = compute_lower_bounds(
+            distances1.init_distances, distances2.init_distances);
     }
-    dijkstra_search(backward_graph, queue, goal_distances);
+    vector<int> goal_lower_bounds;
+    if (compute_goal_distances) {
+        assert(distances1.are_goal_distances_computed());
+        assert(distances2.are_goal_distances_computed());
+        goal_lower_bounds = compute_lower_bounds(
+            distances1.goal_distances, distances2.goal_distances);
+    }
+    compute_distances(
+        compute_init_distances, compute_goal_distances, init_lower_bounds,
+        goal_lower_bounds, log);
 }
 
 void Distances::compute_distances(
     bool compute_init_distances,
     bool compute_goal_distances,
+    const vector<int> &init_lower_bounds,
+    const vector<int> &goal_lower_bounds,
     utils::LogProxy &log) {
     assert(compute_init_distances || compute_goal_distances);
     /*
@@ -225,26 +339,15 @@ void Distances::compute_distances(
         }
         log << " distances using ";
     }
-    if (is_unit_cost()) {
-        if (log.is_at_least_verbose()) {
-            log << "unit-cost";
-        }
-        if (compute_init_distances) {
-            compute_init_distances_unit_cost();
-        }
-        if (compute_goal_distances) {
-            compute_goal_distances_unit_cost();
-        }
-    } else {
-        if (log.is_at_least_verbose()) {
-            log << "general-cost";
-        }
-        if (compute_init_distances) {
-            compute_init_distances_general_cost();
-        }
-        if (compute_goal_distances) {
-            compute_goal_distances_general_cost();
-        }
+    bool unit_cost = is_unit_cost();
+    if (log.is_at_least_verbose()) {
+        log << (unit_cost ? "unit-cost" : "general-cost");
+    }
+    if (compute_init_distances) {
+        search_init_distances(unit_cost, init_lower_bounds);
+    }
+    if (compute_goal_distances) {
+        search_goal_distances(unit_cost, goal_lower_bounds);
     }
     if (log.is_at_least_verbose()) {
         log << " algorithm" << endl;
@@ -256,6 +359,15 @@ void Distances::compute_distances(
     if (compute_goal_distances) {
         goal_distances_computed = true;
     }
+
+#ifndef NDEBUG
+    for (int state = 0; state < num_states; ++state) {
+        assert(init_lower_bounds.empty() ||
+               init_distances[state] >= init_lower_bounds[state]);
+        assert(goal_lower_bounds.empty() ||
+               goal_distances[state] >= goal_lower_bounds[state]);
+    }
+#endif
 }
 
 void Distances::apply_abstraction(
@@ -282,7 +394,14 @@ void Distances::apply_abstraction(
         new_goal_distances.resize(new_num_states, DISTANCE_UNKNOWN);
     }
 
-    bool must_recompute = false;
+    /*
+      Every path in the old transition system induces a path with the same
+      cost in the new one, so the minimal distance of the states in an
+      equivalence class is an upper bound for the distance of the new state.
+      If all states of each class have the same distances (in particular
+      if the abstraction is f-preserving), these bounds are exact.
+    */
+    bool must_repair = false;
     for (int new_state = 0; new_state < new_num_states; ++new_state) {
         const StateEquivalenceClass &state_equivalence_class =
             state_equivalence_relation[new_state];
@@ -301,18 +420,15 @@ void Distances::apply_abstraction(
         ++pos;
         for (; pos != state_equivalence_class.end(); ++pos) {
             if (compute_init_distances && init_distances[*pos] != new_init_dist) {
-                must_recompute = true;
-                break;
+                must_repair = true;
+                new_init_dist = min(new_init_dist, init_distances[*pos]);
             }
             if (compute_goal_distances && goal_distances[*pos] != new_goal_dist) {
-                must_recompute = true;
-                break;
+                must_repair = true;
+                new_goal_dist = min(new_goal_dist, goal_distances[*pos]);
             }
         }
 
-        if (must_recompute)
-            break;
-
         if (compute_init_distances) {
             new_init_distances[new_state] = new_init_dist;
         }
@@ -321,17 +437,25 @@ void Distances::apply_abstraction(
         }
     }
 
-    if (must_recompute) {
+    init_distances = move(new_init_distances);
+    goal_distances = move(new_goal_distances);
+    if (must_repair) {
         if (log.is_at_least_verbose()) {
             log << transition_system.tag()
-                << "simplification was not f-preserving!" << endl;
+                << "simplification was not f-preserving, repairing distances"
+                << endl;
+        }
+        bool unit_cost = is_unit_cost();
+        if (compute_init_distances) {
+            repair_distances(
+                build_graph(transition_system, true, unit_cost, vector<int>()),
+                init_distances);
+        }
+        if (compute_goal_distances) {
+            repair_distances(
+                build_graph(transition_system, false, unit_cost, vector<int>()),
+                goal_distances);
         }
-        clear_distances();
-        compute_distances(
-            compute_init_distances, compute_goal_distances, log);
-    } else {
-        init_distances = move(new_init_distances);
-        goal_distances = move(new_goal_distances);
     }
 }
 
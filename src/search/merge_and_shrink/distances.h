@@ -33,10 +33,22 @@ class Distances {
     int get_num_states() const;
     bool is_unit_cost() const;
 
-    void compute_init_distances_unit_cost();
-    void compute_goal_distances_unit_cost();
-    void compute_init_distances_general_cost();
-    void compute_goal_distances_general_cost();
+    /*
+      Compute distances with breadth-first search for unit costs and with
+      Dijkstra's algorithm otherwise. If lower_bounds is non-empty, it
+      holds a lower bound on the distance of every state, and states with
+      infinite bound are excluded from the search.
+    */
+    void search_init_distances(
+        bool unit_cost, const std::vector<int> &lower_bounds);
+    void search_goal_distances(
+        bool unit_cost, const std::vector<int> &lower_bounds);
+    void compute_distances(
+        bool compute_init_distances,
+        bool compute_goal_distances,
+        const std::vector<int> &init_lower_bounds,
+        const std::vector<int> &goal_lower_bounds,
+        utils::LogProxy &log);
 public:
     explicit Distances(const TransitionSystem &transition_system);
     ~Distances() = default;
@@ -54,9 +66,24 @@ public:
         bool compute_goal_distances,
         utils::LogProxy &log);
 
+    /*
+      Compute the distances of the product of the transition systems of
+      distances1 and distances2, which must have the requested distances.
+      The distances of the factors bound the distances of the product from
+      below, which lets the search skip all product states that are
+      unreachable or dead in one of the factors.
+    */
+    void compute_distances_of_product(
+        const Distances &distances1,
+        const Distances &distances2,
+        bool compute_init_distances,
+        bool compute_goal_distances,
+        utils::LogProxy &log);
+
     /*
       Update distances according to the given abstraction. If the abstraction
-      is not f-preserving, distances are directly recomputed.
+      is not f-preserving, distances are repaired starting from the minimal
+      distances of the abstracted states, which are upper bounds.
 
       It is OK for the abstraction to drop states, but then all
       dropped states must be unreachable or irrelevant. (Otherwise,
@@ -48,6 +48,7 @@ FactoredTransitionSystem::FactoredTransitionSystem(
       transition_systems(move(transition_systems)),
       mas_representations(move(mas_representations)),
       distances(move(distances)),
+      factor_versions(this->transition_systems.size(), 0),
       compute_init_distances(compute_init_distances),
       compute_goal_distances(compute_goal_distances),
       num_active_entries(this->transition_systems.size()) {
@@ -65,6 +66,7 @@ FactoredTransitionSystem::FactoredTransitionSystem(FactoredTransitionSystem &&ot
       transition_systems(move(other.transition_systems)),
       mas_representations(move(other.mas_representations)),
       distances(move(other.distances)),
+      factor_versions(move(other.factor_versions)),
       compute_init_distances(move(other.compute_init_distances)),
       compute_goal_distances(move(other.compute_goal_distances)),
       num_active_entries(move(other.num_active_entries)) {
@@ -123,6 +125,7 @@ void FactoredTransitionSystem::apply_label_mapping(
                 label_mapping, static_cast<int>(i) != combinable_index);
         }
     }
+    ++factor_versions[combinable_index];
     assert_all_components_valid();
 }
 
@@ -151,6 +154,7 @@ bool FactoredTransitionSystem::apply_abstraction(
     }
     mas_representations[index]->apply_abstraction_to_lookup_table(
         abstraction_mapping);
+    ++factor_versions[index];
 
     /* If distances need to be recomputed, this already happened in the
        Distances object. */
@@ -162,35 +166,54 @@ int FactoredTransitionSystem::merge(
     int index1,
     int index2,
     utils::LogProxy &log) {
+    int new_index = get_size();
+    reserve_merged_indices(1);
+    merge_into_reserved_index(index1, index2, new_index, log);
+    return new_index;
+}
+
+void FactoredTransitionSystem::reserve_merged_indices(int num_merges) {
+    int new_size = get_size() + num_merges;
+    transition_systems.resize(new_size);
+    mas_representations.resize(new_size);
+    distances.resize(new_size);
+    factor_versions.resize(new_size, 0);
+    num_active_entries -= num_merges;
+}
+
+void FactoredTransitionSystem::merge_into_reserved_index(
+    int index1,
+    int index2,
+    int merged_index,
+    utils::LogProxy &log) {
     assert(is_component_valid(index1));
     assert(is_component_valid(index2));
-    transition_systems.push_back(
+    assert(!transition_systems[merged_index]);
+    transition_systems[merged_index] =
         TransitionSystem::merge(
             *labels,
             *transition_systems[index1],
             *transition_systems[index2],
-            log));
+            log);
+    const TransitionSystem &new_ts = *transition_systems[merged_index];
+    distances[merged_index] = utils::make_unique_ptr<Distances>(new_ts);
+    // Restore the invariant that distances are computed.
+    if (compute_init_distances || compute_goal_distances) {
+        distances[merged_index]->compute_distances_of_product(
+            *distances[index1], *distances[index2],
+            compute_init_distances, compute_goal_distances, log);
+    }
     distances[index1] = nullptr;
     distances[index2] = nullptr;
     transition_systems[index1] = nullptr;
     transition_systems[index2] = nullptr;
-    mas_representations.push_back(
+    mas_representations[merged_index] =
         utils::make_unique_ptr<MergeAndShrinkRepresentationMerge>(
             move(mas_representations[index1]),
-            move(mas_representations[index2])));
+            move(mas_representations[index2]));
     mas_representations[index1] = nullptr;
     mas_representations[index2] = nullptr;
-    const TransitionSystem &new_ts = *transition_systems.back();
-    distances.push_back(utils::make_unique_ptr<Distances>(new_ts));
-    int new_index = transition_systems.size() - 1;
-    // Restore the invariant that distances are computed.
-    if (compute_init_distances || compute_goal_distances) {
-        distances[new_index]->compute_distances(
-            compute_init_distances, compute_goal_distances, log);
-    }
-    --num_active_entries;
-    assert(is_component_valid(new_index));
-    return new_index;
+    assert(is_component_valid(merged_index));
 }
 
 pair<unique_ptr<MergeAndShrinkRepresentation>, unique_ptr<Distances>>
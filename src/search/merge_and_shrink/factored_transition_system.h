@@ -65,6 +65,8 @@ class FactoredTransitionSystem {
     std::vector<std::unique_ptr<TransitionSystem>> transition_systems;
     std::vector<std::unique_ptr<MergeAndShrinkRepresentation>> mas_representations;
     std::vector<std::unique_ptr<Distances>> distances;
+    // Incremented whenever the transition system of a factor changes.
+    std::vector<int> factor_versions;
     const bool compute_init_distances;
     const bool compute_goal_distances;
     int num_active_entries;
@@ -135,6 +137,25 @@ public:
         int index2,
         utils::LogProxy &log);
 
+    /*
+      Reserve the indices get_size(), ..., get_size() + num_merges - 1 for
+      the factors resulting from merges with merge_into_reserved_index.
+      The number of active entries is updated immediately.
+    */
+    void reserve_merged_indices(int num_merges);
+    /*
+      Merge the two factors at index1 and index2 into the reserved index
+      merged_index. Merges of disjoint pairs of factors into different
+      reserved indices, and transformations of the factors involved in
+      different merges (shrinking and pruning), may run concurrently since
+      they only read the labels and access the entries of their own factors.
+    */
+    void merge_into_reserved_index(
+        int index1,
+        int index2,
+        int merged_index,
+        utils::LogProxy &log);
+
     /*
       Extract the factor at the given index, rendering the FTS invalid.
     */
@@ -203,6 +224,19 @@ public:
     }
 
     bool is_active(int index) const;
+
+    /*
+      Return the number of transformations that changed the transition
+      system of the factor at the given index. Label reductions only count
+      for the factor at combinable_index because they merely rename labels
+      within the local labels of all other factors. Together with the index,
+      the version thus identifies the factor's transition system up to
+      label names, which lets merge scoring functions reuse scores of
+      unchanged factors.
+    */
+    int get_factor_version(int index) const {
+        return factor_versions[index];
+    }
 };
 }
 
@@ -302,6 +302,7 @@ void FTSFactory::build_transitions_for_operator(OperatorProxy op) {
         } else {
             assert(utils::is_sorted_unique(transitions));
         }
+        CompressedTransitions compressed_transitions(transitions);
 
         vector<int> &label_to_local_label =
             transition_system_data_by_var[var_id].label_to_local_label;
@@ -309,8 +310,7 @@ void FTSFactory::build_transitions_for_operator(OperatorProxy op) {
         bool found_locally_equivalent_label_group = false;
         for (size_t local_label = 0; local_label < local_label_infos.size(); ++local_label) {
             LocalLabelInfo &local_label_info = local_label_infos[local_label];
-            const vector<Transition> &local_label_transitions = local_label_info.get_transitions();
-            if (transitions == local_label_transitions) {
+            if (compressed_transitions == local_label_info.get_transitions()) {
                 assert(label_to_local_label[label] == -1);
                 label_to_local_label[label] = local_label;
                 local_label_info.add_label(label, label_cost);
@@ -322,7 +322,8 @@ void FTSFactory::build_transitions_for_operator(OperatorProxy op) {
         if (!found_locally_equivalent_label_group) {
             int new_local_label = local_label_infos.size();
             LabelGroup label_group = {label};
-            local_label_infos.emplace_back(move(label_group), move(transitions), label_cost);
+            local_label_infos.emplace_back(
+                move(label_group), move(compressed_transitions), label_cost);
             assert(label_to_local_label[label] == -1);
             label_to_local_label[label] = new_local_label;
         }
@@ -356,7 +357,7 @@ void FTSFactory::build_transitions_for_irrelevant_ops(
             ts_data.label_to_local_label[label] = new_local_label;
         }
         ts_data.local_label_infos.emplace_back(
-            move(irrelevant_labels), move(transitions), cost);
+            move(irrelevant_labels), CompressedTransitions(transitions), cost);
     }
 }
 
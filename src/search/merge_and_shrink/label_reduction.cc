@@ -7,19 +7,20 @@
 
 #include "../task_proxy.h"
 
-#include "../algorithms/equivalence_relation.h"
 #include "../plugins/plugin.h"
 #include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
-#include <unordered_map>
+#include <tuple>
 
 using namespace std;
 using utils::ExitCode;
@@ -57,39 +58,128 @@ void LabelReduction::initialize(const TaskProxy &task_proxy) {
     }
 }
 
+uint64_t LabelReduction::get_local_label_hash(int ts_index, int local_label) {
+    return utils::get_hash64(make_pair(ts_index, local_label));
+}
+
+vector<uint64_t> LabelReduction::compute_label_signatures(
+    const FactoredTransitionSystem &fts) const {
+    const Labels &labels = fts.get_labels();
+    vector<uint64_t> label_signatures(labels.get_max_num_labels(), 0);
+    for (int index : fts) {
+        const TransitionSystem &ts = fts.get_transition_system(index);
+        for (int label : labels) {
+            label_signatures[label] +=
+                get_local_label_hash(index, ts.get_local_label(label));
+        }
+    }
+    return label_signatures;
+}
+
+vector<vector<int>> LabelReduction::compute_combinable_label_groups(
+    int ts_index,
+    const FactoredTransitionSystem &fts,
+    const vector<uint64_t> &label_signatures) const {
+    /*
+      Labels l and l' are combinable iff they are locally equivalent in all
+      transition systems T' \neq T. (They may or may not be locally
+      equivalent in T.)
+    */
+    auto compare_local_labels = [&](int label1, int label2) {
+            for (int index : fts) {
+                if (index != ts_index) {
+                    const TransitionSystem &ts = fts.get_transition_system(index);
+                    int local_label1 = ts.get_local_label(label1);
+                    int local_label2 = ts.get_local_label(label2);
+                    if (local_label1 != local_label2) {
+                        return local_label1 < local_label2 ? -1 : 1;
+                    }
+                }
+            }
+            return 0;
+        };
+
+    // Sort the labels by signature without T, by cost and by label.
+    const Labels &labels = fts.get_labels();
+    const TransitionSystem &ts = fts.get_transition_system(ts_index);
+    vector<tuple<uint64_t, int, int>> keys;
+    keys.reserve(labels.get_num_active_labels());
+    for (int label : labels) {
+        uint64_t signature = label_signatures[label] -
+            get_local_label_hash(ts_index, ts.get_local_label(label));
+        keys.emplace_back(signature, labels.get_label_cost(label), label);
+    }
+    sort(keys.begin(), keys.end());
+
+    vector<vector<int>> groups;
+    int num_keys = keys.size();
+    int begin = 0;
+    while (begin < num_keys) {
+        int end = begin + 1;
+        while (end < num_keys &&
+               get<0>(keys[end]) == get<0>(keys[begin]) &&
+               get<1>(keys[end]) == get<1>(keys[begin])) {
+            ++end;
+        }
+        if (end - begin > 1) {
+            vector<int> group;
+            group.reserve(end - begin);
+            for (int i = begin; i < end; ++i) {
+                group.push_back(get<2>(keys[i]));
+            }
+            bool combinable = all_of(
+                group.begin() + 1, group.end(), [&](int label) {
+                    return compare_local_labels(group.front(), label) == 0;
+                });
+            if (combinable) {
+                groups.push_back(move(group));
+            } else {
+                // Hash collision: split the group by its local labels.
+                stable_sort(group.begin(), group.end(), [&](int label1, int label2) {
+                                return compare_local_labels(label1, label2) < 0;
+                            });
+                size_t run_begin = 0;
+                for (size_t i = 1; i <= group.size(); ++i) {
+                    if (i == group.size() ||
+                        compare_local_labels(group[run_begin], group[i]) != 0) {
+                        if (i - run_begin > 1) {
+                            // The stable sort keeps the labels of a run sorted.
+                            groups.emplace_back(
+                                group.begin() + run_begin, group.begin() + i);
+                        }
+                        run_begin = i;
+                    }
+                }
+            }
+        }
+        begin = end;
+    }
+    // Make the numbering of new labels independent of the hash values.
+    sort(groups.begin(), groups.end());
+    return groups;
+}
+
 void LabelReduction::compute_label_mapping(
-    const equivalence_relation::EquivalenceRelation &relation,
+    int ts_index,
     const FactoredTransitionSystem &fts,
+    const vector<uint64_t> &label_signatures,
     vector<pair<int, vector<int>>> &label_mapping,
     utils::LogProxy &log) const {
     const Labels &labels = fts.get_labels();
     int next_new_label = labels.get_num_total_labels();
-    int num_labels = 0;
-    int num_labels_after_reduction = 0;
-    for (const equivalence_relation::Block &block : relation) {
-        unordered_map<int, vector<int>> cost_to_equivalent_labels;
-        for (int label : block) {
-            assert(label < next_new_label);
-            int cost = labels.get_label_cost(label);
-            cost_to_equivalent_labels[cost].push_back(label);
-            ++num_labels;
-        }
-        for (auto &entry : cost_to_equivalent_labels) {
-            vector<int> &equivalent_labels = entry.second;
-            if (equivalent_labels.size() > 1) {
-                // Labels have to be sorted for LocalLabelInfo.
-                sort(equivalent_labels.begin(), equivalent_labels.end());
-                if (log.is_at_least_debug()) {
-                    log << "Reducing labels "
-                        << equivalent_labels << " to " << next_new_label << endl;
-                }
-                label_mapping.push_back(make_pair(next_new_label, equivalent_labels));
-                ++next_new_label;
-            }
-            if (!equivalent_labels.empty()) {
-                ++num_labels_after_reduction;
-            }
+    int num_labels = labels.get_num_active_labels();
+    int num_labels_after_reduction = num_labels;
+    for (vector<int> &equivalent_labels : compute_combinable_label_groups(
+             ts_index, fts, label_signatures)) {
+        // Labels have to be sorted for LocalLabelInfo.
+        assert(is_sorted(equivalent_labels.begin(), equivalent_labels.end()));
+        if (log.is_at_least_debug()) {
+            log << "Reducing labels "
+                << equivalent_labels << " to " << next_new_label << endl;
         }
+        num_labels_after_reduction -= static_cast<int>(equivalent_labels.size()) - 1;
+        label_mapping.emplace_back(next_new_label, move(equivalent_labels));
+        ++next_new_label;
     }
     int number_reduced_labels = num_labels - num_labels_after_reduction;
     if (log.is_at_least_verbose() && number_reduced_labels > 0) {
@@ -100,35 +190,30 @@ void LabelReduction::compute_label_mapping(
     }
 }
 
-equivalence_relation::EquivalenceRelation
-LabelReduction::compute_combinable_equivalence_relation(
+void LabelReduction::apply_label_mapping(
     int ts_index,
-    const FactoredTransitionSystem &fts) const {
+    const vector<pair<int, vector<int>>> &label_mapping,
+    FactoredTransitionSystem &fts,
+    vector<uint64_t> &label_signatures) const {
     /*
-      Returns an equivalence relation over labels s.t. l ~ l'
-      iff l and l' are locally equivalent in all transition systems
-      T' \neq T. (They may or may not be locally equivalent in T.)
+      Only the local labels of T change: in all other transition systems,
+      the new labels replace the reduced labels in their common local label.
     */
-
-    // Create the equivalence relation where all labels are equivalent.
     const Labels &labels = fts.get_labels();
-    int num_labels = labels.get_num_active_labels();
-    vector<int> all_active_labels;
-    all_active_labels.reserve(num_labels);
+    const TransitionSystem &ts = fts.get_transition_system(ts_index);
     for (int label : labels) {
-        all_active_labels.push_back(label);
+        label_signatures[label] -=
+            get_local_label_hash(ts_index, ts.get_local_label(label));
     }
-    equivalence_relation::EquivalenceRelation relation(all_active_labels);
-
-    for (int index : fts) {
-        if (index != ts_index) {
-            const TransitionSystem &ts = fts.get_transition_system(index);
-            for (const LocalLabelInfo &local_label_info : ts) {
-                relation.refine(local_label_info.get_label_group());
-            }
-        }
+    for (const pair<int, vector<int>> &mapping : label_mapping) {
+        label_signatures[mapping.first] =
+            label_signatures[mapping.second.front()];
+    }
+    fts.apply_label_mapping(label_mapping, ts_index);
+    for (int label : labels) {
+        label_signatures[label] +=
+            get_local_label_hash(ts_index, ts.get_local_label(label));
     }
-    return relation;
 }
 
 bool LabelReduction::reduce(
@@ -152,20 +237,19 @@ bool LabelReduction::reduce(
         assert(fts.is_active(next_merge.second));
 
         bool reduced = false;
-        equivalence_relation::EquivalenceRelation relation =
-            compute_combinable_equivalence_relation(next_merge.first, fts);
+        vector<uint64_t> label_signatures = compute_label_signatures(fts);
         vector<pair<int, vector<int>>> label_mapping;
-        compute_label_mapping(relation, fts, label_mapping, log);
+        compute_label_mapping(
+            next_merge.first, fts, label_signatures, label_mapping, log);
         if (!label_mapping.empty()) {
-            fts.apply_label_mapping(label_mapping, next_merge.first);
+            apply_label_mapping(
+                next_merge.first, label_mapping, fts, label_signatures);
             reduced = true;
         }
         utils::release_vector_memory(label_mapping);
 
-        relation = compute_combinable_equivalence_relation(
-            next_merge.second,
-            fts);
-        compute_label_mapping(relation, fts, label_mapping, log);
+        compute_label_mapping(
+            next_merge.second, fts, label_signatures, label_mapping, log);
         if (!label_mapping.empty()) {
             fts.apply_label_mapping(label_mapping, next_merge.second);
             reduced = true;
@@ -192,6 +276,7 @@ bool LabelReduction::reduce(
     }
 
     int num_unsuccessful_iterations = 0;
+    vector<uint64_t> label_signatures = compute_label_signatures(fts);
 
     bool reduced = false;
     /*
@@ -210,9 +295,8 @@ bool LabelReduction::reduce(
 
         vector<pair<int, vector<int>>> label_mapping;
         if (fts.is_active(ts_index)) {
-            equivalence_relation::EquivalenceRelation relation =
-                compute_combinable_equivalence_relation(ts_index, fts);
-            compute_label_mapping(relation, fts, label_mapping, log);
+            compute_label_mapping(
+                ts_index, fts, label_signatures, label_mapping, log);
         }
 
         if (label_mapping.empty()) {
@@ -227,7 +311,7 @@ bool LabelReduction::reduce(
             reduced = true;
             // See comment for the loop and its exit conditions.
             num_unsuccessful_iterations = 1;
-            fts.apply_label_mapping(label_mapping, ts_index);
+            apply_label_mapping(ts_index, label_mapping, fts, label_signatures);
         }
         if (num_unsuccessful_iterations == num_transition_systems) {
             // See comment for the loop and its exit conditions.
@@ -1,15 +1,12 @@
 #ifndef MERGE_AND_SHRINK_LABEL_REDUCTION_H
 #define MERGE_AND_SHRINK_LABEL_REDUCTION_H
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 class TaskProxy;
 
-namespace equivalence_relation {
-class EquivalenceRelation;
-}
-
 namespace plugins {
 class Options;
 }
@@ -63,17 +60,42 @@ class LabelReduction {
     std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     bool initialized() const;
-    /* Apply the given label equivalence relation to the set of labels and
-       compute the resulting label mapping. */
+    /*
+      Label signatures: the signature of a label is the sum of
+      get_local_label_hash(index, local label) over all active transition
+      systems. Two labels are combinable for the transition system T iff
+      they belong to the same local labels in all T' != T, so they share
+      the signature without the summand of T. Keeping all signatures in
+      one vector lets us find the combinable labels for one transition
+      system in near-linear time in the number of labels, and after
+      reducing labels for T, only the summands of T need to be updated.
+    */
+    static std::uint64_t get_local_label_hash(int ts_index, int local_label);
+    std::vector<std::uint64_t> compute_label_signatures(
+        const FactoredTransitionSystem &fts) const;
+    /*
+      Group the labels that are combinable for the given transition system
+      and have the same cost. Label signatures are only used as hash keys:
+      all groups are checked explicitly, so the result is exact.
+    */
+    std::vector<std::vector<int>> compute_combinable_label_groups(
+        int ts_index,
+        const FactoredTransitionSystem &fts,
+        const std::vector<std::uint64_t> &label_signatures) const;
+    /* Compute the label mapping that reduces all groups of combinable
+       labels with the same cost for the given transition system. */
     void compute_label_mapping(
-        const equivalence_relation::EquivalenceRelation &relation,
+        int ts_index,
         const FactoredTransitionSystem &fts,
+        const std::vector<std::uint64_t> &label_signatures,
         std::vector<std::pair<int, std::vector<int>>> &label_mapping,
         utils::LogProxy &log) const;
-    equivalence_relation::EquivalenceRelation
-    compute_combinable_equivalence_relation(
+    // Apply the label mapping to fts and update the label signatures.
+    void apply_label_mapping(
         int ts_index,
-        const FactoredTransitionSystem &fts) const;
+        const std::vector<std::pair<int, std::vector<int>>> &label_mapping,
+        FactoredTransitionSystem &fts,
+        std::vector<std::uint64_t> &label_signatures) const;
 public:
     explicit LabelReduction(const plugins::Options &options);
     void initialize(const TaskProxy &task_proxy);
@@ -35,6 +35,7 @@ LabelsConstIterator &LabelsConstIterator::operator++() {
 
 Labels::Labels(vector<int> &&label_costs, int max_num_labels)
     : label_costs(move(label_costs)),
+      reduced_labels(this->label_costs.size(), -1),
       max_num_labels(max_num_labels),
       num_active_labels(this->label_costs.size()) {
 }
@@ -46,6 +47,7 @@ void Labels::reduce_labels(const vector<int> &old_labels) {
       we compute the cost of the new label as the minimum cost of all old
       labels reduced to it to satisfy admissibility.
     */
+    int new_label = label_costs.size();
     int new_label_cost = INF;
     for (int old_label : old_labels) {
         int cost = get_label_cost(old_label);
@@ -53,8 +55,10 @@ void Labels::reduce_labels(const vector<int> &old_labels) {
             new_label_cost = cost;
         }
         label_costs[old_label] = -1;
+        reduced_labels[old_label] = new_label;
     }
     label_costs.push_back(new_label_cost);
+    reduced_labels.push_back(-1);
     num_active_labels -= old_labels.size();
     ++num_active_labels;
 }
@@ -64,6 +68,14 @@ int Labels::get_label_cost(int label) const {
     return label_costs[label];
 }
 
+int Labels::get_active_label(int label) const {
+    while (label_costs[label] == -1) {
+        label = reduced_labels[label];
+        assert(label != -1);
+    }
+    return label;
+}
+
 void Labels::dump_labels() const {
     utils::g_log << "active labels:" << endl;
     for (size_t label = 0; label < label_costs.size(); ++label) {
@@ -46,16 +46,21 @@ public:
 
   Labels are identified via integers indexing label_costs, which stores their
   costs. When using label reductions, labels that become inactive are set to
-  -1 in label_costs.
+  -1 in label_costs. For inactive labels, reduced_labels stores the label they
+  have been reduced to, so that the labels of the original operators can be
+  recovered after label reductions.
 */
 class Labels {
     std::vector<int> label_costs;
+    std::vector<int> reduced_labels;
     int max_num_labels; // The maximum number of labels that can be created.
     int num_active_labels; // The current number of active (non-reduced) labels.
 public:
     Labels(std::vector<int> &&label_costs, int max_num_labels);
     void reduce_labels(const std::vector<int> &old_labels);
     int get_label_cost(int label) const;
+    // Return the active label that the given label has been reduced to.
+    int get_active_label(int label) const;
     void dump_labels() const;
 
     // The summed number of both inactive and active labels.
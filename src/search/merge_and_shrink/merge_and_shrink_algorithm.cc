@@ -18,12 +18,16 @@
 #include "../utils/countdown_timer.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 #include "../utils/timer.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -48,6 +52,7 @@ MergeAndShrinkAlgorithm::MergeAndShrinkAlgorithm(const plugins::Options &opts) :
     prune_irrelevant_states(opts.get<bool>("prune_irrelevant_states")),
     log(utils::get_log_from_options(opts)),
     main_loop_max_time(opts.get<double>("main_loop_max_time")),
+    num_threads(opts.get<int>("num_threads")),
     starting_peak_memory(0) {
     assert(max_states_before_merge > 0);
     assert(max_states >= max_states_before_merge);
@@ -96,6 +101,7 @@ void MergeAndShrinkAlgorithm::dump_options() const {
         log << endl;
 
         log << "Main loop max time in seconds: " << main_loop_max_time << endl;
+        log << "Number of threads: " << num_threads << endl;
         log << endl;
     }
 }
@@ -161,6 +167,37 @@ bool MergeAndShrinkAlgorithm::ran_out_of_time(
     return false;
 }
 
+void MergeAndShrinkAlgorithm::run_merge_steps(
+    utils::ThreadPool &thread_pool,
+    int num_merges,
+    bool concurrently,
+    const function<void(int, utils::LogProxy &)> &step) const {
+    if (!concurrently || num_merges == 1) {
+        for (int i = 0; i < num_merges; ++i) {
+            step(i, log);
+        }
+        return;
+    }
+    /*
+      Each merge writes its output to its own buffer, which we write to the
+      log in the order of the merges after all steps finished. Concurrent
+      steps run on a single thread each (e.g. when shrinking with several
+      threads), so we use at most num_threads threads.
+    */
+    vector<ostringstream> outputs(num_merges);
+    thread_pool.run(
+        num_merges,
+        [&](int i) {
+            utils::ScopedThreadLimit thread_limit(1);
+            utils::LogProxy merge_log =
+                utils::get_stream_log(outputs[i], log.get_verbosity());
+            step(i, merge_log);
+        });
+    for (const ostringstream &output : outputs) {
+        log.write_lines(output.str());
+    }
+}
+
 void MergeAndShrinkAlgorithm::main_loop(
     FactoredTransitionSystem &fts,
     const TaskProxy &task_proxy) {
@@ -194,29 +231,63 @@ void MergeAndShrinkAlgorithm::main_loop(
                 << timer.get_elapsed_time()
                 << " (" << msg << ")" << endl;
         };
+    /*
+      Each iteration performs a round of merges of pairwise disjoint
+      factors, which consists of a single merge if we use only one thread.
+      Label reduction modifies the labels shared by all factors, so it runs
+      sequentially for all merges of the round and thus forms a
+      synchronization point. In between, the shrinking, merging and pruning
+      steps of different merges only access their own factors and run
+      concurrently.
+    */
+    utils::ThreadPool thread_pool(num_threads);
+    bool shrink_concurrently = shrink_strategy->can_shrink_concurrently();
     int iteration_counter = 0;
     while (fts.get_num_active_entries() > 1) {
         // Choose next transition systems to merge
-        pair<int, int> merge_indices = merge_strategy->get_next();
+        vector<pair<int, int>> merges;
+        if (num_threads > 1) {
+            merges = merge_strategy->get_next_merges();
+        } else {
+            merges.push_back(merge_strategy->get_next());
+        }
         if (ran_out_of_time(timer)) {
             break;
         }
-        int merge_index1 = merge_indices.first;
-        int merge_index2 = merge_indices.second;
-        assert(merge_index1 != merge_index2);
+        int num_merges = merges.size();
+        assert(num_merges >= 1);
         if (log.is_at_least_normal()) {
-            log << "Next pair of indices: ("
-                << merge_index1 << ", " << merge_index2 << ")" << endl;
+            if (num_merges == 1) {
+                log << "Next pair of indices: (" << merges[0].first << ", "
+                    << merges[0].second << ")" << endl;
+            } else {
+                log << "Next round of pairs of indices:";
+                for (const pair<int, int> &merge_indices : merges) {
+                    log << " (" << merge_indices.first << ", "
+                        << merge_indices.second << ")";
+                }
+                log << endl;
+            }
             if (log.is_at_least_verbose()) {
-                fts.statistics(merge_index1, log);
-                fts.statistics(merge_index2, log);
+                for (const pair<int, int> &merge_indices : merges) {
+                    assert(merge_indices.first != merge_indices.second);
+                    fts.statistics(merge_indices.first, log);
+                    fts.statistics(merge_indices.second, log);
+                }
             }
-            log_main_loop_progress("after computation of next merge");
+            log_main_loop_progress(
+                num_merges == 1 ? "after computation of next merge"
+                : "after computation of next merges");
         }
 
         // Label reduction (before shrinking)
         if (label_reduction && label_reduction->reduce_before_shrinking()) {
-            bool reduced = label_reduction->reduce(merge_indices, fts, log);
+            bool reduced = false;
+            for (const pair<int, int> &merge_indices : merges) {
+                if (label_reduction->reduce(merge_indices, fts, log)) {
+                    reduced = true;
+                }
+            }
             if (log.is_at_least_normal() && reduced) {
                 log_main_loop_progress("after label reduction");
             }
@@ -227,16 +298,22 @@ void MergeAndShrinkAlgorithm::main_loop(
         }
 
         // Shrinking
-        bool shrunk = shrink_before_merge_step(
-            fts,
-            merge_index1,
-            merge_index2,
-            max_states,
-            max_states_before_merge,
-            shrink_threshold_before_merge,
-            *shrink_strategy,
-            log);
-        if (log.is_at_least_normal() && shrunk) {
+        vector<int> shrunk(num_merges, false);
+        run_merge_steps(
+            thread_pool, num_merges, shrink_concurrently,
+            [&](int i, utils::LogProxy &merge_log) {
+                shrunk[i] = shrink_before_merge_step(
+                    fts,
+                    merges[i].first,
+                    merges[i].second,
+                    max_states,
+                    max_states_before_merge,
+                    shrink_threshold_before_merge,
+                    *shrink_strategy,
+                    merge_log);
+            });
+        if (log.is_at_least_normal() &&
+            find(shrunk.begin(), shrunk.end(), true) != shrunk.end()) {
             log_main_loop_progress("after shrinking");
         }
 
@@ -246,7 +323,12 @@ void MergeAndShrinkAlgorithm::main_loop(
 
         // Label reduction (before merging)
         if (label_reduction && label_reduction->reduce_before_merging()) {
-            bool reduced = label_reduction->reduce(merge_indices, fts, log);
+            bool reduced = false;
+            for (const pair<int, int> &merge_indices : merges) {
+                if (label_reduction->reduce(merge_indices, fts, log)) {
+                    reduced = true;
+                }
+            }
             if (log.is_at_least_normal() && reduced) {
                 log_main_loop_progress("after label reduction");
             }
@@ -257,16 +339,26 @@ void MergeAndShrinkAlgorithm::main_loop(
         }
 
         // Merging
-        int merged_index = fts.merge(merge_index1, merge_index2, log);
-        int abs_size = fts.get_transition_system(merged_index).get_size();
-        if (abs_size > maximum_intermediate_size) {
-            maximum_intermediate_size = abs_size;
-        }
-
-        if (log.is_at_least_normal()) {
+        int first_merged_index = fts.get_size();
+        fts.reserve_merged_indices(num_merges);
+        run_merge_steps(
+            thread_pool, num_merges, true,
+            [&](int i, utils::LogProxy &merge_log) {
+                fts.merge_into_reserved_index(
+                    merges[i].first, merges[i].second,
+                    first_merged_index + i, merge_log);
+            });
+        for (int i = 0; i < num_merges; ++i) {
+            int merged_index = first_merged_index + i;
+            int abs_size = fts.get_transition_system(merged_index).get_size();
+            if (abs_size > maximum_intermediate_size) {
+                maximum_intermediate_size = abs_size;
+            }
             if (log.is_at_least_verbose()) {
                 fts.statistics(merged_index, log);
             }
+        }
+        if (log.is_at_least_normal()) {
             log_main_loop_progress("after merging");
         }
 
@@ -276,15 +368,25 @@ void MergeAndShrinkAlgorithm::main_loop(
 
         // Pruning
         if (prune_unreachable_states || prune_irrelevant_states) {
-            bool pruned = prune_step(
-                fts,
-                merged_index,
-                prune_unreachable_states,
-                prune_irrelevant_states,
-                log);
-            if (log.is_at_least_normal() && pruned) {
+            vector<int> pruned(num_merges, false);
+            run_merge_steps(
+                thread_pool, num_merges, true,
+                [&](int i, utils::LogProxy &merge_log) {
+                    pruned[i] = prune_step(
+                        fts,
+                        first_merged_index + i,
+                        prune_unreachable_states,
+                        prune_irrelevant_states,
+                        merge_log);
+                });
+            if (log.is_at_least_normal() &&
+                find(pruned.begin(), pruned.end(), true) != pruned.end()) {
                 if (log.is_at_least_verbose()) {
-                    fts.statistics(merged_index, log);
+                    for (int i = 0; i < num_merges; ++i) {
+                        if (pruned[i]) {
+                            fts.statistics(first_merged_index + i, log);
+                        }
+                    }
                 }
                 log_main_loop_progress("after pruning");
             }
@@ -296,7 +398,13 @@ void MergeAndShrinkAlgorithm::main_loop(
           transition systems to be non-empty, i.e. the initial state
           not to be pruned/not to be evaluated as infinity.
         */
-        if (!fts.is_factor_solvable(merged_index)) {
+        bool unsolvable = false;
+        for (int i = 0; i < num_merges; ++i) {
+            if (!fts.is_factor_solvable(first_merged_index + i)) {
+                unsolvable = true;
+            }
+        }
+        if (unsolvable) {
             if (log.is_at_least_normal()) {
                 log << "Abstract problem is unsolvable, stopping "
                     "computation. " << endl << endl;
@@ -441,6 +549,21 @@ void add_merge_and_shrink_algorithm_options_to_feature(plugins::Feature &feature
 
     add_transition_system_size_limit_options_to_feature(feature);
 
+    feature.add_option<int>(
+        "num_threads",
+        "number of threads used for the main loop. With more than one "
+        "thread, the algorithm proceeds in rounds: it asks the merge strategy "
+        "for a set of merges of pairwise disjoint factors (for precomputed "
+        "merge trees, all merges whose children are atomic or already "
+        "merged; for SCC-based strategies, one merge per SCC that is merged "
+        "concurrently), applies label reduction for all of them sequentially "
+        "and then shrinks, merges and prunes the factors concurrently. "
+        "Shrinking only runs concurrently for shrink strategies that do not "
+        "use a random number generator. The result depends on whether more "
+        "than one thread is used, but not on the exact number of threads.",
+        "1",
+        Bounds("1", "infinity"));
+
     feature.add_option<double>(
         "main_loop_max_time",
         "A limit in seconds on the runtime of the main loop of the algorithm. "
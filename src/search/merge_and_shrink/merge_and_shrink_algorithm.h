@@ -3,6 +3,7 @@
 
 #include "../utils/logging.h"
 
+#include <functional>
 #include <memory>
 
 class TaskProxy;
@@ -15,6 +16,7 @@ class Options;
 
 namespace utils {
 class CountdownTimer;
+class ThreadPool;
 }
 
 namespace merge_and_shrink {
@@ -45,6 +47,12 @@ class MergeAndShrinkAlgorithm {
 
     mutable utils::LogProxy log;
     const double main_loop_max_time;
+    /*
+      With more than one thread, the main loop proceeds in rounds of
+      independent merges (see MergeStrategy::get_next_merges) whose
+      shrinking, merging and pruning steps run concurrently.
+    */
+    const int num_threads;
 
     long starting_peak_memory;
 
@@ -56,6 +64,16 @@ class MergeAndShrinkAlgorithm {
     void main_loop(
         FactoredTransitionSystem &fts,
         const TaskProxy &task_proxy);
+    /*
+      Call step(i, log) for the i-th of num_merges merges of a round, which
+      run concurrently if requested. Concurrent steps write to buffered logs
+      whose output is written to the log in the order of the merges.
+    */
+    void run_merge_steps(
+        utils::ThreadPool &thread_pool,
+        int num_merges,
+        bool concurrently,
+        const std::function<void(int, utils::LogProxy &)> &step) const;
 public:
     explicit MergeAndShrinkAlgorithm(const plugins::Options &opts);
     FactoredTransitionSystem build_factored_transition_system(const TaskProxy &task_proxy);
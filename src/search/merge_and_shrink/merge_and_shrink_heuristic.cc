@@ -4,9 +4,12 @@
 #include "factored_transition_system.h"
 #include "merge_and_shrink_algorithm.h"
 #include "merge_and_shrink_representation.h"
+#include "merge_and_shrink_representation_files.h"
 #include "transition_system.h"
 #include "types.h"
 
+#include "../persistent_data.h"
+
 #include "../plugins/plugin.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/markup.h"
@@ -23,9 +26,34 @@ namespace merge_and_shrink {
 MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const plugins::Options &opts)
     : Heuristic(opts) {
     log << "Initializing merge-and-shrink heuristic..." << endl;
-    MergeAndShrinkAlgorithm algorithm(opts);
-    FactoredTransitionSystem fts = algorithm.build_factored_transition_system(task_proxy);
-    extract_factors(fts);
+    bool use_cache = opts.get<bool>("cache_abstractions_persistently");
+    if (use_cache && !persistent_data::has_directory()) {
+        if (log.is_warning()) {
+            log << "Warning: merge-and-shrink abstractions should be cached "
+                << "persistently, but no directory has been given with "
+                << "--persistent-data-directory." << endl;
+        }
+        use_cache = false;
+    }
+    string configuration = opts.get_normalized_config();
+    if (use_cache && configuration.empty()) {
+        if (log.is_warning()) {
+            log << "Warning: merge-and-shrink heuristics without configuration "
+                << "string cannot cache their abstractions persistently."
+                << endl;
+        }
+        use_cache = false;
+    }
+    if (!use_cache || !load_representations(
+            task_proxy, configuration, mas_representations, log)) {
+        MergeAndShrinkAlgorithm algorithm(opts);
+        FactoredTransitionSystem fts = algorithm.build_factored_transition_system(task_proxy);
+        extract_factors(fts);
+        if (use_cache) {
+            save_representations(
+                task_proxy, configuration, mas_representations, log);
+        }
+    }
     log << "Done initializing merge-and-shrink heuristic." << endl << endl;
 }
 
@@ -46,7 +74,7 @@ void MergeAndShrinkHeuristic::extract_factor(
     }
     assert(distances->are_goal_distances_computed());
     mas_representation->set_distances(*distances);
-    mas_representations.push_back(move(mas_representation));
+    mas_representations.emplace_back(*mas_representation);
 }
 
 bool MergeAndShrinkHeuristic::extract_unsolvable_factor(FactoredTransitionSystem &fts) {
@@ -110,9 +138,11 @@ void MergeAndShrinkHeuristic::extract_factors(FactoredTransitionSystem &fts) {
 
 int MergeAndShrinkHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
+    state.unpack();
+    const vector<int> &values = state.get_unpacked_values();
     int heuristic = 0;
-    for (const unique_ptr<MergeAndShrinkRepresentation> &mas_representation : mas_representations) {
-        int cost = mas_representation->get_value(state);
+    for (const FlatMergeAndShrinkRepresentation &mas_representation : mas_representations) {
+        int cost = mas_representation.get_value(values);
         if (cost == PRUNED_STATE || cost == INF) {
             // If state is unreachable or irrelevant, we encountered a dead end.
             return DEAD_END;
@@ -173,6 +203,19 @@ public:
 
         Heuristic::add_options_to_feature(*this);
         add_merge_and_shrink_algorithm_options_to_feature(*this);
+        add_option<bool>(
+            "cache_abstractions_persistently",
+            "store the final merge-and-shrink abstractions (mapping states to "
+            "goal distances) in the directory given with the command line "
+            "option --persistent-data-directory and load them from there "
+            "instead of running the merge-and-shrink algorithm in later "
+            "planner runs on the same task with the same configuration of "
+            "this heuristic (ignoring options that do not affect the "
+            "abstractions, such as verbosity). Note that with time limits, "
+            "different runs may compute different abstractions, so the "
+            "loaded abstractions are those of the first run.",
+            "false");
+        mark_result_independent("cache_abstractions_persistently");
 
         document_note(
             "Note",
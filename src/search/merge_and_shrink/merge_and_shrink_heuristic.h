@@ -1,17 +1,18 @@
 #ifndef MERGE_AND_SHRINK_MERGE_AND_SHRINK_HEURISTIC_H
 #define MERGE_AND_SHRINK_MERGE_AND_SHRINK_HEURISTIC_H
 
+#include "merge_and_shrink_representation.h"
+
 #include "../heuristic.h"
 
-#include <memory>
+#include <vector>
 
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
-class MergeAndShrinkRepresentation;
 
 class MergeAndShrinkHeuristic : public Heuristic {
     // The final merge-and-shrink representations, storing goal distances.
-    std::vector<std::unique_ptr<MergeAndShrinkRepresentation>> mas_representations;
+    std::vector<FlatMergeAndShrinkRepresentation> mas_representations;
 
     void extract_factor(FactoredTransitionSystem &fts, int index);
     bool extract_unsolvable_factor(FactoredTransitionSystem &fts);
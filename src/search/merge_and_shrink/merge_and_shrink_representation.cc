@@ -71,6 +71,11 @@ bool MergeAndShrinkRepresentationLeaf::is_total() const {
     return true;
 }
 
+void MergeAndShrinkRepresentationLeaf::flatten(
+    FlatMergeAndShrinkRepresentation &flat) const {
+    flat.add_leaf(var_id, lookup_table);
+}
+
 void MergeAndShrinkRepresentationLeaf::dump(utils::LogProxy &log) const {
     if (log.is_at_least_debug()) {
         log << "lookup table (leaf): ";
@@ -146,6 +151,13 @@ bool MergeAndShrinkRepresentationMerge::is_total() const {
     return left_child->is_total() && right_child->is_total();
 }
 
+void MergeAndShrinkRepresentationMerge::flatten(
+    FlatMergeAndShrinkRepresentation &flat) const {
+    left_child->flatten(flat);
+    right_child->flatten(flat);
+    flat.add_merge(lookup_table);
+}
+
 void MergeAndShrinkRepresentationMerge::dump(utils::LogProxy &log) const {
     if (log.is_at_least_debug()) {
         log << "lookup table (merge): " << endl;
@@ -161,4 +173,68 @@ void MergeAndShrinkRepresentationMerge::dump(utils::LogProxy &log) const {
         right_child->dump(log);
     }
 }
+
+
+FlatMergeAndShrinkRepresentation::FlatMergeAndShrinkRepresentation(
+    const MergeAndShrinkRepresentation &representation) {
+    representation.flatten(*this);
+    compute_levels();
+}
+
+FlatMergeAndShrinkRepresentation::FlatMergeAndShrinkRepresentation(
+    vector<Node> &&nodes, vector<int> &&table)
+    : nodes(move(nodes)),
+      table(move(table)) {
+    compute_levels();
+}
+
+void FlatMergeAndShrinkRepresentation::compute_levels() {
+    int num_stacked = 0;
+    int num_levels = 0;
+    for (Node &node : nodes) {
+        if (node.var == -1) {
+            assert(num_stacked >= 2);
+            num_stacked -= 2;
+        }
+        node.level = num_stacked;
+        ++num_stacked;
+        num_levels = max(num_levels, num_stacked);
+    }
+    assert(num_stacked == 1);
+    stack.resize(num_levels);
+}
+
+void FlatMergeAndShrinkRepresentation::add_leaf(
+    int var, const vector<int> &lookup_table) {
+    nodes.push_back({var, static_cast<int>(table.size()), 0, -1});
+    table.insert(table.end(), lookup_table.begin(), lookup_table.end());
+}
+
+void FlatMergeAndShrinkRepresentation::add_merge(
+    const vector<vector<int>> &lookup_table) {
+    int num_columns = lookup_table.empty() ? 0 : lookup_table[0].size();
+    nodes.push_back({-1, static_cast<int>(table.size()), num_columns, -1});
+    for (const vector<int> &row : lookup_table) {
+        assert(static_cast<int>(row.size()) == num_columns);
+        table.insert(table.end(), row.begin(), row.end());
+    }
+}
+
+int FlatMergeAndShrinkRepresentation::get_value(const vector<int> &state) const {
+    for (const Node &node : nodes) {
+        int index;
+        if (node.var == -1) {
+            index = stack[node.level] * node.num_columns + stack[node.level + 1];
+        } else {
+            index = state[node.var];
+        }
+        int value = table[node.table_offset + index];
+        // Pruned states stay pruned in all ancestors.
+        if (value == PRUNED_STATE) {
+            return PRUNED_STATE;
+        }
+        stack[node.level] = value;
+    }
+    return stack[0];
+}
 }
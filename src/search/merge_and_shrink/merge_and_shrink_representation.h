@@ -12,6 +12,8 @@ class LogProxy;
 
 namespace merge_and_shrink {
 class Distances;
+class FlatMergeAndShrinkRepresentation;
+
 class MergeAndShrinkRepresentation {
 protected:
     int domain_size;
@@ -37,6 +39,8 @@ public:
        to PRUNED_STATE. */
     virtual bool is_total() const = 0;
     virtual void dump(utils::LogProxy &log) const = 0;
+    // Append the nodes of this representation to flat in post-order.
+    virtual void flatten(FlatMergeAndShrinkRepresentation &flat) const = 0;
 };
 
 
@@ -54,6 +58,7 @@ public:
     virtual int get_value(const State &state) const override;
     virtual bool is_total() const override;
     virtual void dump(utils::LogProxy &log) const override;
+    virtual void flatten(FlatMergeAndShrinkRepresentation &flat) const override;
 };
 
 
@@ -73,6 +78,66 @@ public:
     virtual int get_value(const State &state) const override;
     virtual bool is_total() const override;
     virtual void dump(utils::LogProxy &log) const override;
+    virtual void flatten(FlatMergeAndShrinkRepresentation &flat) const override;
+};
+
+
+/*
+  Merge-and-shrink representation compiled for fast evaluation. The nodes
+  of the representation tree are stored in post-order, and the lookup
+  tables of all nodes are stored one after the other in a single vector.
+  Evaluating the nodes in order computes the value of each node from the
+  value of its variable (leaf nodes) or from the values of its two
+  children (merge nodes), which are the top entries of a stack of
+  intermediate results. The stack position of each node is precomputed,
+  so evaluation needs neither recursion nor virtual calls.
+*/
+class FlatMergeAndShrinkRepresentation {
+public:
+    struct Node {
+        // Variable of leaf nodes and -1 for merge nodes.
+        int var;
+        int table_offset;
+        // Number of columns of the lookup table of merge nodes.
+        int num_columns;
+        // Stack position of the value of the node.
+        int level;
+    };
+private:
+    std::vector<Node> nodes;
+    std::vector<int> table;
+    // Stack of intermediate results of get_value(); not thread-safe.
+    mutable std::vector<int> stack;
+
+    friend class MergeAndShrinkRepresentationLeaf;
+    friend class MergeAndShrinkRepresentationMerge;
+    void add_leaf(int var, const std::vector<int> &lookup_table);
+    void add_merge(const std::vector<std::vector<int>> &lookup_table);
+    void compute_levels();
+public:
+    explicit FlatMergeAndShrinkRepresentation(
+        const MergeAndShrinkRepresentation &representation);
+    /*
+      Create the representation from its nodes in post-order and its
+      lookup tables, e.g., when loading it from a file. The levels of the
+      nodes are computed here.
+    */
+    FlatMergeAndShrinkRepresentation(
+        std::vector<Node> &&nodes, std::vector<int> &&table);
+
+    const std::vector<Node> &get_nodes() const {
+        return nodes;
+    }
+
+    const std::vector<int> &get_table() const {
+        return table;
+    }
+
+    /*
+      Return the value that the state with the given values is mapped to,
+      like MergeAndShrinkRepresentation::get_value.
+    */
+    int get_value(const std::vector<int> &state) const;
 };
 }
 
@@ -0,0 +1,236 @@
+#include "merge_and_shrink_representation_files.h"
+
+#include "merge_and_shrink_representation.h"
+#include "types.h"
+
+#include "../persistent_data.h"
+#include "../task_proxy.h"
+
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+using persistent_data::WordReader;
+using persistent_data::write_word;
+
+namespace merge_and_shrink {
+static const uint64_t MAGIC = 0x505253414d5f4446ULL;
+static const uint64_t VERSION = 1;
+
+using Node = FlatMergeAndShrinkRepresentation::Node;
+
+static bool are_entries_in_range(
+    const vector<int> &table, int begin, int end, int range) {
+    for (int i = begin; i < end; ++i) {
+        if (table[i] != PRUNED_STATE && (table[i] < 0 || table[i] >= range)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+  Check that the nodes form a tree in post-order, that each lookup table
+  has the size required by its node and that all lookup tables only map
+  to valid rows and columns of their parents.
+*/
+static bool are_nodes_valid(
+    const TaskProxy &task_proxy, const vector<Node> &nodes,
+    const vector<int> &table) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    int num_nodes = nodes.size();
+    vector<int> table_ends(num_nodes);
+    // Nodes whose value is on the stack.
+    vector<int> stack;
+    for (int i = 0; i < num_nodes; ++i) {
+        const Node &node = nodes[i];
+        int table_begin = i == 0 ? 0 : table_ends[i - 1];
+        if (node.table_offset != table_begin) {
+            return false;
+        }
+        int table_size;
+        if (node.var == -1) {
+            int end = i + 1 < num_nodes ?
+                nodes[i + 1].table_offset : static_cast<int>(table.size());
+            table_size = end - table_begin;
+            if (stack.size() < 2 || node.num_columns < 1 || table_size < 1 ||
+                table_size % node.num_columns != 0) {
+                return false;
+            }
+            int right_child = stack.back();
+            stack.pop_back();
+            int left_child = stack.back();
+            stack.pop_back();
+            int num_rows = table_size / node.num_columns;
+            int left_begin = nodes[left_child].table_offset;
+            int right_begin = nodes[right_child].table_offset;
+            if (!are_entries_in_range(
+                    table, left_begin, table_ends[left_child], num_rows) ||
+                !are_entries_in_range(
+                    table, right_begin, table_ends[right_child],
+                    node.num_columns)) {
+                return false;
+            }
+        } else {
+            if (node.var < 0 || node.var >= num_variables) {
+                return false;
+            }
+            table_size = variables[node.var].get_domain_size();
+        }
+        if (table_size > static_cast<int>(table.size()) - table_begin) {
+            return false;
+        }
+        table_ends[i] = table_begin + table_size;
+        stack.push_back(i);
+    }
+    if (stack.size() != 1 || table_ends.back() != static_cast<int>(table.size())) {
+        return false;
+    }
+    // The root maps to goal distances.
+    for (int i = nodes.back().table_offset; i < table_ends.back(); ++i) {
+        if (table[i] < 0 && table[i] != PRUNED_STATE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool read_representation(
+    const TaskProxy &task_proxy, WordReader &reader,
+    vector<FlatMergeAndShrinkRepresentation> &representations) {
+    uint64_t num_nodes = reader.read();
+    uint64_t table_size = reader.read();
+    const uint64_t max_size = numeric_limits<int>::max();
+    if (!reader.is_valid() || num_nodes < 1 || num_nodes > max_size ||
+        table_size > max_size) {
+        return false;
+    }
+    vector<Node> nodes;
+    for (uint64_t i = 0; reader.is_valid() && i < num_nodes; ++i) {
+        int var = static_cast<int>(static_cast<int64_t>(reader.read()));
+        uint64_t table_offset = reader.read();
+        uint64_t num_columns = reader.read();
+        if (table_offset > max_size || num_columns > max_size) {
+            return false;
+        }
+        nodes.push_back({var, static_cast<int>(table_offset),
+                         static_cast<int>(num_columns), -1});
+    }
+    const uint64_t *words = reader.skip((table_size + 1) / 2);
+    if (!reader.is_valid()) {
+        return false;
+    }
+    vector<int> table(table_size);
+    memcpy(table.data(), words, table_size * sizeof(int32_t));
+    if (!are_nodes_valid(task_proxy, nodes, table)) {
+        return false;
+    }
+    representations.emplace_back(move(nodes), move(table));
+    return true;
+}
+
+bool load_representations(
+    const TaskProxy &task_proxy, const string &configuration,
+    vector<FlatMergeAndShrinkRepresentation> &representations,
+    utils::LogProxy &log) {
+    uint64_t task_hash = task_properties::compute_task_hash(task_proxy);
+    string path = persistent_data::get_path(task_hash, configuration, "mas");
+    size_t size = 0;
+    shared_ptr<const char> contents = persistent_data::map_file(path, size);
+    if (!contents) {
+        return false;
+    }
+
+    WordReader reader(
+        reinterpret_cast<const uint64_t *>(contents.get()),
+        size / sizeof(uint64_t));
+    bool is_valid = size % sizeof(uint64_t) == 0 &&
+        reader.read() == MAGIC &&
+        reader.read() == VERSION &&
+        reader.read() == task_hash;
+    uint64_t configuration_length = reader.read();
+    uint64_t num_representations = reader.read();
+    const char *stored_configuration = reinterpret_cast<const char *>(
+        reader.skip((configuration_length + 7) / 8));
+    is_valid = is_valid && reader.is_valid() &&
+        configuration_length == configuration.size() &&
+        memcmp(stored_configuration, configuration.data(),
+               configuration_length) == 0;
+
+    vector<FlatMergeAndShrinkRepresentation> loaded_representations;
+    for (uint64_t i = 0; is_valid && i < num_representations; ++i) {
+        is_valid = read_representation(
+            task_proxy, reader, loaded_representations);
+    }
+    if (!is_valid || !reader.is_at_end()) {
+        if (log.is_warning()) {
+            log << "Warning: ignoring invalid merge-and-shrink file "
+                << path << endl;
+        }
+        return false;
+    }
+    representations = move(loaded_representations);
+    if (log.is_at_least_normal()) {
+        log << "Loaded " << representations.size()
+            << " merge-and-shrink representations from " << path << endl;
+    }
+    return true;
+}
+
+void save_representations(
+    const TaskProxy &task_proxy, const string &configuration,
+    const vector<FlatMergeAndShrinkRepresentation> &representations,
+    utils::LogProxy &log) {
+    static_assert(sizeof(int) == sizeof(int32_t), "int must have 32 bits");
+    uint64_t task_hash = task_properties::compute_task_hash(task_proxy);
+    string path = persistent_data::get_path(task_hash, configuration, "mas");
+    bool success = persistent_data::write_file(
+        path, [&](ostream &stream) {
+            write_word(stream, MAGIC);
+            write_word(stream, VERSION);
+            write_word(stream, task_hash);
+            write_word(stream, configuration.size());
+            write_word(stream, representations.size());
+            vector<char> padded_configuration(
+                (configuration.size() + 7) / 8 * 8, '\0');
+            copy(configuration.begin(), configuration.end(),
+                 padded_configuration.begin());
+            stream.write(padded_configuration.data(), padded_configuration.size());
+            for (const FlatMergeAndShrinkRepresentation &representation :
+                 representations) {
+                const vector<Node> &nodes = representation.get_nodes();
+                const vector<int> &table = representation.get_table();
+                write_word(stream, nodes.size());
+                write_word(stream, table.size());
+                for (const Node &node : nodes) {
+                    write_word(stream, static_cast<int64_t>(node.var));
+                    write_word(stream, node.table_offset);
+                    write_word(stream, node.num_columns);
+                }
+                stream.write(
+                    reinterpret_cast<const char *>(table.data()),
+                    table.size() * sizeof(int32_t));
+                if (table.size() % 2 == 1) {
+                    int32_t padding = 0;
+                    stream.write(
+                        reinterpret_cast<const char *>(&padding),
+                        sizeof(padding));
+                }
+            }
+        });
+    if (!success) {
+        if (log.is_warning()) {
+            log << "Warning: could not write merge-and-shrink file "
+                << path << endl;
+        }
+    } else if (log.is_at_least_normal()) {
+        log << "Stored " << representations.size()
+            << " merge-and-shrink representations in " << path << endl;
+    }
+}
+}
@@ -0,0 +1,60 @@
+#ifndef MERGE_AND_SHRINK_MERGE_AND_SHRINK_REPRESENTATION_FILES_H
+#define MERGE_AND_SHRINK_MERGE_AND_SHRINK_REPRESENTATION_FILES_H
+
+#include <string>
+#include <vector>
+
+class TaskProxy;
+
+namespace utils {
+class LogProxy;
+}
+
+namespace merge_and_shrink {
+class FlatMergeAndShrinkRepresentation;
+
+/*
+  The final merge-and-shrink representations of a heuristic, which map
+  states to goal distances, can be stored in files, so that later planner
+  runs on the same task can reuse them instead of running the
+  merge-and-shrink algorithm again.
+
+  As for PDBs (see pdbs/pattern_database_files.h), files are stored in
+  the directory for persistent data, their names are derived from a hash
+  of the task and a hash of the heuristic configuration, and they are
+  validated with the task hash and the complete configuration string.
+
+  Apart from the configuration string and the lookup tables, all fields
+  of a file are 64-bit unsigned integers in native byte order:
+    magic number, format version, task hash,
+    length of the configuration string, number of representations,
+    configuration string (padded with zeros to a multiple of 8 bytes),
+    and for each representation:
+      number of nodes, total size of the lookup tables,
+      variable (-1 for merge nodes), table offset and number of columns
+      of each node in post-order,
+      lookup tables as 32-bit integers (padded to a multiple of 8 bytes).
+*/
+
+/*
+  Set representations to the representations stored for the given task
+  and configuration and return true, or return false if there is no
+  valid file for them.
+*/
+extern bool load_representations(
+    const TaskProxy &task_proxy, const std::string &configuration,
+    std::vector<FlatMergeAndShrinkRepresentation> &representations,
+    utils::LogProxy &log);
+
+/*
+  Store the given representations for the given task and configuration.
+  Failing to write the file is not an error, since the representations
+  can always be recomputed.
+*/
+extern void save_representations(
+    const TaskProxy &task_proxy, const std::string &configuration,
+    const std::vector<FlatMergeAndShrinkRepresentation> &representations,
+    utils::LogProxy &log);
+}
+
+#endif
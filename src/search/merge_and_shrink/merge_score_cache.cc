@@ -0,0 +1,70 @@
+#include "merge_score_cache.h"
+
+#include "factored_transition_system.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace merge_and_shrink {
+static pair<int, int> get_key(const pair<int, int> &merge_candidate) {
+    return minmax(merge_candidate.first, merge_candidate.second);
+}
+
+MergeScoreCache::MergeScoreCache()
+    : size_after_cleanup(0) {
+}
+
+void MergeScoreCache::remove_inactive_entries(
+    const FactoredTransitionSystem &fts) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        const pair<int, int> &key = it->first;
+        if (fts.is_active(key.first) && fts.is_active(key.second)) {
+            ++it;
+        } else {
+            it = entries.erase(it);
+        }
+    }
+    size_after_cleanup = entries.size();
+}
+
+vector<int> MergeScoreCache::lookup_scores(
+    const FactoredTransitionSystem &fts,
+    const vector<pair<int, int>> &merge_candidates,
+    vector<double> &scores) {
+    assert(scores.size() == merge_candidates.size());
+    if (entries.size() > 2 * size_after_cleanup) {
+        remove_inactive_entries(fts);
+    }
+
+    vector<int> uncached_positions;
+    for (size_t i = 0; i < merge_candidates.size(); ++i) {
+        pair<int, int> key = get_key(merge_candidates[i]);
+        auto it = entries.find(key);
+        if (it != entries.end() &&
+            it->second.version1 == fts.get_factor_version(key.first) &&
+            it->second.version2 == fts.get_factor_version(key.second)) {
+            scores[i] = it->second.score;
+        } else {
+            uncached_positions.push_back(i);
+        }
+    }
+    return uncached_positions;
+}
+
+void MergeScoreCache::store_score(
+    const FactoredTransitionSystem &fts,
+    const pair<int, int> &merge_candidate,
+    double score) {
+    pair<int, int> key = get_key(merge_candidate);
+    entries[key] = {fts.get_factor_version(key.first),
+                    fts.get_factor_version(key.second),
+                    score};
+}
+
+void MergeScoreCache::clear() {
+    entries.clear();
+    size_after_cleanup = 0;
+}
+}
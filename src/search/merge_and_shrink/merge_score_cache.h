@@ -0,0 +1,56 @@
+#ifndef MERGE_AND_SHRINK_MERGE_SCORE_CACHE_H
+#define MERGE_AND_SHRINK_MERGE_SCORE_CACHE_H
+
+#include "../utils/hash.h"
+
+#include <utility>
+#include <vector>
+
+namespace merge_and_shrink {
+class FactoredTransitionSystem;
+
+/*
+  Cache for scores of merge candidates that only depend on the transition
+  systems of the two factors of a candidate. A cached score stays valid as
+  long as the versions of both factors in the factored transition system
+  are unchanged. After a merge, only the candidates involving the new
+  factor or a factor transformed since the last merge thus need new scores.
+
+  Entries of factors that are no longer active are removed whenever the
+  cache has doubled in size since the last cleanup.
+*/
+class MergeScoreCache {
+    struct Entry {
+        int version1;
+        int version2;
+        double score;
+    };
+
+    utils::HashMap<std::pair<int, int>, Entry> entries;
+    std::size_t size_after_cleanup;
+
+    void remove_inactive_entries(const FactoredTransitionSystem &fts);
+public:
+    MergeScoreCache();
+
+    /*
+      Set scores[i] to the cached score of merge_candidates[i] for all
+      candidates with a valid cached score and return the positions of all
+      other candidates in increasing order. The scores of the latter are
+      left unchanged.
+    */
+    std::vector<int> lookup_scores(
+        const FactoredTransitionSystem &fts,
+        const std::vector<std::pair<int, int>> &merge_candidates,
+        std::vector<double> &scores);
+
+    void store_score(
+        const FactoredTransitionSystem &fts,
+        const std::pair<int, int> &merge_candidate,
+        double score);
+
+    void clear();
+};
+}
+
+#endif
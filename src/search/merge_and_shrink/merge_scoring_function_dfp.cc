@@ -24,7 +24,7 @@ vector<int> MergeScoringFunctionDFP::compute_label_ranks(
 
     for (const LocalLabelInfo &local_label_info : ts) {
         const LabelGroup &label_group = local_label_info.get_label_group();
-        const vector<Transition> &transitions = local_label_info.get_transitions();
+        const CompressedTransitions &transitions = local_label_info.get_transitions();
         // Relevant labels with no transitions have a rank of infinity.
         int label_rank = INF;
         bool group_relevant = false;
@@ -64,13 +64,14 @@ vector<double> MergeScoringFunctionDFP::compute_scores(
     int num_ts = fts.get_size();
 
     vector<vector<int>> transition_system_label_ranks(num_ts);
-    vector<double> scores;
-    scores.reserve(merge_candidates.size());
+    vector<double> scores(merge_candidates.size());
+    vector<int> uncached_positions =
+        score_cache.lookup_scores(fts, merge_candidates, scores);
 
-    // Go over all pairs of transition systems and compute their weight.
-    for (pair<int, int> merge_candidate : merge_candidates) {
-        int ts_index1 = merge_candidate.first;
-        int ts_index2 = merge_candidate.second;
+    // Go over all pairs of transition systems without cached weight.
+    for (int pos : uncached_positions) {
+        int ts_index1 = merge_candidates[pos].first;
+        int ts_index2 = merge_candidates[pos].second;
 
         vector<int> &label_ranks1 = transition_system_label_ranks[ts_index1];
         if (label_ranks1.empty()) {
@@ -91,11 +92,17 @@ vector<double> MergeScoringFunctionDFP::compute_scores(
                 pair_weight = min(pair_weight, max_label_rank);
             }
         }
-        scores.push_back(pair_weight);
+        scores[pos] = pair_weight;
+        score_cache.store_score(fts, merge_candidates[pos], pair_weight);
     }
     return scores;
 }
 
+void MergeScoringFunctionDFP::initialize(const TaskProxy &) {
+    score_cache.clear();
+    initialized = true;
+}
+
 string MergeScoringFunctionDFP::name() const {
     return "dfp";
 }
@@ -1,10 +1,13 @@
 #ifndef MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_DFP_H
 #define MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_DFP_H
 
+#include "merge_score_cache.h"
 #include "merge_scoring_function.h"
 
 namespace merge_and_shrink {
 class MergeScoringFunctionDFP : public MergeScoringFunction {
+    MergeScoreCache score_cache;
+
     std::vector<int> compute_label_ranks(
         const FactoredTransitionSystem &fts, int index) const;
 protected:
@@ -15,6 +18,7 @@ public:
     virtual std::vector<double> compute_scores(
         const FactoredTransitionSystem &fts,
         const std::vector<std::pair<int, int>> &merge_candidates) override;
+    virtual void initialize(const TaskProxy &task_proxy) override;
 
     virtual bool requires_init_distances() const override {
         return false;
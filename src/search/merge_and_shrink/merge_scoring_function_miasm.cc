@@ -10,6 +10,10 @@
 #include "../plugins/plugin.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
+
+#include <algorithm>
+#include <limits>
 
 using namespace std;
 
@@ -20,57 +24,93 @@ MergeScoringFunctionMIASM::MergeScoringFunctionMIASM(
       max_states(options.get<int>("max_states")),
       max_states_before_merge(options.get<int>("max_states_before_merge")),
       shrink_threshold_before_merge(options.get<int>("threshold_before_merge")),
-      silent_log(utils::get_silent_log()) {
+      num_threads(options.get<int>("num_threads")) {
+}
+
+double MergeScoringFunctionMIASM::compute_score(
+    const FactoredTransitionSystem &fts, int index1, int index2) const {
+    utils::LogProxy silent_log = utils::get_silent_log();
+    unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
+        fts,
+        index1,
+        index2,
+        *shrink_strategy,
+        max_states,
+        max_states_before_merge,
+        shrink_threshold_before_merge,
+        silent_log);
+
+    // Compute distances for the product and count the alive states.
+    unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
+    const bool compute_init_distances = true;
+    const bool compute_goal_distances = true;
+    distances->compute_distances(compute_init_distances, compute_goal_distances, silent_log);
+    int num_states = product->get_size();
+    int alive_states_count = 0;
+    for (int state = 0; state < num_states; ++state) {
+        if (distances->get_init_distance(state) != INF &&
+            distances->get_goal_distance(state) != INF) {
+            ++alive_states_count;
+        }
+    }
+
+    /*
+      Compute the score as the ratio of alive states of the product
+      compared to the number of states of the full product.
+    */
+    assert(num_states);
+    return static_cast<double>(alive_states_count) /
+        static_cast<double>(num_states);
 }
 
 vector<double> MergeScoringFunctionMIASM::compute_scores(
     const FactoredTransitionSystem &fts,
     const vector<pair<int, int>> &merge_candidates) {
-    vector<double> scores;
-    scores.reserve(merge_candidates.size());
-    for (pair<int, int> merge_candidate : merge_candidates) {
-        int index1 = merge_candidate.first;
-        int index2 = merge_candidate.second;
-        unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
-            fts,
-            index1,
-            index2,
-            *shrink_strategy,
-            max_states,
-            max_states_before_merge,
-            shrink_threshold_before_merge,
-            silent_log);
-
-        // Compute distances for the product and count the alive states.
-        unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
-        const bool compute_init_distances = true;
-        const bool compute_goal_distances = true;
-        distances->compute_distances(compute_init_distances, compute_goal_distances, silent_log);
-        int num_states = product->get_size();
-        int alive_states_count = 0;
-        for (int state = 0; state < num_states; ++state) {
-            if (distances->get_init_distance(state) != INF &&
-                distances->get_goal_distance(state) != INF) {
-                ++alive_states_count;
-            }
-        }
+    vector<double> scores(merge_candidates.size());
+    vector<int> uncached_positions =
+        score_cache.lookup_scores(fts, merge_candidates, scores);
 
-        /*
-          Compute the score as the ratio of alive states of the product
-          compared to the number of states of the full product.
-        */
-        assert(num_states);
-        double score = static_cast<double>(alive_states_count) /
-            static_cast<double>(num_states);
-        scores.push_back(score);
+    /*
+      The trial products only read the factored transition system, so we
+      can compute them concurrently if the shrink strategy allows it. Every
+      worker writes only the score of its own candidate. Concurrent trials
+      shrink on a single thread each, so we use at most num_threads threads.
+    */
+    int num_shrink_threads =
+        shrink_strategy->can_shrink_concurrently() ? num_threads : 1;
+    int num_uncached = uncached_positions.size();
+    bool concurrently = min(num_shrink_threads, num_uncached) > 1;
+    utils::parallel_for(
+        num_uncached, num_shrink_threads, [&](int i) {
+            utils::ScopedThreadLimit thread_limit(
+                concurrently ? 1 : numeric_limits<int>::max());
+            int pos = uncached_positions[i];
+            scores[pos] = compute_score(
+                fts, merge_candidates[pos].first,
+                merge_candidates[pos].second);
+        });
+    for (int pos : uncached_positions) {
+        score_cache.store_score(fts, merge_candidates[pos], scores[pos]);
     }
     return scores;
 }
 
+void MergeScoringFunctionMIASM::initialize(const TaskProxy &) {
+    score_cache.clear();
+    initialized = true;
+}
+
 string MergeScoringFunctionMIASM::name() const {
     return "miasm";
 }
 
+void MergeScoringFunctionMIASM::dump_function_specific_options(
+    utils::LogProxy &log) const {
+    if (log.is_at_least_normal()) {
+        log << "Number of threads: " << num_threads << endl;
+    }
+}
+
 class MergeScoringFunctionMIASMFeature : public plugins::TypedFeature<MergeScoringFunction, MergeScoringFunctionMIASM> {
 public:
     MergeScoringFunctionMIASMFeature() : TypedFeature("sf_miasm") {
@@ -103,6 +143,20 @@ public:
             "We recommend setting this to match the shrink strategy configuration "
             "given to {{{merge_and_shrink}}}, see note below.");
         add_transition_system_size_limit_options_to_feature(*this);
+        add_option<int>(
+            "num_threads",
+            "number of threads that compute the trial products of merge "
+            "candidates concurrently. Each thread holds one product in "
+            "memory. The threads are only used if the shrink strategy "
+            "supports shrinking concurrently (e.g. bisimulation but not the "
+            "randomized bucket-based strategies). While trial products are "
+            "computed concurrently, each of them is shrunk on a single "
+            "thread, even if the shrink strategy is configured to use more "
+            "threads, so at most this many threads run at once. This does "
+            "not change the scores.",
+            "1",
+            plugins::Bounds("1", "infinity"));
+        mark_result_independent("num_threads");
 
         document_note(
             "Note",
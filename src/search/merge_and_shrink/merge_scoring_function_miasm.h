@@ -1,12 +1,15 @@
 #ifndef MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_MIASM_H
 #define MERGE_AND_SHRINK_MERGE_SCORING_FUNCTION_MIASM_H
 
+#include "merge_score_cache.h"
 #include "merge_scoring_function.h"
 
-#include "../utils/logging.h"
-
 #include <memory>
 
+namespace plugins {
+class Options;
+}
+
 namespace merge_and_shrink {
 class ShrinkStrategy;
 class MergeScoringFunctionMIASM : public MergeScoringFunction {
@@ -14,8 +17,14 @@ class MergeScoringFunctionMIASM : public MergeScoringFunction {
     const int max_states;
     const int max_states_before_merge;
     const int shrink_threshold_before_merge;
-    utils::LogProxy silent_log;
+    const int num_threads;
+    MergeScoreCache score_cache;
+
+    double compute_score(
+        const FactoredTransitionSystem &fts, int index1, int index2) const;
 protected:
+    virtual void dump_function_specific_options(
+        utils::LogProxy &log) const override;
     virtual std::string name() const override;
 public:
     explicit MergeScoringFunctionMIASM(const plugins::Options &options);
@@ -23,6 +32,7 @@ public:
     virtual std::vector<double> compute_scores(
         const FactoredTransitionSystem &fts,
         const std::vector<std::pair<int, int>> &merge_candidates) override;
+    virtual void initialize(const TaskProxy &task_proxy) override;
 
     virtual bool requires_init_distances() const override {
         return true;
@@ -7,4 +7,8 @@ MergeStrategy::MergeStrategy(
     const FactoredTransitionSystem &fts)
     : fts(fts) {
 }
+
+vector<pair<int, int>> MergeStrategy::get_next_merges() {
+    return {get_next()};
+}
 }
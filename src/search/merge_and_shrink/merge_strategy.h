@@ -2,6 +2,7 @@
 #define MERGE_AND_SHRINK_MERGE_STRATEGY_H
 
 #include <utility>
+#include <vector>
 
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
@@ -45,6 +46,15 @@ public:
     explicit MergeStrategy(const FactoredTransitionSystem &fts);
     virtual ~MergeStrategy() = default;
     virtual std::pair<int, int> get_next() = 0;
+    /*
+      Return merges of pairwise disjoint pairs of transition systems that
+      are independent of each other. The caller must perform all of them
+      before asking for further merges, storing the result of the i-th
+      merge at index fts.get_size() + i (as before the merges). A merge
+      strategy is either used with get_next or with get_next_merges.
+      The default implementation only returns the merge of get_next.
+    */
+    virtual std::vector<std::pair<int, int>> get_next_merges();
 };
 }
 
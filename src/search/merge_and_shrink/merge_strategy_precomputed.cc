@@ -21,4 +21,9 @@ pair<int, int> MergeStrategyPrecomputed::get_next() {
     assert(fts.is_active(next_merge.second));
     return next_merge;
 }
+
+vector<pair<int, int>> MergeStrategyPrecomputed::get_next_merges() {
+    assert(!merge_tree->done());
+    return merge_tree->get_independent_merges(fts.get_size());
+}
 }
@@ -6,6 +6,8 @@
 #include "merge_tree_factory.h"
 #include "transition_system.h"
 
+#include "../task_proxy.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -26,7 +28,8 @@ MergeStrategySCCs::MergeStrategySCCs(
       merge_selector(merge_selector),
       non_singleton_cg_sccs(move(non_singleton_cg_sccs)),
       indices_of_merged_sccs(move(indices_of_merged_sccs)),
-      current_merge_tree(nullptr) {
+      current_merge_tree(nullptr),
+      started_scc_merges(false) {
 }
 
 MergeStrategySCCs::~MergeStrategySCCs() {
@@ -83,4 +86,82 @@ pair<int, int> MergeStrategySCCs::get_next() {
     }
     return next_pair;
 }
+
+void MergeStrategySCCs::start_scc_merge(vector<int> &&ts_indices, int position) {
+    SCCMerge scc_merge;
+    if (merge_tree_factory) {
+        scc_merge.merge_tree = merge_tree_factory->compute_merge_tree(
+            task_proxy, fts, ts_indices);
+    }
+    scc_merge.ts_indices = move(ts_indices);
+    scc_merge.position = position;
+    scc_merges.push_back(move(scc_merge));
+}
+
+vector<pair<int, int>> MergeStrategySCCs::get_next_merges() {
+    assert(current_ts_indices.empty());
+    if (!started_scc_merges) {
+        started_scc_merges = true;
+        /*
+          indices_of_merged_sccs contains the indices that the merged SCCs
+          get when merging them one after the other. Since we merge them
+          concurrently, we replace these indices (which exceed the indices
+          of the atomic factors) when the SCCs have been merged.
+        */
+        int num_vars = task_proxy.get_variables().size();
+        size_t scc_index = 0;
+        for (size_t pos = 0; pos < indices_of_merged_sccs.size(); ++pos) {
+            if (indices_of_merged_sccs[pos] >= num_vars) {
+                start_scc_merge(move(non_singleton_cg_sccs[scc_index]), pos);
+                ++scc_index;
+            }
+        }
+        assert(scc_index == non_singleton_cg_sccs.size());
+        non_singleton_cg_sccs.clear();
+    }
+
+    // Collect the indices of the SCCs that have been merged entirely.
+    for (auto it = scc_merges.begin(); it != scc_merges.end();) {
+        if (it->ts_indices.size() == 1) {
+            assert(it->position != -1);
+            indices_of_merged_sccs[it->position] = it->ts_indices.front();
+            it = scc_merges.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (scc_merges.empty()) {
+        assert(indices_of_merged_sccs.size() > 1);
+        start_scc_merge(move(indices_of_merged_sccs), -1);
+        indices_of_merged_sccs.clear();
+    }
+
+    vector<pair<int, int>> merges;
+    int merged_ts_index = fts.get_size();
+    for (SCCMerge &scc_merge : scc_merges) {
+        vector<pair<int, int>> scc_next_merges;
+        if (scc_merge.merge_tree) {
+            scc_next_merges =
+                scc_merge.merge_tree->get_independent_merges(merged_ts_index);
+        } else {
+            assert(merge_selector);
+            scc_next_merges.push_back(
+                merge_selector->select_merge(fts, scc_merge.ts_indices));
+        }
+        vector<int> &ts_indices = scc_merge.ts_indices;
+        for (const pair<int, int> &merge : scc_next_merges) {
+            ts_indices.erase(
+                remove_if(ts_indices.begin(), ts_indices.end(),
+                          [&](int index) {
+                              return index == merge.first ||
+                              index == merge.second;
+                          }),
+                ts_indices.end());
+            ts_indices.push_back(merged_ts_index);
+            ++merged_ts_index;
+            merges.push_back(merge);
+        }
+    }
+    return merges;
+}
 }
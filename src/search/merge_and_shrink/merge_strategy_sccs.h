@@ -22,6 +22,22 @@ class MergeStrategySCCs : public MergeStrategy {
     // Active "merge strategies" while merging a set of indices
     std::unique_ptr<MergeTree> current_merge_tree;
     std::vector<int> current_ts_indices;
+
+    /*
+      Used by get_next_merges, which merges all SCCs concurrently: the
+      current indices of an SCC, its merge tree (if using a merge tree
+      factory) and the position of its merged index in
+      indices_of_merged_sccs (-1 for the final set of indices).
+    */
+    struct SCCMerge {
+        std::vector<int> ts_indices;
+        std::unique_ptr<MergeTree> merge_tree;
+        int position;
+    };
+    std::vector<SCCMerge> scc_merges;
+    bool started_scc_merges;
+
+    void start_scc_merge(std::vector<int> &&ts_indices, int position);
 public:
     MergeStrategySCCs(
         const FactoredTransitionSystem &fts,
@@ -32,6 +48,7 @@ public:
         std::vector<int> indices_of_merged_sccs);
     virtual ~MergeStrategySCCs() override;
     virtual std::pair<int, int> get_next() override;
+    virtual std::vector<std::pair<int, int>> get_next_merges() override;
 };
 }
 
@@ -64,6 +64,19 @@ MergeTreeNode *MergeTreeNode::get_left_most_sibling() {
     return right_child->get_left_most_sibling();
 }
 
+void MergeTreeNode::collect_sibling_leaf_parents(vector<MergeTreeNode *> &nodes) {
+    if (has_two_leaf_children()) {
+        nodes.push_back(this);
+        return;
+    }
+    if (left_child && !left_child->is_leaf()) {
+        left_child->collect_sibling_leaf_parents(nodes);
+    }
+    if (right_child && !right_child->is_leaf()) {
+        right_child->collect_sibling_leaf_parents(nodes);
+    }
+}
+
 pair<int, int> MergeTreeNode::erase_children_and_set_index(int new_index) {
     assert(has_two_leaf_children());
     int left_child_index = left_child->ts_index;
@@ -148,6 +161,18 @@ pair<int, int> MergeTree::get_next_merge(int new_index) {
     return next_merge->erase_children_and_set_index(new_index);
 }
 
+vector<pair<int, int>> MergeTree::get_independent_merges(int first_new_index) {
+    vector<MergeTreeNode *> nodes;
+    root->collect_sibling_leaf_parents(nodes);
+    vector<pair<int, int>> merges;
+    merges.reserve(nodes.size());
+    int new_index = first_new_index;
+    for (MergeTreeNode *node : nodes) {
+        merges.push_back(node->erase_children_and_set_index(new_index++));
+    }
+    return merges;
+}
+
 pair<MergeTreeNode *, MergeTreeNode *> MergeTree::get_parents_of_ts_indices(
     const pair<int, int> &ts_indices, int new_index) {
     int ts_index1 = ts_indices.first;
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace utils {
 class LogProxy;
@@ -31,6 +32,8 @@ struct MergeTreeNode {
     ~MergeTreeNode();
 
     MergeTreeNode *get_left_most_sibling();
+    // Collect all nodes with two leaf children from left to right.
+    void collect_sibling_leaf_parents(std::vector<MergeTreeNode *> &nodes);
     std::pair<int, int> erase_children_and_set_index(int new_index);
     // Find the parent node for the given index.
     MergeTreeNode *get_parent_of_ts_index(int index);
@@ -97,6 +100,13 @@ public:
         UpdateOption update_option);
     ~MergeTree();
     std::pair<int, int> get_next_merge(int new_index);
+    /*
+      Return the merges of all sibling leaf pairs from left to right and
+      update their parents to represent the merged transition systems,
+      which get the indices first_new_index, first_new_index + 1, etc.
+      No two of these merges share a transition system.
+    */
+    std::vector<std::pair<int, int>> get_independent_merges(int first_new_index);
     /*
       Inform the merge tree about a merge that happened independently of
       using the tree's method get_next_merge.
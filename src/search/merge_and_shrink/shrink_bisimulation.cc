@@ -8,13 +8,14 @@
 #include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
 #include <algorithm>
 #include <cassert>
-#include <limits>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <unordered_map>
 
 using namespace std;
@@ -30,72 +31,37 @@ namespace merge_and_shrink {
    sorted and uniquified. */
 using SuccessorSignature = vector<pair<int, int>>;
 
+// Smaller groups are sorted by a single thread.
+static const size_t MIN_STATES_FOR_PARALLEL_SORT = 10000;
+
 /*
-  As we use SENTINEL numeric_limits<int>::max() as a sentinel signature and
-  irrelevant states have a distance of INF = numeric_limits<int>::max(), we
-  use INF - 1 as the distance value for all irrelevant states. This guarantees
-  that also irrelevant states are always ordered before the sentinel.
+  The transitions that bisimulation considers, in compressed sparse row
+  form: the successors of state s are the pairs (label group ID, target)
+  at positions succ_begin[s], ..., succ_begin[s + 1] - 1 of successors,
+  and its predecessors are stored analogously.
 */
-const int SENTINEL = numeric_limits<int>::max();
-const int IRRELEVANT = SENTINEL - 1;
+struct BisimulationGraph {
+    vector<int> succ_begin;
+    vector<pair<int, int>> successors;
+    vector<int> pred_begin;
+    vector<int> predecessors;
+};
 
 /*
-  The following class encodes all we need to know about a state for
-  bisimulation: its h value, which equivalence class ("group") it currently
-  belongs to, its successor signature (see above), and what the original
-  state is.
+  Groups never contain states with different h values, and goal states
+  form their own group. Groups are processed in the order of this value
+  and then by ID.
 */
-
-struct Signature {
-    int h_and_goal; // -1 for goal states; h value for non-goal states
-    int group;
-    SuccessorSignature succ_signature;
-    int state;
-
-    Signature(int h, bool is_goal, int group_,
-              const SuccessorSignature &succ_signature_,
-              int state_)
-        : group(group_), succ_signature(succ_signature_), state(state_) {
-        if (is_goal) {
-            assert(h == 0);
-            h_and_goal = -1;
-        } else {
-            h_and_goal = h;
-        }
-    }
-
-    bool operator<(const Signature &other) const {
-        if (h_and_goal != other.h_and_goal)
-            return h_and_goal < other.h_and_goal;
-        if (group != other.group)
-            return group < other.group;
-        if (succ_signature != other.succ_signature)
-            return succ_signature < other.succ_signature;
-        return state < other.state;
-    }
-
-    void dump(utils::LogProxy &log) const {
-        if (log.is_at_least_debug()) {
-            log << "Signature(h_and_goal = " << h_and_goal
-                << ", group = " << group
-                << ", state = " << state
-                << ", succ_sig = [";
-            for (size_t i = 0; i < succ_signature.size(); ++i) {
-                if (i)
-                    log << ", ";
-                log << "(" << succ_signature[i].first
-                    << "," << succ_signature[i].second
-                    << ")";
-            }
-            log << "])" << endl;
-        }
-    }
-};
+static int get_h_and_goal(
+    const TransitionSystem &ts, const Distances &distances, int state) {
+    return ts.is_goal_state(state) ? -1 : distances.get_goal_distance(state);
+}
 
 
 ShrinkBisimulation::ShrinkBisimulation(const plugins::Options &opts)
     : greedy(opts.get<bool>("greedy")),
-      at_limit(opts.get<AtLimit>("at_limit")) {
+      at_limit(opts.get<AtLimit>("at_limit")),
+      num_threads(opts.get<int>("num_threads")) {
 }
 
 int ShrinkBisimulation::initialize_groups(
@@ -117,9 +83,6 @@ int ShrinkBisimulation::initialize_groups(
     int num_groups = 1; // Group 0 is for goal states.
     for (int state = 0; state < ts.get_size(); ++state) {
         int h = distances.get_goal_distance(state);
-        if (h == INF) {
-            h = IRRELEVANT;
-        }
         if (ts.is_goal_state(state)) {
             assert(h == 0);
             state_to_group[state] = 0;
@@ -136,32 +99,49 @@ int ShrinkBisimulation::initialize_groups(
     return num_groups;
 }
 
-void ShrinkBisimulation::compute_signatures(
+BisimulationGraph ShrinkBisimulation::compute_graph(
     const TransitionSystem &ts,
-    const Distances &distances,
-    vector<Signature> &signatures,
-    const vector<int> &state_to_group) const {
-    assert(signatures.empty());
-
-    // Step 1: Compute bare state signatures (without transition information).
-    signatures.push_back(Signature(-2, false, -1, SuccessorSignature(), -1));
-    for (int state = 0; state < ts.get_size(); ++state) {
-        int h = distances.get_goal_distance(state);
-        if (h == INF) {
-            h = IRRELEVANT;
+    const Distances &distances) const {
+    int num_states = ts.get_size();
+    auto is_considered = [&](const LocalLabelInfo &local_label_info,
+                             const Transition &transition) {
+            if (!greedy) {
+                return true;
+            }
+            int src_h = distances.get_goal_distance(transition.src);
+            int target_h = distances.get_goal_distance(transition.target);
+            if (src_h == INF || target_h == INF) {
+                // We skip transitions connected to an irrelevant state.
+                return false;
+            }
+            int cost = local_label_info.get_cost();
+            assert(target_h + cost >= src_h);
+            return target_h + cost == src_h;
+        };
+
+    BisimulationGraph graph;
+    graph.succ_begin.assign(num_states + 1, 0);
+    graph.pred_begin.assign(num_states + 1, 0);
+    for (const LocalLabelInfo &local_label_info : ts) {
+        for (const Transition &transition : local_label_info.get_transitions()) {
+            if (is_considered(local_label_info, transition)) {
+                ++graph.succ_begin[transition.src + 1];
+                ++graph.pred_begin[transition.target + 1];
+            }
         }
-        Signature signature(h, ts.is_goal_state(state),
-                            state_to_group[state], SuccessorSignature(),
-                            state);
-        signatures.push_back(signature);
     }
-    signatures.push_back(Signature(SENTINEL, false, -1, SuccessorSignature(), -1));
+    for (int state = 0; state < num_states; ++state) {
+        graph.succ_begin[state + 1] += graph.succ_begin[state];
+        graph.pred_begin[state + 1] += graph.pred_begin[state];
+    }
+    graph.successors.resize(graph.succ_begin[num_states]);
+    graph.predecessors.resize(graph.pred_begin[num_states]);
+    vector<int> next_succ(graph.succ_begin.begin(), graph.succ_begin.end() - 1);
+    vector<int> next_pred(graph.pred_begin.begin(), graph.pred_begin.end() - 1);
 
-    // Step 2: Add transition information.
-    int label_group_counter = 0;
     /*
       Note that the final result of the bisimulation may depend on the
-      order in which transitions are considered below.
+      order in which label groups are numbered below.
 
       If label groups were sorted (every group by increasing label numbers,
       groups by smallest label number), then the following configuration
@@ -183,56 +163,19 @@ void ShrinkBisimulation::compute_signatures(
                                                 threshold=1),
             label_reduction=exact(before_shrinking=true,before_merging=false)))
     */
+    int label_group_counter = 0;
     for (const LocalLabelInfo &local_label_info : ts) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
-        for (const Transition &transition : transitions) {
-            assert(signatures[transition.src + 1].state == transition.src);
-            bool skip_transition = false;
-            if (greedy) {
-                int src_h = distances.get_goal_distance(transition.src);
-                int target_h = distances.get_goal_distance(transition.target);
-                if (src_h == INF || target_h == INF) {
-                    // We skip transitions connected to an irrelevant state.
-                    skip_transition = true;
-                } else {
-                    int cost = local_label_info.get_cost();
-                    assert(target_h + cost >= src_h);
-                    skip_transition = (target_h + cost != src_h);
-                }
-            }
-            if (!skip_transition) {
-                int target_group = state_to_group[transition.target];
-                assert(target_group != -1 && target_group != SENTINEL);
-                signatures[transition.src + 1].succ_signature.push_back(
-                    make_pair(label_group_counter, target_group));
+        for (const Transition &transition : local_label_info.get_transitions()) {
+            if (is_considered(local_label_info, transition)) {
+                graph.successors[next_succ[transition.src]++] =
+                    make_pair(label_group_counter, transition.target);
+                graph.predecessors[next_pred[transition.target]++] =
+                    transition.src;
             }
         }
         ++label_group_counter;
     }
-
-    /* Step 3: Canonicalize the representation. The resulting
-       signatures must satisfy the following properties:
-
-       1. Signature::operator< defines a total order with the correct
-          sentinels at the start and end. The signatures vector is
-          sorted according to that order.
-       2. Goal states come before non-goal states, and low-h states come
-          before high-h states.
-       3. States that currently fall into the same group form contiguous
-          subsequences.
-       4. Two signatures compare equal according to Signature::operator<
-          iff we don't want to distinguish their states in the current
-          bisimulation round.
-     */
-
-    for (size_t i = 0; i < signatures.size(); ++i) {
-        SuccessorSignature &succ_sig = signatures[i].succ_signature;
-        ::sort(succ_sig.begin(), succ_sig.end());
-        succ_sig.erase(::unique(succ_sig.begin(), succ_sig.end()),
-                       succ_sig.end());
-    }
-
-    ::sort(signatures.begin(), signatures.end());
+    return graph;
 }
 
 StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
@@ -244,61 +187,126 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
     int num_states = ts.get_size();
 
     vector<int> state_to_group(num_states);
-    vector<Signature> signatures;
-    signatures.reserve(num_states + 2);
-
     int num_groups = initialize_groups(ts, distances, state_to_group);
     // log << "number of initial groups: " << num_groups << endl;
 
     // TODO: We currently violate this; see issue250
     // assert(num_groups <= target_size);
 
-    bool stable = false;
+    vector<vector<int>> group_to_states(num_groups);
+    for (int state = 0; state < num_states; ++state) {
+        group_to_states[state_to_group[state]].push_back(state);
+    }
+    BisimulationGraph graph = compute_graph(ts, distances);
+    vector<SuccessorSignature> signatures(num_states);
+    auto compute_signature = [&](int state) {
+            SuccessorSignature &succ_sig = signatures[state];
+            succ_sig.clear();
+            for (int i = graph.succ_begin[state];
+                 i < graph.succ_begin[state + 1]; ++i) {
+                const pair<int, int> &successor = graph.successors[i];
+                succ_sig.emplace_back(
+                    successor.first, state_to_group[successor.second]);
+            }
+            ::sort(succ_sig.begin(), succ_sig.end());
+            succ_sig.erase(::unique(succ_sig.begin(), succ_sig.end()),
+                           succ_sig.end());
+        };
+    auto has_smaller_signature = [&](int state1, int state2) {
+            const SuccessorSignature &sig1 = signatures[state1];
+            const SuccessorSignature &sig2 = signatures[state2];
+            if (sig1 != sig2) {
+                return sig1 < sig2;
+            }
+            return state1 < state2;
+        };
+    auto get_group_h_and_goal = [&](int group) {
+            return get_h_and_goal(ts, distances, group_to_states[group].front());
+        };
+
+    /*
+      A group can only split if the signature of one of its states has
+      changed, i.e., if one of its states has a successor whose group has
+      changed in the previous round. Therefore, in every round we only
+      recompute the signatures of such "affected" groups, starting with
+      all groups. Groups whose signatures do not change do not split, so
+      skipping them leads to the same result and the same group numbers as
+      refining all groups in every round.
+    */
+    vector<int> affected_groups(num_groups);
+    iota(affected_groups.begin(), affected_groups.end(), 0);
+    vector<bool> is_affected;
+    vector<int> affected_states;
+    vector<int> changed_states;
     bool stop_requested = false;
-    while (!stable && !stop_requested && num_groups < target_size) {
-        stable = true;
-
-        signatures.clear();
-        compute_signatures(ts, distances, signatures, state_to_group);
-
-        // Verify size of signatures and presence of sentinels.
-        assert(static_cast<int>(signatures.size()) == num_states + 2);
-        assert(signatures[0].h_and_goal == -2);
-        assert(signatures[num_states + 1].h_and_goal == SENTINEL);
-
-        int sig_start = 1; // Skip over initial sentinel.
-        while (true) {
-            int h_and_goal = signatures[sig_start].h_and_goal;
-            if (h_and_goal == SENTINEL) {
-                // We have hit the end sentinel.
-                assert(sig_start + 1 == static_cast<int>(signatures.size()));
-                break;
+    while (!affected_groups.empty() && !stop_requested &&
+           num_groups < target_size) {
+        ::sort(affected_groups.begin(), affected_groups.end(),
+               [&](int group1, int group2) {
+                   int key1 = get_group_h_and_goal(group1);
+                   int key2 = get_group_h_and_goal(group2);
+                   return key1 < key2 || (key1 == key2 && group1 < group2);
+               });
+
+        affected_states.clear();
+        for (int group : affected_groups) {
+            affected_states.insert(
+                affected_states.end(),
+                group_to_states[group].begin(), group_to_states[group].end());
+        }
+        utils::parallel_for(
+            affected_states.size(), num_threads,
+            [&](int i) {
+                compute_signature(affected_states[i]);
+            });
+        /*
+          Order the states of each group by their signatures. Large groups
+          are sorted with several threads, the others concurrently.
+        */
+        vector<int> small_groups;
+        for (int group : affected_groups) {
+            vector<int> &states = group_to_states[group];
+            if (num_threads > 1 &&
+                states.size() >= MIN_STATES_FOR_PARALLEL_SORT) {
+                utils::parallel_sort(
+                    states.begin(), states.end(), has_smaller_signature,
+                    num_threads);
+            } else {
+                small_groups.push_back(group);
             }
+        }
+        utils::parallel_for(
+            small_groups.size(), num_threads,
+            [&](int i) {
+                vector<int> &states = group_to_states[small_groups[i]];
+                ::sort(states.begin(), states.end(), has_smaller_signature);
+            });
+
+        changed_states.clear();
+        size_t layer_start = 0;
+        while (layer_start < affected_groups.size()) {
+            int h_and_goal = get_group_h_and_goal(affected_groups[layer_start]);
 
             // Compute the number of groups needed after splitting.
             int num_old_groups = 0;
             int num_new_groups = 0;
-            int sig_end;
-            for (sig_end = sig_start; true; ++sig_end) {
-                if (signatures[sig_end].h_and_goal != h_and_goal) {
+            size_t layer_end;
+            for (layer_end = layer_start; layer_end < affected_groups.size();
+                 ++layer_end) {
+                int group = affected_groups[layer_end];
+                if (get_group_h_and_goal(group) != h_and_goal) {
                     break;
                 }
-
-                const Signature &prev_sig = signatures[sig_end - 1];
-                const Signature &curr_sig = signatures[sig_end];
-
-                if (sig_end == sig_start) {
-                    assert(prev_sig.group != curr_sig.group);
-                }
-
-                if (prev_sig.group != curr_sig.group) {
-                    ++num_old_groups;
-                    ++num_new_groups;
-                } else if (prev_sig.succ_signature != curr_sig.succ_signature) {
-                    ++num_new_groups;
+                const vector<int> &states = group_to_states[group];
+                ++num_old_groups;
+                ++num_new_groups;
+                for (size_t i = 1; i < states.size(); ++i) {
+                    if (signatures[states[i - 1]] != signatures[states[i]]) {
+                        ++num_new_groups;
+                    }
                 }
             }
-            assert(sig_end > sig_start);
+            assert(layer_end > layer_start);
 
             if (at_limit == AtLimit::RETURN &&
                 num_groups - num_old_groups + num_new_groups > target_size) {
@@ -310,31 +318,48 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
                 break;
             } else if (num_new_groups != num_old_groups) {
                 // Split into new groups.
-                stable = false;
-
-                int new_group_no = -1;
-                for (int i = sig_start; i < sig_end; ++i) {
-                    const Signature &prev_sig = signatures[i - 1];
-                    const Signature &curr_sig = signatures[i];
-
-                    if (prev_sig.group != curr_sig.group) {
-                        // Start first group of a block; keep old group no.
-                        new_group_no = curr_sig.group;
-                    } else if (prev_sig.succ_signature
-                               != curr_sig.succ_signature) {
-                        new_group_no = num_groups++;
-                        assert(num_groups <= target_size);
+                for (size_t j = layer_start; j < layer_end; ++j) {
+                    int group = affected_groups[j];
+                    vector<int> states = move(group_to_states[group]);
+                    // The first new group of a block keeps the old group no.
+                    int new_group_no = group;
+                    group_to_states[group].push_back(states[0]);
+                    for (size_t i = 1; i < states.size(); ++i) {
+                        int state = states[i];
+                        if (signatures[states[i - 1]] != signatures[state]) {
+                            new_group_no = num_groups++;
+                            assert(num_groups <= target_size);
+                            group_to_states.emplace_back();
+                        }
+                        if (new_group_no != group) {
+                            state_to_group[state] = new_group_no;
+                            changed_states.push_back(state);
+                        }
+                        group_to_states[new_group_no].push_back(state);
+                        if (num_groups == target_size)
+                            break;
                     }
-
-                    assert(new_group_no != -1);
-                    state_to_group[curr_sig.state] = new_group_no;
                     if (num_groups == target_size)
                         break;
                 }
                 if (num_groups == target_size)
                     break;
             }
-            sig_start = sig_end;
+            layer_start = layer_end;
+        }
+
+        // Collect the groups of the predecessors of all changed states.
+        is_affected.assign(num_groups, false);
+        affected_groups.clear();
+        for (int state : changed_states) {
+            for (int i = graph.pred_begin[state];
+                 i < graph.pred_begin[state + 1]; ++i) {
+                int group = state_to_group[graph.predecessors[i]];
+                if (!is_affected[group]) {
+                    is_affected[group] = true;
+                    affected_groups.push_back(group);
+                }
+            }
         }
     }
 
@@ -342,6 +367,7 @@ StateEquivalenceRelation ShrinkBisimulation::compute_equivalence_relation(
        relation since this is one of the code parts relevant to peak
        memory. */
     utils::release_vector_memory(signatures);
+    utils::release_vector_memory(group_to_states);
 
     // Generate final result.
     StateEquivalenceRelation equivalence_relation;
@@ -364,6 +390,7 @@ string ShrinkBisimulation::name() const {
 void ShrinkBisimulation::dump_strategy_specific_options(utils::LogProxy &log) const {
     if (log.is_at_least_normal()) {
         log << "Bisimulation type: " << (greedy ? "greedy" : "exact") << endl;
+        log << "Number of threads: " << num_threads << endl;
         log << "At limit: ";
         if (at_limit == AtLimit::RETURN) {
             log << "return";
@@ -397,6 +424,16 @@ public:
         add_option<AtLimit>(
             "at_limit",
             "what to do when the size limit is hit", "return");
+        add_option<int>(
+            "num_threads",
+            "number of threads used for computing and sorting the signatures "
+            "of states. Shrinking that runs concurrently with other "
+            "shrinking (in the merge-and-shrink main loop or in the trial "
+            "merges of sf_miasm) uses a single thread. The result does not "
+            "depend on this number.",
+            "1",
+            plugins::Bounds("1", "infinity"));
+        mark_result_independent("num_threads");
 
         document_note(
             "shrink_bisimulation(greedy=true)",
@@ -8,7 +8,7 @@ class Options;
 }
 
 namespace merge_and_shrink {
-struct Signature;
+struct BisimulationGraph;
 
 enum class AtLimit {
     RETURN,
@@ -18,6 +18,7 @@ enum class AtLimit {
 class ShrinkBisimulation : public ShrinkStrategy {
     const bool greedy;
     const AtLimit at_limit;
+    const int num_threads;
 
     void compute_abstraction(
         const TransitionSystem &ts,
@@ -30,11 +31,9 @@ class ShrinkBisimulation : public ShrinkStrategy {
         const Distances &distances,
         std::vector<int> &state_to_group) const;
 
-    void compute_signatures(
+    BisimulationGraph compute_graph(
         const TransitionSystem &ts,
-        const Distances &distances,
-        std::vector<Signature> &signatures,
-        const std::vector<int> &state_to_group) const;
+        const Distances &distances) const;
 protected:
     virtual void dump_strategy_specific_options(utils::LogProxy &log) const override;
     virtual std::string name() const override;
@@ -54,6 +53,10 @@ public:
     virtual bool requires_goal_distances() const override {
         return true;
     }
+
+    virtual bool can_shrink_concurrently() const override {
+        return true;
+    }
 };
 }
 
@@ -43,6 +43,15 @@ public:
         utils::LogProxy &log) const = 0;
     virtual bool requires_init_distances() const = 0;
     virtual bool requires_goal_distances() const = 0;
+    /*
+      Return true if compute_equivalence_relation may be called concurrently
+      for different transition systems without changing the results, i.e.,
+      if it neither modifies nor depends on shared state such as a random
+      number generator.
+    */
+    virtual bool can_shrink_concurrently() const {
+        return false;
+    }
 
     void dump_options(utils::LogProxy &log) const;
     std::string get_name() const;
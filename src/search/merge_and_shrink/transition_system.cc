@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <limits>
 #include <set>
 #include <sstream>
 #include <string>
@@ -24,6 +25,131 @@ ostream &operator<<(ostream &os, const Transition &trans) {
     return os;
 }
 
+static int get_encoded_size(int number) {
+    int size = 1;
+    while (number >= 128) {
+        number >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+/*
+  Call handle_number for all numbers of the encoding of the rows given by
+  for_each_row. The first target of a row is encoded like a difference to
+  the (non-existing) target -1.
+*/
+template<typename ForEachRow, typename HandleNumber>
+static void for_each_encoded_number(
+    const ForEachRow &for_each_row, const HandleNumber &handle_number) {
+    int prev_src = 0;
+    for_each_row(
+        [&](int src, const vector<int> &targets) {
+            assert(!targets.empty());
+            assert(src >= prev_src);
+            handle_number(src - prev_src);
+            handle_number(targets.size() - 1);
+            int prev_target = -1;
+            for (int target : targets) {
+                assert(target > prev_target);
+                handle_number(target - prev_target - 1);
+                prev_target = target;
+            }
+            prev_src = src;
+        });
+}
+
+template<typename ForEachRow>
+void CompressedTransitions::encode(const ForEachRow &for_each_row) {
+    /*
+      Compute the exact number of bytes first. Growing the vector instead
+      would temporarily need much more memory than the result.
+    */
+    size_t num_bytes = 0;
+    for_each_encoded_number(
+        for_each_row,
+        [&](int number) {
+            num_bytes += get_encoded_size(number);
+        });
+    data.reserve(num_bytes);
+    for_each_encoded_number(
+        for_each_row,
+        [&](int number) {
+            append_number(number);
+        });
+    assert(data.size() == num_bytes);
+}
+
+CompressedTransitions::CompressedTransitions(
+    const vector<Transition> &transitions)
+    : num_transitions(transitions.size()) {
+    assert(utils::is_sorted_unique(transitions));
+    vector<int> targets;
+    encode(
+        [&](const auto &add_row) {
+            size_t i = 0;
+            while (i < transitions.size()) {
+                int src = transitions[i].src;
+                targets.clear();
+                for (; i < transitions.size() && transitions[i].src == src; ++i) {
+                    targets.push_back(transitions[i].target);
+                }
+                add_row(src, targets);
+            }
+        });
+}
+
+// Group the transitions by source state.
+static vector<pair<int, vector<int>>> compute_rows(
+    const CompressedTransitions &transitions) {
+    vector<pair<int, vector<int>>> rows;
+    for (const Transition &transition : transitions) {
+        if (rows.empty() || rows.back().first != transition.src) {
+            rows.emplace_back(transition.src, vector<int>());
+        }
+        rows.back().second.push_back(transition.target);
+    }
+    return rows;
+}
+
+CompressedTransitions CompressedTransitions::compute_product(
+    const CompressedTransitions &transitions1,
+    const CompressedTransitions &transitions2,
+    int num_states2) {
+    assert(transitions1.empty() || transitions2.empty() ||
+           transitions1.size() <=
+           static_cast<size_t>(numeric_limits<int>::max()) / transitions2.size());
+    vector<pair<int, vector<int>>> rows1 = compute_rows(transitions1);
+    vector<pair<int, vector<int>>> rows2 = compute_rows(transitions2);
+    CompressedTransitions product;
+    product.num_transitions = transitions1.size() * transitions2.size();
+    vector<int> targets;
+    product.encode(
+        [&](const auto &add_row) {
+            for (const auto &[src1, targets1] : rows1) {
+                for (const auto &[src2, targets2] : rows2) {
+                    targets.clear();
+                    for (int target1 : targets1) {
+                        for (int target2 : targets2) {
+                            targets.push_back(target1 * num_states2 + target2);
+                        }
+                    }
+                    add_row(src1 * num_states2 + src2, targets);
+                }
+            }
+        });
+    return product;
+}
+
+void CompressedTransitions::append_number(int number) {
+    assert(number >= 0);
+    while (number >= 128) {
+        data.push_back(static_cast<uint8_t>((number & 127) | 128));
+        number >>= 7;
+    }
+    data.push_back(static_cast<uint8_t>(number));
+}
+
 void LocalLabelInfo::add_label(int label, int label_cost) {
     label_group.push_back(label);
     if (label_cost != -1) {
@@ -59,7 +185,7 @@ void LocalLabelInfo::recompute_cost(const Labels &labels) {
     }
 }
 
-void LocalLabelInfo::replace_transitions(vector<Transition> &&new_transitions) {
+void LocalLabelInfo::replace_transitions(CompressedTransitions &&new_transitions) {
     transitions = move(new_transitions);
     assert(is_consistent());
 }
@@ -79,14 +205,13 @@ void LocalLabelInfo::merge_local_label_info(LocalLabelInfo &local_label_info) {
 }
 
 void LocalLabelInfo::deactivate() {
-    utils::release_vector_memory(transitions);
+    transitions = CompressedTransitions();
     utils::release_vector_memory(label_group);
     cost = -1;
 }
 
 bool LocalLabelInfo::is_consistent() const {
-    return utils::is_sorted_unique(label_group) &&
-           utils::is_sorted_unique(transitions);
+    return utils::is_sorted_unique(label_group);
 }
 
 
@@ -210,7 +335,7 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
     LabelGroup dead_labels;
     for (const LocalLabelInfo &local_label_info : ts1) {
         const LabelGroup &group1 = local_label_info.get_label_group();
-        const vector<Transition> &transitions1 = local_label_info.get_transitions();
+        const CompressedTransitions &transitions1 = local_label_info.get_transitions();
 
         // Distribute the labels of this group among the "buckets"
         // corresponding to the groups of ts2.
@@ -224,33 +349,20 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
 
         // Now create the new groups together with their transitions.
         for (auto &bucket : buckets) {
-            const vector<Transition> &transitions2 =
+            const CompressedTransitions &transitions2 =
                 ts2.local_label_infos[bucket.first].get_transitions();
 
-            // Create the new transitions for this bucket
-            vector<Transition> new_transitions;
-            if (!transitions1.empty() && !transitions2.empty()
-                && transitions1.size() > new_transitions.max_size() / transitions2.size())
-                utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
-            new_transitions.reserve(transitions1.size() * transitions2.size());
-            for (const Transition &transition1 : transitions1) {
-                int src1 = transition1.src;
-                int target1 = transition1.target;
-                for (const Transition &transition2 : transitions2) {
-                    int src2 = transition2.src;
-                    int target2 = transition2.target;
-                    int src = src1 * multiplier + src2;
-                    int target = target1 * multiplier + target2;
-                    new_transitions.emplace_back(src, target);
-                }
-            }
-
             // Create a new group if the transitions are not empty
             LabelGroup &new_labels = bucket.second;
-            if (new_transitions.empty()) {
+            if (transitions1.empty() || transitions2.empty()) {
                 dead_labels.insert(dead_labels.end(), new_labels.begin(), new_labels.end());
             } else {
-                sort(new_transitions.begin(), new_transitions.end());
+                if (transitions1.size() >
+                    static_cast<size_t>(numeric_limits<int>::max()) / transitions2.size())
+                    utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+                CompressedTransitions new_transitions =
+                    CompressedTransitions::compute_product(
+                        transitions1, transitions2, multiplier);
                 sort(new_labels.begin(), new_labels.end());
                 int new_local_label = local_label_infos.size();
                 int cost = INF;
@@ -258,7 +370,8 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
                     cost = min(ts1.labels.get_label_cost(label), cost);
                     label_to_local_label[label] = new_local_label;
                 }
-                local_label_infos.emplace_back(move(new_labels), move(new_transitions), cost);
+                local_label_infos.emplace_back(
+                    move(new_labels), move(new_transitions), cost);
             }
         }
     }
@@ -279,7 +392,7 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
             label_to_local_label[label] = new_local_label;
         }
         // Dead labels have empty transitions
-        local_label_infos.emplace_back(move(dead_labels), vector<Transition>(), cost);
+        local_label_infos.emplace_back(move(dead_labels), CompressedTransitions(), cost);
     }
 
     return utils::make_unique_ptr<TransitionSystem>(
@@ -307,11 +420,11 @@ void TransitionSystem::compute_equivalent_local_labels() {
     for (int local_label1 = 0; local_label1 < num_local_labels;
          ++local_label1) {
         if (local_label_infos[local_label1].is_active()) {
-            const vector<Transition> &transitions1 = local_label_infos[local_label1].get_transitions();
+            const CompressedTransitions &transitions1 = local_label_infos[local_label1].get_transitions();
             for (int local_label2 = local_label1 + 1;
                  local_label2 < num_local_labels; ++local_label2) {
                 if (local_label_infos[local_label2].is_active()) {
-                    const vector<Transition> &transitions2 = local_label_infos[local_label2].get_transitions();
+                    const CompressedTransitions &transitions2 = local_label_infos[local_label2].get_transitions();
                     // Comparing transitions directly works because they are sorted and unique.
                     if (transitions1 == transitions2) {
                         for (int label : local_label_infos[local_label2].get_label_group()) {
@@ -358,7 +471,7 @@ void TransitionSystem::apply_abstraction(
 
     // Update all transitions.
     for (LocalLabelInfo &local_label_info : local_label_infos) {
-        const vector<Transition> &transitions = local_label_info.get_transitions();
+        const CompressedTransitions &transitions = local_label_info.get_transitions();
         if (!transitions.empty()) {
             vector<Transition> new_transitions;
             /*
@@ -378,7 +491,8 @@ void TransitionSystem::apply_abstraction(
                     new_transitions.emplace_back(src, target);
             }
             utils::sort_unique(new_transitions);
-            local_label_info.replace_transitions(move(new_transitions));
+            local_label_info.replace_transitions(
+                CompressedTransitions(new_transitions));
         }
     }
 
@@ -451,7 +565,7 @@ void TransitionSystem::apply_label_reduction(
             for (int old_label : old_labels) {
                 int old_local_label = label_to_local_label[old_label];
                 if (seen_local_labels.insert(old_local_label).second) {
-                    const vector<Transition> &transitions = local_label_infos[old_local_label].get_transitions();
+                    const CompressedTransitions &transitions = local_label_infos[old_local_label].get_transitions();
                     new_label_transitions.insert(new_label_transitions.end(), transitions.begin(), transitions.end());
                 }
                 local_label_to_old_labels[old_local_label].push_back(old_label);
@@ -466,7 +580,9 @@ void TransitionSystem::apply_label_reduction(
             int new_cost = labels.get_label_cost(new_label);
 
             LabelGroup new_label_group = {new_label};
-            local_label_infos.emplace_back(move(new_label_group), move(new_label_transitions), new_cost);
+            local_label_infos.emplace_back(
+                move(new_label_group), CompressedTransitions(new_label_transitions),
+                new_cost);
         }
 
         /*
@@ -598,7 +714,7 @@ void TransitionSystem::dump_dot_graph(utils::LogProxy &log) const {
         }
         for (const LocalLabelInfo &local_label_info : *this) {
             const LabelGroup &label_group = local_label_info.get_label_group();
-            const vector<Transition> &transitions = local_label_info.get_transitions();
+            const CompressedTransitions &transitions = local_label_info.get_transitions();
             for (const Transition &transition : transitions) {
                 int src = transition.src;
                 int target = transition.target;
@@ -622,13 +738,13 @@ void TransitionSystem::dump_labels_and_transitions(utils::LogProxy &log) const {
             const LabelGroup &label_group = local_label_info.get_label_group();
             log << "labels: " << label_group << endl;
             log << "transitions: ";
-            const vector<Transition> &transitions = local_label_info.get_transitions();
-            for (size_t i = 0; i < transitions.size(); ++i) {
-                int src = transitions[i].src;
-                int target = transitions[i].target;
-                if (i != 0)
+            const CompressedTransitions &transitions = local_label_info.get_transitions();
+            bool first = true;
+            for (const Transition &transition : transitions) {
+                if (!first)
                     log << ",";
-                log << src << " -> " << target;
+                first = false;
+                log << transition.src << " -> " << transition.target;
             }
             utils::g_log << "cost: " << local_label_info.get_cost() << endl;
         }
@@ -5,7 +5,10 @@
 
 #include "../utils/collections.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <utility>
@@ -41,28 +44,174 @@ struct Transition {
     }
 };
 
+/*
+  Sorted and unique transitions in a compressed form that only supports
+  iteration in sorted order.
+
+  As in a compressed sparse row representation, the transitions are
+  grouped by their source state. For every source state with outgoing
+  transitions, we store the difference to the previous such source state,
+  the number of its transitions minus one, its first target state and the
+  differences between its consecutive target states minus one. All
+  numbers are stored as variable-length integers with seven bits per
+  byte, so state IDs below 128 (16384) take one (two) bytes instead of
+  four, and the deltas of dense transition systems are usually small
+  even if the number of states is large. Since the encoding is
+  canonical, two transition lists are equal iff their bytes are equal.
+*/
+class CompressedTransitions {
+    std::vector<uint8_t> data;
+    int num_transitions;
+
+    void append_number(int number);
+    /*
+      Encode the transitions given by for_each_row, which must call its
+      argument add_row(src, targets) for all source states in increasing
+      order, with the sorted targets of src.
+    */
+    template<typename ForEachRow>
+    void encode(const ForEachRow &for_each_row);
+public:
+    class const_iterator {
+        const uint8_t *next_byte;
+        int index;
+        int num_transitions;
+        int num_remaining_targets;
+        Transition transition;
+
+        static int read_number(const uint8_t *&byte) {
+            int number = *byte & 127;
+            int shift = 7;
+            while (*byte++ & 128) {
+                number |= (*byte & 127) << shift;
+                shift += 7;
+            }
+            return number;
+        }
+
+        void read_transition() {
+            if (num_remaining_targets > 0) {
+                transition.target += read_number(next_byte) + 1;
+                --num_remaining_targets;
+            } else {
+                transition.src += read_number(next_byte);
+                num_remaining_targets = read_number(next_byte);
+                transition.target = read_number(next_byte);
+            }
+        }
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Transition;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Transition *;
+        using reference = const Transition &;
+
+        const_iterator(
+            const uint8_t *data, int index, int num_transitions)
+            : next_byte(data),
+              index(index),
+              num_transitions(num_transitions),
+              num_remaining_targets(0),
+              transition(0, 0) {
+            if (index < num_transitions) {
+                read_transition();
+            }
+        }
+
+        const Transition &operator*() const {
+            return transition;
+        }
+
+        const Transition *operator->() const {
+            return &transition;
+        }
+
+        const_iterator &operator++() {
+            if (++index < num_transitions) {
+                read_transition();
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++(*this);
+            return copy;
+        }
+
+        bool operator==(const const_iterator &other) const {
+            return index == other.index;
+        }
+
+        bool operator!=(const const_iterator &other) const {
+            return index != other.index;
+        }
+    };
+
+    CompressedTransitions()
+        : num_transitions(0) {
+    }
+    // Requires the given transitions to be sorted and unique.
+    explicit CompressedTransitions(const std::vector<Transition> &transitions);
+
+    /*
+      Compute the transitions of the synchronized product, in which state
+      (s1, s2) has the ID s1 * num_states2 + s2. Since this enumerates the
+      product transitions in sorted order, they are encoded directly
+      without materializing and sorting them.
+    */
+    static CompressedTransitions compute_product(
+        const CompressedTransitions &transitions1,
+        const CompressedTransitions &transitions2,
+        int num_states2);
+
+    const_iterator begin() const {
+        return const_iterator(data.data(), 0, num_transitions);
+    }
+
+    const_iterator end() const {
+        return const_iterator(nullptr, num_transitions, num_transitions);
+    }
+
+    std::size_t size() const {
+        return num_transitions;
+    }
+
+    bool empty() const {
+        return num_transitions == 0;
+    }
+
+    bool operator==(const CompressedTransitions &other) const {
+        return num_transitions == other.num_transitions && data == other.data;
+    }
+
+    bool operator!=(const CompressedTransitions &other) const {
+        return !(*this == other);
+    }
+};
+
 using LabelGroup = std::vector<int>;
 
 /*
   Class for representing groups of labels with equivalent transitions in a
   transition system. See also documentation for TransitionSystem.
 
-  The local label is in a consistent state if label_group and transitions
-  are sorted and unique.
+  The local label is in a consistent state if label_group is sorted and
+  unique. (Compressed transitions are sorted and unique by construction.)
 */
 class LocalLabelInfo {
     // The sorted set of labels with identical transitions in a transition system.
     LabelGroup label_group;
-    std::vector<Transition> transitions;
+    CompressedTransitions transitions;
     // The cost is the minimum cost over all labels in label_group.
     int cost;
 public:
     LocalLabelInfo(
         LabelGroup &&label_group,
-        std::vector<Transition> &&transitions,
+        CompressedTransitions &&transitions,
         int cost)
-        : label_group(move(label_group)),
-          transitions(move(transitions)),
+        : label_group(std::move(label_group)),
+          transitions(std::move(transitions)),
           cost(cost) {
         assert(is_consistent());
     }
@@ -80,7 +229,7 @@ public:
     void remove_labels(const std::vector<int> &old_labels);
 
     void recompute_cost(const Labels &labels);
-    void replace_transitions(std::vector<Transition> &&new_transitions);
+    void replace_transitions(CompressedTransitions &&new_transitions);
 
     /*
       The given local label must have identical transitions. Its labels are
@@ -101,7 +250,7 @@ public:
         return label_group;
     }
 
-    const std::vector<Transition> &get_transitions() const {
+    const CompressedTransitions &get_transitions() const {
         return transitions;
     }
 
@@ -272,6 +421,11 @@ public:
         return goal_states[state];
     }
 
+    // Return the local label representing the given active label.
+    int get_local_label(int label) const {
+        return label_to_local_label[label];
+    }
+
     const std::vector<int> &get_incorporated_variables() const {
         return incorporated_variables;
     }
@@ -6,6 +6,7 @@
 #include "../utils/markup.h"
 
 #include <cmath>
+#include <limits>
 
 using namespace std;
 
@@ -34,6 +35,12 @@ OperatorCountingHeuristic::~OperatorCountingHeuristic() {
 }
 
 int OperatorCountingHeuristic::compute_heuristic(const State &ancestor_state) {
+    return compute_heuristic_with_cutoff(
+        ancestor_state, numeric_limits<int>::max());
+}
+
+int OperatorCountingHeuristic::compute_heuristic_with_cutoff(
+    const State &ancestor_state, int cutoff) {
     State state = convert_ancestor_state(ancestor_state);
     assert(!lp_solver.has_temporary_constraints());
     for (const auto &generator : constraint_generators) {
@@ -43,9 +50,19 @@ int OperatorCountingHeuristic::compute_heuristic(const State &ancestor_state) {
             return DEAD_END;
         }
     }
+    /*
+      When solving LPs, the dual simplex can stop as soon as the objective
+      value is proven to be at least the cutoff.
+    */
+    bool use_cutoff = !use_integer_operator_counts &&
+        cutoff != numeric_limits<int>::max();
+    lp_solver.set_objective_limit(
+        use_cutoff ? cutoff : lp_solver.get_infinity());
     int result;
     lp_solver.solve();
-    if (lp_solver.has_optimal_solution()) {
+    if (use_cutoff && lp_solver.is_objective_limit_reached()) {
+        result = cutoff;
+    } else if (lp_solver.has_optimal_solution()) {
         double epsilon = 0.01;
         double objective_value = lp_solver.get_objective_value();
         result = ceil(objective_value - epsilon);
@@ -21,6 +21,8 @@ class OperatorCountingHeuristic : public Heuristic {
     const bool use_integer_operator_counts;
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual int compute_heuristic_with_cutoff(
+        const State &ancestor_state, int cutoff) override;
 public:
     explicit OperatorCountingHeuristic(const plugins::Options &opts);
     ~OperatorCountingHeuristic();
@@ -5,8 +5,12 @@
 #include "../utils/logging.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/strings.h"
 
+#include <algorithm>
+#include <iomanip>
 #include <limits>
+#include <sstream>
 
 using namespace std;
 
@@ -28,6 +32,19 @@ plugins::Any ConstructContext::get_variable(const string &name) const {
     return variable;
 }
 
+void ConstructContext::set_normalized_variable(
+    const string &name, const string &normalized_config) {
+    normalized_variables[name] = normalized_config;
+}
+
+void ConstructContext::remove_normalized_variable(const string &name) {
+    normalized_variables.erase(name);
+}
+
+string ConstructContext::get_normalized_variable(const string &name) const {
+    return normalized_variables.at(name);
+}
+
 LazyValue::LazyValue(const DecoratedASTNode &node, const ConstructContext &context)
     : context(context), node(node.clone()) {
 }
@@ -113,12 +130,23 @@ plugins::Any DecoratedLetNode::construct(ConstructContext &context) const {
     {
         utils::TraceBlock block(context, "Constructing nested value");
         context.set_variable(variable_name, variable_value);
+        context.set_normalized_variable(
+            variable_name, variable_definition->get_normalized_config(context));
         result = nested_value->construct(context);
         context.remove_variable(variable_name);
+        context.remove_normalized_variable(variable_name);
     }
     return result;
 }
 
+string DecoratedLetNode::get_normalized_config(ConstructContext &context) const {
+    context.set_normalized_variable(
+        variable_name, variable_definition->get_normalized_config(context));
+    string result = nested_value->get_normalized_config(context);
+    context.remove_normalized_variable(variable_name);
+    return result;
+}
+
 void DecoratedLetNode::dump(string indent) const {
     cout << indent << "LET:" << variable_name << " = " << endl;
     indent = "| " + indent;
@@ -138,6 +166,7 @@ plugins::Any DecoratedFunctionCallNode::construct(ConstructContext &context) con
                             unparsed_config);
     plugins::Options opts;
     opts.set_unparsed_config(unparsed_config);
+    opts.set_normalized_config(get_normalized_config(context));
     for (const FunctionArgument &arg : arguments) {
         utils::TraceBlock block(context, "Constructing argument '" + arg.get_key() + "'");
         if (arg.is_lazily_constructed()) {
@@ -149,6 +178,38 @@ plugins::Any DecoratedFunctionCallNode::construct(ConstructContext &context) con
     return feature->construct(opts, context);
 }
 
+static bool affects_result(
+    const plugins::Feature &feature, const string &key) {
+    for (const plugins::ArgumentInfo &argument : feature.get_arguments()) {
+        if (argument.key == key) {
+            return argument.affects_result;
+        }
+    }
+    return true;
+}
+
+string DecoratedFunctionCallNode::get_normalized_config(
+    ConstructContext &context) const {
+    // Arguments are ordered by their keys.
+    vector<pair<string, string>> normalized_arguments;
+    for (const FunctionArgument &arg : arguments) {
+        if (affects_result(*feature, arg.get_key())) {
+            normalized_arguments.emplace_back(
+                arg.get_key(), arg.get_value().get_normalized_config(context));
+        }
+    }
+    sort(normalized_arguments.begin(), normalized_arguments.end());
+    string result = feature->get_key() + "(";
+    for (size_t i = 0; i < normalized_arguments.size(); ++i) {
+        if (i > 0) {
+            result += ",";
+        }
+        result += normalized_arguments[i].first + "=" +
+            normalized_arguments[i].second;
+    }
+    return result + ")";
+}
+
 void DecoratedFunctionCallNode::dump(string indent) const {
     cout << indent << "FUNC:" << feature->get_title()
          << " (returns " << feature->get_type().name() << ")" << endl;
@@ -175,6 +236,17 @@ plugins::Any DecoratedListNode::construct(ConstructContext &context) const {
     return result;
 }
 
+string DecoratedListNode::get_normalized_config(ConstructContext &context) const {
+    string result = "[";
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (i > 0) {
+            result += ",";
+        }
+        result += elements[i]->get_normalized_config(context);
+    }
+    return result + "]";
+}
+
 void DecoratedListNode::dump(string indent) const {
     cout << indent << "LIST:" << endl;
     indent = "| " + indent;
@@ -195,6 +267,13 @@ plugins::Any VariableNode::construct(ConstructContext &context) const {
     return context.get_variable(name);
 }
 
+string VariableNode::get_normalized_config(ConstructContext &context) const {
+    if (!context.has_variable(name)) {
+        context.error("Variable '" + name + "' is not defined.");
+    }
+    return context.get_normalized_variable(name);
+}
+
 void VariableNode::dump(string indent) const {
     cout << indent << "VAR: " << name << endl;
 }
@@ -214,6 +293,10 @@ plugins::Any BoolLiteralNode::construct(ConstructContext &context) const {
     return x;
 }
 
+string BoolLiteralNode::get_normalized_config(ConstructContext &context) const {
+    return plugins::any_cast<bool>(construct(context)) ? "true" : "false";
+}
+
 void BoolLiteralNode::dump(string indent) const {
     cout << indent << "BOOL: " << value << endl;
 }
@@ -267,6 +350,10 @@ plugins::Any IntLiteralNode::construct(ConstructContext &context) const {
     return x * factor;
 }
 
+string IntLiteralNode::get_normalized_config(ConstructContext &context) const {
+    return to_string(plugins::any_cast<int>(construct(context)));
+}
+
 void IntLiteralNode::dump(string indent) const {
     cout << indent << "INT: " << value << endl;
 }
@@ -291,6 +378,13 @@ plugins::Any FloatLiteralNode::construct(ConstructContext &context) const {
     }
 }
 
+string FloatLiteralNode::get_normalized_config(ConstructContext &context) const {
+    ostringstream stream;
+    stream << setprecision(numeric_limits<double>::max_digits10)
+           << plugins::any_cast<double>(construct(context));
+    return stream.str();
+}
+
 void FloatLiteralNode::dump(string indent) const {
     cout << indent << "FLOAT: " << value << endl;
 }
@@ -303,6 +397,10 @@ plugins::Any SymbolNode::construct(ConstructContext &) const {
     return plugins::Any(value);
 }
 
+string SymbolNode::get_normalized_config(ConstructContext &) const {
+    return utils::tolower(value);
+}
+
 void SymbolNode::dump(string indent) const {
     cout << indent << "SYMBOL: " << value << endl;
 }
@@ -331,6 +429,10 @@ plugins::Any ConvertNode::construct(ConstructContext &context) const {
     return converted_value;
 }
 
+string ConvertNode::get_normalized_config(ConstructContext &context) const {
+    return value->get_normalized_config(context);
+}
+
 void ConvertNode::dump(string indent) const {
     cout << indent << "CONVERT: "
          << from_type.name() << " to " << to_type.name() << endl;
@@ -393,6 +495,10 @@ plugins::Any CheckBoundsNode::construct(ConstructContext &context) const {
     return v;
 }
 
+string CheckBoundsNode::get_normalized_config(ConstructContext &context) const {
+    return value->get_normalized_config(context);
+}
+
 void CheckBoundsNode::dump(string indent) const {
     cout << indent << "CHECK-BOUNDS: " << endl;
     value->dump("| " + indent);
@@ -17,11 +17,18 @@ namespace parser {
 // TODO: if we can get rid of lazy values, this class could be moved to the cc file.
 class ConstructContext : public utils::Context {
     std::unordered_map<std::string, plugins::Any> variables;
+    std::unordered_map<std::string, std::string> normalized_variables;
 public:
     void set_variable(const std::string &name, const plugins::Any &value);
     void remove_variable(const std::string &name);
     bool has_variable(const std::string &name) const;
     plugins::Any get_variable(const std::string &name) const;
+
+    // Normalized configurations of variable definitions.
+    void set_normalized_variable(
+        const std::string &name, const std::string &normalized_config);
+    void remove_normalized_variable(const std::string &name);
+    std::string get_normalized_variable(const std::string &name) const;
 };
 
 class DecoratedASTNode {
@@ -30,6 +37,9 @@ public:
     plugins::Any construct() const;
     virtual plugins::Any construct(ConstructContext &context) const = 0;
     virtual void dump(std::string indent = "+") const = 0;
+    // See plugins::Options::get_normalized_config.
+    virtual std::string get_normalized_config(
+        ConstructContext &context) const = 0;
 
     // TODO: This is here only for the iterated search. Once we switch to builders, we won't need it any more.
     virtual std::unique_ptr<DecoratedASTNode> clone() const = 0;
@@ -86,6 +96,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -105,6 +117,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -119,6 +133,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -136,6 +152,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -150,6 +168,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -164,6 +184,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -178,6 +200,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -192,6 +216,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -210,6 +236,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -227,6 +255,8 @@ public:
 
     plugins::Any construct(ConstructContext &context) const override;
     void dump(std::string indent) const override;
+    std::string get_normalized_config(
+        ConstructContext &context) const override;
 
     // TODO: once we get rid of lazy construction, this should no longer be necessary.
     virtual std::unique_ptr<DecoratedASTNode> clone() const override;
@@ -13,31 +13,42 @@ namespace pdbs {
 CanonicalPDBs::CanonicalPDBs(
     const shared_ptr<PDBCollection> &pdbs,
     const shared_ptr<vector<PatternClique>> &pattern_cliques)
-    : pdbs(pdbs), pattern_cliques(pattern_cliques) {
-    assert(pdbs);
+    : pdbs(pdbs), ranker(*pdbs) {
     assert(pattern_cliques);
-}
-
-int CanonicalPDBs::get_value(const State &state) const {
     // If we have an empty collection, then pattern_cliques = { \emptyset }.
     assert(!pattern_cliques->empty());
+    clique_ends.reserve(pattern_cliques->size());
+    for (const PatternClique &clique : *pattern_cliques) {
+        clique_pdb_ids.insert(clique_pdb_ids.end(), clique.begin(), clique.end());
+        clique_ends.push_back(clique_pdb_ids.size());
+    }
+}
+
+int CanonicalPDBs::get_value(const State &state, int cutoff) const {
     int max_h = 0;
-    vector<int> h_values;
-    h_values.reserve(pdbs->size());
     state.unpack();
-    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
-        int h = pdb->get_value(state.get_unpacked_values());
+    // We rank the state for all PDBs first and replace the ranks by h-values.
+    vector<int> h_values;
+    ranker.rank(state.get_unpacked_values(), h_values);
+    for (size_t i = 0; i < h_values.size(); ++i) {
+        int h = (*pdbs)[i]->get_distance(h_values[i]);
         if (h == numeric_limits<int>::max()) {
             return numeric_limits<int>::max();
+        } else if (h >= cutoff) {
+            return h;
         }
-        h_values.push_back(h);
+        h_values[i] = h;
     }
-    for (const PatternClique &clique : *pattern_cliques) {
+    int entry = 0;
+    for (int clique_end : clique_ends) {
         int clique_h = 0;
-        for (PatternID pdb_index : clique) {
-            clique_h += h_values[pdb_index];
+        for (; entry < clique_end; ++entry) {
+            clique_h += h_values[clique_pdb_ids[entry]];
         }
         max_h = max(max_h, clique_h);
+        if (max_h >= cutoff) {
+            break;
+        }
     }
     return max_h;
 }
@@ -1,8 +1,10 @@
 #ifndef PDBS_CANONICAL_PDBS_H
 #define PDBS_CANONICAL_PDBS_H
 
+#include "pattern_database.h"
 #include "types.h"
 
+#include <limits>
 #include <memory>
 
 class State;
@@ -10,7 +12,14 @@ class State;
 namespace pdbs {
 class CanonicalPDBs {
     std::shared_ptr<PDBCollection> pdbs;
-    std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    PDBCollectionRanker ranker;
+    /*
+      The PDB IDs of all pattern cliques, stored one clique after the other.
+      The i-th clique ends at clique_ends[i]. Storing the cliques in one
+      vector lets us compute all clique sums in a single pass.
+    */
+    std::vector<int> clique_pdb_ids;
+    std::vector<int> clique_ends;
 
 public:
     CanonicalPDBs(
@@ -18,7 +27,14 @@ public:
         const std::shared_ptr<std::vector<PatternClique>> &pattern_cliques);
     ~CanonicalPDBs() = default;
 
-    int get_value(const State &state) const;
+    /*
+      Return the canonical heuristic value of the state. If it is at least
+      cutoff, the method may stop early and return any value h' with
+      cutoff <= h' <= h.
+    */
+    int get_value(
+        const State &state,
+        int cutoff = std::numeric_limits<int>::max()) const;
 };
 }
 
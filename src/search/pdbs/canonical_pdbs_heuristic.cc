@@ -54,6 +54,7 @@ CanonicalPDBs get_canonical_pdbs_from_options(
             *pattern_cliques,
             num_variables,
             max_time_dominance_pruning,
+            opts.get<int>("num_threads_dominance_pruning"),
             log);
     }
 
@@ -68,8 +69,14 @@ CanonicalPDBsHeuristic::CanonicalPDBsHeuristic(const plugins::Options &opts)
 }
 
 int CanonicalPDBsHeuristic::compute_heuristic(const State &ancestor_state) {
+    return compute_heuristic_with_cutoff(
+        ancestor_state, numeric_limits<int>::max());
+}
+
+int CanonicalPDBsHeuristic::compute_heuristic_with_cutoff(
+    const State &ancestor_state, int cutoff) {
     State state = convert_ancestor_state(ancestor_state);
-    int h = canonical_pdbs.get_value(state);
+    int h = canonical_pdbs.get_value(state, cutoff);
     if (h == numeric_limits<int>::max()) {
         return DEAD_END;
     } else {
@@ -86,6 +93,12 @@ void add_canonical_pdbs_options_to_feature(plugins::Feature &feature) {
         "value because there are dominating subsets in the collection.",
         "infinity",
         plugins::Bounds("0.0", "infinity"));
+    feature.add_option<int>(
+        "num_threads_dominance_pruning",
+        "number of threads used for dominance pruning. The pruned patterns "
+        "and additive subsets do not depend on this number.",
+        "1",
+        plugins::Bounds("1", "infinity"));
 }
 
 class CanonicalPDBsHeuristicFeature : public plugins::TypedFeature<Evaluator, CanonicalPDBsHeuristic> {
@@ -16,6 +16,8 @@ class CanonicalPDBsHeuristic : public Heuristic {
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual int compute_heuristic_with_cutoff(
+        const State &ancestor_state, int cutoff) override;
 
 public:
     explicit CanonicalPDBsHeuristic(const plugins::Options &opts);
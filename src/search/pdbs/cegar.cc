@@ -19,35 +19,66 @@
 using namespace std;
 
 namespace pdbs {
+/*
+  If the A* search for the plan of a refined pattern expands more than this
+  fraction of its abstract states, the lower bounds inherited from coarser
+  patterns have become weak, and we compute the PDB of the refined pattern
+  to serve as lower bound for its own refinements.
+*/
+static const double MAX_EXPANDED_FRACTION_WITHOUT_PDB = 0.25;
+
 /*
   This is used as a "collection entry" in the CEGAR algorithm. It stores
-  the PDB (and with that, the pattern) and an optimal plan (in the wildcard
-  format) for that PDB if it exists or unsolvable is true otherwise. It can
-  be marked as "solved" to ignore it in further iterations of the CEGAR
-  algorithm.
+  the pattern and an optimal plan (in the wildcard format) for its
+  projection if it exists or unsolvable is true otherwise. It can be marked
+  as "solved" to ignore it in further iterations of the CEGAR algorithm.
+
+  Most patterns are refined further, so their PDBs are only computed when
+  needed. The lower bound PDBs are the PDB of the pattern if it has been
+  computed and otherwise the lower bound PDBs of the coarser patterns the
+  pattern has been refined from. Their patterns are subsets of the pattern,
+  so they can guide the search for the plans of refinements of the pattern.
 */
 class PatternInfo {
+    Pattern pattern;
+    int pdb_size;
     shared_ptr<PatternDatabase> pdb;
+    PDBCollection lower_bound_pdbs;
     vector<vector<OperatorID>> plan;
     bool unsolvable;
     bool solved;
 
 public:
     PatternInfo(
-        const shared_ptr<PatternDatabase> &&pdb,
-        const vector<vector<OperatorID>> &&plan,
+        Pattern &&pattern,
+        int pdb_size,
+        const shared_ptr<PatternDatabase> &pdb,
+        PDBCollection &&lower_bound_pdbs,
+        vector<vector<OperatorID>> &&plan,
         bool unsolvable)
-        : pdb(move(pdb)),
+        : pattern(move(pattern)),
+          pdb_size(pdb_size),
+          pdb(pdb),
+          lower_bound_pdbs(move(lower_bound_pdbs)),
           plan(move(plan)),
           unsolvable(unsolvable),
           solved(false) {}
 
+    const Pattern &get_pattern() const {
+        return pattern;
+    }
+
+    int get_pdb_size() const {
+        return pdb_size;
+    }
+
+    // Return the PDB of the pattern if it has been computed or nullptr.
     const shared_ptr<PatternDatabase> &get_pdb() const {
         return pdb;
     }
 
-    const Pattern &get_pattern() const {
-        return pdb->get_pattern();
+    const PDBCollection &get_lower_bound_pdbs() const {
+        return lower_bound_pdbs;
     }
 
     const vector<vector<OperatorID>> &get_plan() const {
@@ -84,6 +115,8 @@ class CEGAR {
     const int max_collection_size;
     const double max_time;
     const bool use_wildcard_plans;
+    const int num_threads;
+    const size_t max_pdb_construction_memory;
     utils::LogProxy &log;
     shared_ptr<utils::RandomNumberGenerator> rng;
     const shared_ptr<AbstractTask> &task;
@@ -102,7 +135,14 @@ class CEGAR {
     void print_collection() const;
     bool time_limit_reached(const utils::CountdownTimer &timer) const;
 
-    unique_ptr<PatternInfo> compute_pattern_info(Pattern &&pattern) const;
+    /*
+      Compute the plan for the given pattern. Without lower bound PDBs,
+      compute the PDB along with the plan. Otherwise, search the plan
+      guided by the lower bound PDBs.
+    */
+    unique_ptr<PatternInfo> compute_pattern_info(
+        Pattern &&pattern,
+        PDBCollection &&lower_bound_pdbs = PDBCollection()) const;
     void compute_initial_collection();
 
     /*
@@ -151,6 +191,8 @@ public:
         int max_collection_size,
         double max_time,
         bool use_wildcard_plans,
+        int num_threads,
+        size_t max_pdb_construction_memory,
         utils::LogProxy &log,
         const shared_ptr<utils::RandomNumberGenerator> &rng,
         const shared_ptr<AbstractTask> &task,
@@ -164,6 +206,8 @@ CEGAR::CEGAR(
     int max_collection_size,
     double max_time,
     bool use_wildcard_plans,
+    int num_threads,
+    size_t max_pdb_construction_memory,
     utils::LogProxy &log,
     const shared_ptr<utils::RandomNumberGenerator> &rng,
     const shared_ptr<AbstractTask> &task,
@@ -173,6 +217,8 @@ CEGAR::CEGAR(
       max_collection_size(max_collection_size),
       max_time(max_time),
       use_wildcard_plans(use_wildcard_plans),
+      num_threads(num_threads),
+      max_pdb_construction_memory(max_pdb_construction_memory),
       log(log),
       rng(rng),
       task(task),
@@ -224,23 +270,48 @@ bool CEGAR::time_limit_reached(
     return false;
 }
 
-unique_ptr<PatternInfo> CEGAR::compute_pattern_info(Pattern &&pattern) const {
+unique_ptr<PatternInfo> CEGAR::compute_pattern_info(
+    Pattern &&pattern, PDBCollection &&lower_bound_pdbs) const {
+    int pdb_size = compute_pdb_size(task_proxy, pattern);
     vector<int> op_cost;
-    auto [pdb, plan] = compute_pdb_and_plan(
-        task_proxy, pattern, op_cost, rng, use_wildcard_plans);
+    shared_ptr<PatternDatabase> pdb;
+    vector<vector<OperatorID>> plan;
+    int init_h;
+    if (lower_bound_pdbs.empty()) {
+        tie(pdb, plan) = compute_pdb_and_plan(
+            task_proxy, pattern, op_cost, rng, use_wildcard_plans);
+        State initial_state = task_proxy.get_initial_state();
+        initial_state.unpack();
+        init_h = pdb->get_value(initial_state.get_unpacked_values());
+    } else {
+        int num_expanded_states;
+        tie(init_h, plan, num_expanded_states) = compute_plan_with_lower_bounds(
+            task_proxy, pattern, lower_bound_pdbs, op_cost, rng,
+            use_wildcard_plans);
+        if (log.is_at_least_verbose()) {
+            log << "search for plan of pattern " << pattern << " expanded "
+                << num_expanded_states << " of " << pdb_size
+                << " abstract states" << endl;
+        }
+        if (num_expanded_states >
+            MAX_EXPANDED_FRACTION_WITHOUT_PDB * pdb_size) {
+            pdb = compute_pdb(task_proxy, pattern, op_cost, nullptr, num_threads);
+        }
+    }
+    if (pdb) {
+        lower_bound_pdbs = {pdb};
+    }
 
     bool unsolvable = false;
-    State initial_state = task_proxy.get_initial_state();
-    initial_state.unpack();
-    if (pdb->get_value(initial_state.get_unpacked_values()) == numeric_limits<int>::max()) {
+    if (init_h == numeric_limits<int>::max()) {
         unsolvable = true;
         if (log.is_at_least_verbose()) {
-            log << "projection onto pattern " << pdb->get_pattern()
+            log << "projection onto pattern " << pattern
                 << " is unsolvable" << endl;
         }
     } else {
         if (log.is_at_least_verbose()) {
-            log << "##### Plan for pattern " << pdb->get_pattern() << " #####" << endl;
+            log << "##### Plan for pattern " << pattern << " #####" << endl;
             int step = 1;
             for (const vector<OperatorID> &equivalent_ops : plan) {
                 log << "step #" << step << endl;
@@ -253,7 +324,9 @@ unique_ptr<PatternInfo> CEGAR::compute_pattern_info(Pattern &&pattern) const {
             log << "##### End of plan #####" << endl;
         }
     }
-    return utils::make_unique_ptr<PatternInfo>(move(pdb), move(plan), unsolvable);
+    return utils::make_unique_ptr<PatternInfo>(
+        move(pattern), pdb_size, pdb, move(lower_bound_pdbs), move(plan),
+        unsolvable);
 }
 
 void CEGAR::compute_initial_collection() {
@@ -431,12 +504,12 @@ int CEGAR::get_flaws(const State &concrete_init, FlawList &flaws) {
 void CEGAR::add_pattern_for_var(int var) {
     pattern_collection.push_back(compute_pattern_info({var}));
     variable_to_collection_index[var] = pattern_collection.size() - 1;
-    collection_size += pattern_collection.back()->get_pdb()->get_size();
+    collection_size += pattern_collection.back()->get_pdb_size();
 }
 
 bool CEGAR::can_merge_patterns(int index1, int index2) const {
-    int pdb_size1 = pattern_collection[index1]->get_pdb()->get_size();
-    int pdb_size2 = pattern_collection[index2]->get_pdb()->get_size();
+    int pdb_size1 = pattern_collection[index1]->get_pdb_size();
+    int pdb_size2 = pattern_collection[index2]->get_pdb_size();
     if (!utils::is_product_within_limit(pdb_size1, pdb_size2, max_pdb_size)) {
         return false;
     }
@@ -460,16 +533,22 @@ void CEGAR::merge_patterns(int index1, int index2) {
     sort(new_pattern.begin(), new_pattern.end());
 
     // Store old PDB sizes.
-    int pdb_size1 = pattern_collection[index1]->get_pdb()->get_size();
-    int pdb_size2 = pattern_collection[index2]->get_pdb()->get_size();
+    int pdb_size1 = pattern_collection[index1]->get_pdb_size();
+    int pdb_size2 = pattern_collection[index2]->get_pdb_size();
 
     // Compute merged_pattern_info pattern.
-    unique_ptr<PatternInfo> merged_pattern_info = compute_pattern_info(move(new_pattern));
+    PDBCollection lower_bound_pdbs = pattern_info1.get_lower_bound_pdbs();
+    const PDBCollection &lower_bound_pdbs2 = pattern_info2.get_lower_bound_pdbs();
+    lower_bound_pdbs.insert(
+        lower_bound_pdbs.end(), lower_bound_pdbs2.begin(),
+        lower_bound_pdbs2.end());
+    unique_ptr<PatternInfo> merged_pattern_info = compute_pattern_info(
+        move(new_pattern), move(lower_bound_pdbs));
 
     // Update collection size.
     collection_size -= pdb_size1;
     collection_size -= pdb_size2;
-    collection_size += merged_pattern_info->get_pdb()->get_size();
+    collection_size += merged_pattern_info->get_pdb_size();
 
     // Clean up.
     pattern_collection[index1] = move(merged_pattern_info);
@@ -477,7 +556,7 @@ void CEGAR::merge_patterns(int index1, int index2) {
 }
 
 bool CEGAR::can_add_variable_to_pattern(int index, int var) const {
-    int pdb_size = pattern_collection[index]->get_pdb()->get_size();
+    int pdb_size = pattern_collection[index]->get_pdb_size();
     int domain_size = task_proxy.get_variables()[var].get_domain_size();
     if (!utils::is_product_within_limit(pdb_size, domain_size, max_pdb_size)) {
         return false;
@@ -493,10 +572,12 @@ void CEGAR::add_variable_to_pattern(int collection_index, int var) {
     new_pattern.push_back(var);
     sort(new_pattern.begin(), new_pattern.end());
 
-    unique_ptr<PatternInfo> new_pattern_info = compute_pattern_info(move(new_pattern));
+    PDBCollection lower_bound_pdbs = pattern_info.get_lower_bound_pdbs();
+    unique_ptr<PatternInfo> new_pattern_info = compute_pattern_info(
+        move(new_pattern), move(lower_bound_pdbs));
 
-    collection_size -= pattern_info.get_pdb()->get_size();
-    collection_size += new_pattern_info->get_pdb()->get_size();
+    collection_size -= pattern_info.get_pdb_size();
+    collection_size += new_pattern_info->get_pdb_size();
 
     variable_to_collection_index[var] = collection_index;
     pattern_collection[collection_index] = move(new_pattern_info);
@@ -623,23 +704,62 @@ PatternCollectionInformation CEGAR::compute_pattern_collection() {
         log << endl;
     }
 
-    shared_ptr<PatternCollection> patterns = make_shared<PatternCollection>();
-    shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>();
+    vector<const PatternInfo *> final_pattern_infos;
     if (concrete_solution_index != -1) {
-        const shared_ptr<PatternDatabase> &pdb =
-            pattern_collection[concrete_solution_index]->get_pdb();
-        patterns->push_back(pdb->get_pattern());
-        pdbs->push_back(pdb);
+        final_pattern_infos.push_back(
+            pattern_collection[concrete_solution_index].get());
     } else {
         for (const unique_ptr<PatternInfo> &pattern_info : pattern_collection) {
             if (pattern_info) {
-                const shared_ptr<PatternDatabase> &pdb = pattern_info->get_pdb();
-                patterns->push_back(pdb->get_pattern());
-                pdbs->push_back(pdb);
+                final_pattern_infos.push_back(pattern_info.get());
             }
         }
     }
 
+    /*
+      Compute the missing PDBs of the final patterns within the time limit.
+      A pattern whose PDB has not been started when the time limit is
+      reached is replaced by the coarser patterns of its lower bound PDBs.
+    */
+    PatternCollection missing_patterns;
+    for (const PatternInfo *pattern_info : final_pattern_infos) {
+        if (!pattern_info->get_pdb()) {
+            missing_patterns.push_back(pattern_info->get_pattern());
+        }
+    }
+    shared_ptr<PDBCollection> missing_pdbs = compute_pdbs(
+        task_proxy, missing_patterns, num_threads,
+        max_pdb_construction_memory, 1, &timer);
+
+    shared_ptr<PatternCollection> patterns = make_shared<PatternCollection>();
+    shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>();
+    auto add_pdb = [&](const shared_ptr<PatternDatabase> &pdb) {
+        patterns->push_back(pdb->get_pattern());
+        pdbs->push_back(pdb);
+    };
+    int num_replaced_patterns = 0;
+    int missing_index = 0;
+    for (const PatternInfo *pattern_info : final_pattern_infos) {
+        shared_ptr<PatternDatabase> pdb = pattern_info->get_pdb();
+        if (!pdb) {
+            pdb = (*missing_pdbs)[missing_index++];
+        }
+        if (pdb) {
+            add_pdb(pdb);
+        } else {
+            ++num_replaced_patterns;
+            for (const shared_ptr<PatternDatabase> &lower_bound_pdb :
+                 pattern_info->get_lower_bound_pdbs()) {
+                add_pdb(lower_bound_pdb);
+            }
+        }
+    }
+    if (num_replaced_patterns && log.is_at_least_normal()) {
+        log << "CEGAR replaced " << num_replaced_patterns << " patterns "
+            << "whose PDBs could not be computed in time by coarser ones"
+            << endl;
+    }
+
     PatternCollectionInformation pattern_collection_information(
         task_proxy, patterns, log);
     pattern_collection_information.set_pdbs(pdbs);
@@ -661,6 +781,8 @@ PatternCollectionInformation generate_pattern_collection_with_cegar(
     int max_collection_size,
     double max_time,
     bool use_wildcard_plans,
+    int num_threads,
+    size_t max_pdb_construction_memory,
     utils::LogProxy &log,
     const shared_ptr<utils::RandomNumberGenerator> &rng,
     const shared_ptr<AbstractTask> &task,
@@ -671,6 +793,8 @@ PatternCollectionInformation generate_pattern_collection_with_cegar(
         max_collection_size,
         max_time,
         use_wildcard_plans,
+        num_threads,
+        max_pdb_construction_memory,
         log,
         rng,
         task,
@@ -683,6 +807,7 @@ PatternInformation generate_pattern_with_cegar(
     int max_pdb_size,
     double max_time,
     bool use_wildcard_plans,
+    int num_threads,
     utils::LogProxy &log,
     const shared_ptr<utils::RandomNumberGenerator> &rng,
     const shared_ptr<AbstractTask> &task,
@@ -694,6 +819,8 @@ PatternInformation generate_pattern_with_cegar(
         max_pdb_size,
         max_time,
         use_wildcard_plans,
+        num_threads,
+        numeric_limits<size_t>::max(),
         log,
         rng,
         task,
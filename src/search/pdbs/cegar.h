@@ -34,12 +34,19 @@ namespace pdbs {
   size, setting a time limit and switching between computing regular or
   wildcard plans, where the latter are sequences of parallel operators
   inducing the same abstract transition.
+
+  The time limit also bounds computing the PDBs of the final collection
+  (with num_threads threads, see compute_pdbs). Patterns whose PDB is not
+  started in time are replaced by the coarser patterns they have been
+  refined from, whose PDBs are already known.
 */
 extern PatternCollectionInformation generate_pattern_collection_with_cegar(
     int max_pdb_size,
     int max_collection_size,
     double max_time,
     bool use_wildcard_plans,
+    int num_threads,
+    std::size_t max_pdb_construction_memory,
     utils::LogProxy &log,
     const std::shared_ptr<utils::RandomNumberGenerator> &rng,
     const std::shared_ptr<AbstractTask> &task,
@@ -55,6 +62,7 @@ extern PatternInformation generate_pattern_with_cegar(
     int max_pdb_size,
     double max_time,
     bool use_wildcard_plans,
+    int num_threads,
     utils::LogProxy &log,
     const std::shared_ptr<utils::RandomNumberGenerator> &rng,
     const std::shared_ptr<AbstractTask> &task,
@@ -3,11 +3,13 @@
 #include "pattern_database.h"
 
 #include "../utils/countdown_timer.h"
-#include "../utils/hash.h"
 #include "../utils/logging.h"
+#include "../utils/parallel.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 
 using namespace std;
@@ -15,94 +17,179 @@ using namespace std;
 namespace pdbs {
 class Pruner {
     /*
-      Algorithm for pruning dominated patterns.
+      Algorithm for pruning dominated pattern cliques.
 
       "patterns" is the vector of patterns used.
       Each pattern is a vector of variable IDs.
 
       "pattern_cliques" is the vector of pattern cliques.
 
-      The algorithm works by setting a "current pattern collection"
-      against which other patterns and collections can be tested for
-      dominance efficiently.
-
-      "variable_to_pattern_id" encodes the relevant information about the
-      current clique. For every variable v, variable_to_pattern_id[v] is
-      the id of the pattern containing v in the current clique,
-      or -1 if the variable is not contained in the current
-      clique. (Note that patterns in a pattern clique must be
-      disjoint, which is verified by an assertion in debug mode.)
-
-      To test if a given pattern v_1, ..., v_k is dominated by the
-      current clique, we check that all entries variable_to_pattern_id[v_i]
-      are equal and different from -1.
-
-      "dominated_patterns" is a vector<bool> that can be used to
-      quickly test whether a given pattern is dominated by the current
-      clique. This is precomputed for every pattern whenever the
-      current clique is set.
+      Dominance between cliques is a preorder. A clique is pruned if
+      another clique strictly dominates it or if an equivalent clique
+      comes before it in pattern_cliques. Hence, exactly the first clique
+      of each maximal equivalence class survives, which is the same
+      result as pruning with the surviving cliques in order. Unlike that
+      approach, this criterion can be tested for every clique
+      independently, so the cliques are tested concurrently.
+
+      The variables of each pattern are stored as a bitset of
+      "num_words" 64-bit words in "variable_sets", so that testing
+      whether a pattern is a subset of another one only needs a few word
+      operations.
+
+      For every pattern p, "superpatterns[p]" contains the IDs of all
+      patterns that are supersets of p (including p itself), and
+      "pattern_to_cliques[p]" contains the IDs of all cliques containing
+      p. A clique c can only be dominated by cliques containing a
+      superpattern of a given pattern in c, so we only test these
+      cliques, choosing the pattern in c with the fewest candidates.
     */
 
     const PatternCollection &patterns;
     const vector<PatternClique> &pattern_cliques;
     const int num_variables;
+    const int num_words;
+
+    vector<uint64_t> variable_sets;
+    vector<vector<PatternID>> superpatterns;
+    vector<vector<int>> pattern_to_cliques;
+    vector<int> num_candidate_cliques;
 
-    vector<int> variable_to_pattern_id;
-    vector<bool> dominated_patterns;
+    bool is_subpattern(PatternID pattern_id, PatternID other_pattern_id) const {
+        const uint64_t *variables = &variable_sets[pattern_id * num_words];
+        const uint64_t *other_variables =
+            &variable_sets[other_pattern_id * num_words];
+        for (int i = 0; i < num_words; ++i) {
+            if (variables[i] & ~other_variables[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
 
-    void set_current_clique(int clique_id) {
+    bool is_clique_dominated_by(int clique_id, int other_clique_id) const {
         /*
-          Set the current pattern collection to be used for
-          is_pattern_dominated() or is_collection_dominated(). Compute
-          dominated_patterns based on the current pattern collection.
+          Check if every pattern of the clique with the given clique_id is
+          a subset of a pattern of the other clique.
         */
-        variable_to_pattern_id.assign(num_variables, -1);
-        assert(variable_to_pattern_id == vector<int>(num_variables, -1));
+        const PatternClique &other_clique = pattern_cliques[other_clique_id];
         for (PatternID pattern_id : pattern_cliques[clique_id]) {
-            for (int variable : patterns[pattern_id]) {
-                assert(variable_to_pattern_id[variable] == -1);
-                variable_to_pattern_id[variable] = pattern_id;
+            bool is_dominated = false;
+            for (PatternID other_pattern_id : other_clique) {
+                if (is_subpattern(pattern_id, other_pattern_id)) {
+                    is_dominated = true;
+                    break;
+                }
+            }
+            if (!is_dominated) {
+                return false;
             }
         }
-
-        dominated_patterns.clear();
-        dominated_patterns.reserve(patterns.size());
-        for (size_t i = 0; i < patterns.size(); ++i) {
-            dominated_patterns.push_back(is_pattern_dominated(i));
-        }
+        return true;
     }
 
-    bool is_pattern_dominated(int pattern_id) const {
+    bool prunes(int clique_id, int other_clique_id) const {
         /*
-          Check if the pattern with the given pattern_id is dominated
-          by the current pattern clique.
+          Check if the other clique causes the clique with the given
+          clique_id to be pruned.
         */
-        const Pattern &pattern = patterns[pattern_id];
-        assert(!pattern.empty());
-        PatternID clique_pattern_id = variable_to_pattern_id[pattern[0]];
-        if (clique_pattern_id == -1) {
-            return false;
+        return other_clique_id != clique_id &&
+               is_clique_dominated_by(clique_id, other_clique_id) &&
+               (other_clique_id < clique_id ||
+                !is_clique_dominated_by(other_clique_id, clique_id));
+    }
+
+    void compute_variable_sets() {
+        variable_sets.assign(patterns.size() * num_words, 0);
+        for (size_t pattern_id = 0; pattern_id < patterns.size(); ++pattern_id) {
+            uint64_t *variables = &variable_sets[pattern_id * num_words];
+            for (int var : patterns[pattern_id]) {
+                assert(var >= 0 && var < num_variables);
+                variables[var / 64] |= uint64_t(1) << (var % 64);
+            }
         }
-        int pattern_size = pattern.size();
-        for (int i = 1; i < pattern_size; ++i) {
-            if (variable_to_pattern_id[pattern[i]] != clique_pattern_id) {
-                return false;
+    }
+
+    bool compute_superpatterns(
+        int num_threads, const utils::CountdownTimer &timer) {
+        vector<vector<PatternID>> variable_to_patterns(num_variables);
+        for (size_t pattern_id = 0; pattern_id < patterns.size(); ++pattern_id) {
+            for (int var : patterns[pattern_id]) {
+                variable_to_patterns[var].push_back(pattern_id);
+            }
+        }
+
+        superpatterns.resize(patterns.size());
+        atomic<bool> timed_out(false);
+        utils::parallel_for(
+            patterns.size(), num_threads, [&](int pattern_id) {
+                if (timed_out || timer.is_expired()) {
+                    timed_out = true;
+                    return;
+                }
+                const Pattern &pattern = patterns[pattern_id];
+                assert(!pattern.empty());
+                // Only test patterns containing the rarest variable.
+                int rarest_var = *min_element(
+                    pattern.begin(), pattern.end(), [&](int var1, int var2) {
+                        return variable_to_patterns[var1].size() <
+                               variable_to_patterns[var2].size();
+                    });
+                for (PatternID other_pattern_id : variable_to_patterns[rarest_var]) {
+                    if (is_subpattern(pattern_id, other_pattern_id)) {
+                        superpatterns[pattern_id].push_back(other_pattern_id);
+                    }
+                }
+            });
+        return !timed_out;
+    }
+
+    void compute_candidate_cliques() {
+        pattern_to_cliques.resize(patterns.size());
+        for (size_t clique_id = 0; clique_id < pattern_cliques.size(); ++clique_id) {
+            for (PatternID pattern_id : pattern_cliques[clique_id]) {
+                pattern_to_cliques[pattern_id].push_back(clique_id);
+            }
+        }
+        num_candidate_cliques.assign(patterns.size(), 0);
+        for (size_t pattern_id = 0; pattern_id < patterns.size(); ++pattern_id) {
+            for (PatternID superpattern_id : superpatterns[pattern_id]) {
+                num_candidate_cliques[pattern_id] +=
+                    pattern_to_cliques[superpattern_id].size();
             }
         }
-        return true;
     }
 
-    bool is_clique_dominated(int clique_id) const {
+    bool is_clique_pruned(int clique_id) const {
+        const PatternClique &clique = pattern_cliques[clique_id];
+        if (clique.empty()) {
+            // The empty clique is dominated by all cliques.
+            int num_cliques = pattern_cliques.size();
+            for (int other_clique_id = 0; other_clique_id < num_cliques;
+                 ++other_clique_id) {
+                if (prunes(clique_id, other_clique_id)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        PatternID pattern_id = *min_element(
+            clique.begin(), clique.end(), [&](PatternID id1, PatternID id2) {
+                return num_candidate_cliques[id1] < num_candidate_cliques[id2];
+            });
         /*
-          Check if the collection with the given collection_id is
-          dominated by the current pattern collection.
+          Patterns in a clique are disjoint, so no clique contains two
+          superpatterns of the same pattern and every candidate is tested
+          at most once.
         */
-        for (PatternID pattern_id : pattern_cliques[clique_id]) {
-            if (!dominated_patterns[pattern_id]) {
-                return false;
+        for (PatternID superpattern_id : superpatterns[pattern_id]) {
+            for (int other_clique_id : pattern_to_cliques[superpattern_id]) {
+                if (prunes(clique_id, other_clique_id)) {
+                    return true;
+                }
             }
         }
-        return true;
+        return false;
     }
 
 public:
@@ -112,42 +199,43 @@ public:
         int num_variables)
         : patterns(patterns),
           pattern_cliques(pattern_cliques),
-          num_variables(num_variables) {
+          num_variables(num_variables),
+          num_words((num_variables + 63) / 64) {
+        compute_variable_sets();
     }
 
     vector<bool> get_pruned_cliques(
-        const utils::CountdownTimer &timer, utils::LogProxy &log) {
+        int num_threads, const utils::CountdownTimer &timer,
+        utils::LogProxy &log) {
         int num_cliques = pattern_cliques.size();
-        vector<bool> pruned(num_cliques, false);
         /*
-          Already pruned cliques are not used to prune other
-          cliques. This makes things faster and helps handle
-          duplicate cliques in the correct way: the first copy
-          will survive and prune all duplicates.
+          The result is stored in a vector<char> rather than a
+          vector<bool> because threads write to it concurrently.
         */
-        for (int c1 = 0; c1 < num_cliques; ++c1) {
-            if (!pruned[c1]) {
-                set_current_clique(c1);
-                for (int c2 = 0; c2 < num_cliques; ++c2) {
-                    if (c1 != c2 && !pruned[c2] && is_clique_dominated(c2))
-                        pruned[c2] = true;
-                }
-            }
-            if (timer.is_expired()) {
-                /*
-                  Since after each iteration, we determined if a given
-                  clique is pruned or not, we can just break the
-                  computation here if reaching the time limit and use all
-                  information we collected so far.
-                */
-                if (log.is_at_least_normal()) {
-                    log << "Time limit reached. Abort dominance pruning." << endl;
-                }
-                break;
-            }
+        vector<char> pruned(num_cliques, false);
+        /*
+          If the time limit is reached, the cliques that have not been
+          tested yet are kept. This is safe since keeping cliques never
+          affects admissibility.
+        */
+        atomic<bool> timed_out(false);
+        if (compute_superpatterns(num_threads, timer)) {
+            compute_candidate_cliques();
+            utils::parallel_for(
+                num_cliques, num_threads, [&](int clique_id) {
+                    if (timed_out || timer.is_expired()) {
+                        timed_out = true;
+                        return;
+                    }
+                    pruned[clique_id] = is_clique_pruned(clique_id);
+                });
+        } else {
+            timed_out = true;
         }
-
-        return pruned;
+        if (timed_out && log.is_at_least_normal()) {
+            log << "Time limit reached. Abort dominance pruning." << endl;
+        }
+        return vector<bool>(pruned.begin(), pruned.end());
     }
 };
 
@@ -157,6 +245,7 @@ void prune_dominated_cliques(
     vector<PatternClique> &pattern_cliques,
     int num_variables,
     double max_time,
+    int num_threads,
     utils::LogProxy &log) {
     if (log.is_at_least_normal()) {
         log << "Running dominance pruning..." << endl;
@@ -169,7 +258,7 @@ void prune_dominated_cliques(
     vector<bool> pruned = Pruner(
         patterns,
         pattern_cliques,
-        num_variables).get_pruned_cliques(timer, log);
+        num_variables).get_pruned_cliques(num_threads, timer, log);
 
     vector<PatternClique> remaining_pattern_cliques;
     vector<bool> is_remaining_pattern(num_patterns, false);
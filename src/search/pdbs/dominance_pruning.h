@@ -12,6 +12,12 @@ namespace pdbs {
   Clique superset dominates clique subset iff for every pattern
   p_subset in subset there is a pattern p_superset in superset where
   p_superset is a superset of p_subset.
+
+  Dominated cliques are pruned and patterns that no longer occur in any
+  clique are removed together with their PDBs. The cliques are tested
+  concurrently by num_threads threads; the result does not depend on
+  this number. If max_time is reached, the cliques that have not been
+  tested yet are kept.
 */
 extern void prune_dominated_cliques(
     PatternCollection &patterns,
@@ -19,6 +25,7 @@ extern void prune_dominated_cliques(
     std::vector<PatternClique> &pattern_cliques,
     int num_variables,
     double max_time,
+    int num_threads,
     utils::LogProxy &log);
 }
 
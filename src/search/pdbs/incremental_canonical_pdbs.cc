@@ -1,9 +1,10 @@
 #include "incremental_canonical_pdbs.h"
 
-#include "canonical_pdbs.h"
 #include "pattern_database.h"
 #include "pattern_database_factory.h"
 
+#include "../utils/memory.h"
+
 #include <limits>
 
 using namespace std;
@@ -33,12 +34,20 @@ void IncrementalCanonicalPDBs::add_pdb(const shared_ptr<PatternDatabase> &pdb) {
     patterns->push_back(pdb->get_pattern());
     pattern_databases->push_back(pdb);
     size += pattern_databases->back()->get_size();
-    recompute_pattern_cliques();
+    pattern_cliques = compute_pattern_cliques_with_new_pattern(
+        *patterns, *pattern_cliques, are_additive);
+    update_canonical_pdbs();
 }
 
 void IncrementalCanonicalPDBs::recompute_pattern_cliques() {
     pattern_cliques = compute_pattern_cliques(*patterns,
                                               are_additive);
+    update_canonical_pdbs();
+}
+
+void IncrementalCanonicalPDBs::update_canonical_pdbs() {
+    canonical_pdbs = utils::make_unique_ptr<CanonicalPDBs>(
+        pattern_databases, pattern_cliques);
 }
 
 vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
@@ -48,8 +57,7 @@ vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
 }
 
 int IncrementalCanonicalPDBs::get_value(const State &state) const {
-    CanonicalPDBs canonical_pdbs(pattern_databases, pattern_cliques);
-    return canonical_pdbs.get_value(state);
+    return canonical_pdbs->get_value(state);
 }
 
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
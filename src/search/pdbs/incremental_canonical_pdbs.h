@@ -1,6 +1,7 @@
 #ifndef PDBS_INCREMENTAL_CANONICAL_PDBS_H
 #define PDBS_INCREMENTAL_CANONICAL_PDBS_H
 
+#include "canonical_pdbs.h"
 #include "pattern_cliques.h"
 #include "pattern_collection_information.h"
 #include "types.h"
@@ -16,6 +17,8 @@ class IncrementalCanonicalPDBs {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pattern_databases;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    // Evaluates the current collection. Rebuilt whenever a PDB is added.
+    std::unique_ptr<CanonicalPDBs> canonical_pdbs;
 
     // A pair of variables is additive if no operator has an effect on both.
     VariableAdditivity are_additive;
@@ -27,12 +30,13 @@ class IncrementalCanonicalPDBs {
     void add_pdb_for_pattern(const Pattern &pattern);
 
     void recompute_pattern_cliques();
+    void update_canonical_pdbs();
 public:
     IncrementalCanonicalPDBs(const TaskProxy &task_proxy,
                              const PatternCollection &intitial_patterns);
     virtual ~IncrementalCanonicalPDBs() = default;
 
-    // Adds a new PDB to the collection and recomputes pattern_cliques.
+    // Adds a new PDB to the collection and updates pattern_cliques.
     void add_pdb(const std::shared_ptr<PatternDatabase> &pdb);
 
     /* Returns a list of pattern cliques that would be additive to the new
@@ -68,7 +68,8 @@ bool MatchTree::Node::is_leaf_node() const {
 MatchTree::MatchTree(const TaskProxy &task_proxy, const Projection &projection)
     : task_proxy(task_proxy),
       projection(projection),
-      root(nullptr) {
+      root(nullptr),
+      finalized(false) {
 }
 
 MatchTree::~MatchTree() {
@@ -128,80 +129,132 @@ void MatchTree::insert_recursive(
 }
 
 void MatchTree::insert(int op_id, const vector<FactPair> &regression_preconditions) {
+    assert(!finalized);
     insert_recursive(op_id, regression_preconditions, 0, &root);
 }
 
+void MatchTree::finalize() {
+    assert(!finalized);
+    finalized = true;
+    if (!root) {
+        return;
+    }
+    /*
+      We number the nodes in the order in which the breadth-first
+      traversal reaches them, which is their position in the queue.
+    */
+    vector<Node *> queue = {root};
+    for (size_t node_id = 0; node_id < queue.size(); ++node_id) {
+        const Node *node = queue[node_id];
+        FlatNode flat_node;
+        flat_node.var_id = node->var_id;
+        flat_node.var_multiplier = 1;
+        flat_node.var_domain_size = node->var_domain_size;
+        flat_node.successors_begin = successor_ids.size();
+        flat_node.star_successor = -1;
+        flat_node.operators_begin = node_operator_ids.size();
+        node_operator_ids.insert(node_operator_ids.end(),
+                                 node->applicable_operator_ids.begin(),
+                                 node->applicable_operator_ids.end());
+        flat_node.operators_end = node_operator_ids.size();
+        if (!node->is_leaf_node()) {
+            flat_node.var_multiplier = projection.get_multiplier(node->var_id);
+            for (int val = 0; val < node->var_domain_size; ++val) {
+                if (node->successors[val]) {
+                    successor_ids.push_back(queue.size());
+                    queue.push_back(node->successors[val]);
+                } else {
+                    successor_ids.push_back(-1);
+                }
+            }
+            if (node->star_successor) {
+                flat_node.star_successor = queue.size();
+                queue.push_back(node->star_successor);
+            }
+        }
+        nodes.push_back(flat_node);
+    }
+    delete root;
+    root = nullptr;
+    nodes.shrink_to_fit();
+    successor_ids.shrink_to_fit();
+    node_operator_ids.shrink_to_fit();
+}
+
 void MatchTree::get_applicable_operator_ids_recursive(
-    Node *node, int state_index, vector<int> &operator_ids) const {
+    int node_id, int state_index, vector<int> &operator_ids) const {
     /*
       Note: different from the code that builds the match tree, we do
       the test if node == 0 *before* calling traverse rather than *at
       the start* of traverse since this turned out to be faster in
       some informal experiments.
      */
-
+    const FlatNode &node = nodes[node_id];
     operator_ids.insert(operator_ids.end(),
-                        node->applicable_operator_ids.begin(),
-                        node->applicable_operator_ids.end());
+                        node_operator_ids.begin() + node.operators_begin,
+                        node_operator_ids.begin() + node.operators_end);
 
-    if (node->is_leaf_node())
+    if (node.var_id == Node::LEAF_NODE)
         return;
 
-    int val = projection.unrank(state_index, node->var_id);
+    int val = (state_index / node.var_multiplier) % node.var_domain_size;
+    assert(val == projection.unrank(state_index, node.var_id));
 
-    if (node->successors[val]) {
+    int successor = successor_ids[node.successors_begin + val];
+    if (successor != -1) {
         // Follow the correct successor edge, if it exists.
         get_applicable_operator_ids_recursive(
-            node->successors[val], state_index, operator_ids);
+            successor, state_index, operator_ids);
     }
-    if (node->star_successor) {
+    if (node.star_successor != -1) {
         // Always follow the star edge, if it exists.
         get_applicable_operator_ids_recursive(
-            node->star_successor, state_index, operator_ids);
+            node.star_successor, state_index, operator_ids);
     }
 }
 
 void MatchTree::get_applicable_operator_ids(
     int state_index, vector<int> &operator_ids) const {
-    if (root)
-        get_applicable_operator_ids_recursive(root, state_index, operator_ids);
+    assert(finalized);
+    if (!nodes.empty())
+        get_applicable_operator_ids_recursive(0, state_index, operator_ids);
 }
 
-void MatchTree::dump_recursive(Node *node, utils::LogProxy &log) const {
+void MatchTree::dump_recursive(int node_id, utils::LogProxy &log) const {
     if (log.is_at_least_debug()) {
-        if (!node) {
-            // Node is the root node.
+        if (nodes.empty()) {
             log << "Empty MatchTree" << endl;
             return;
         }
+        const FlatNode &node = nodes[node_id];
         log << endl;
-        log << "node->var_id = " << node->var_id << endl;
+        log << "node->var_id = " << node.var_id << endl;
         log << "Number of applicable operators at this node: "
-            << node->applicable_operator_ids.size() << endl;
-        for (int op_id : node->applicable_operator_ids) {
-            log << "AbstractOperator #" << op_id << endl;
+            << node.operators_end - node.operators_begin << endl;
+        for (int i = node.operators_begin; i < node.operators_end; ++i) {
+            log << "AbstractOperator #" << node_operator_ids[i] << endl;
         }
-        if (node->is_leaf_node()) {
+        if (node.var_id == Node::LEAF_NODE) {
             log << "leaf node." << endl;
-            assert(!node->successors);
-            assert(!node->star_successor);
+            assert(node.star_successor == -1);
         } else {
-            for (int val = 0; val < node->var_domain_size; ++val) {
-                if (node->successors[val]) {
+            for (int val = 0; val < node.var_domain_size; ++val) {
+                int successor = successor_ids[node.successors_begin + val];
+                if (successor != -1) {
                     log << "recursive call for child with value " << val << endl;
-                    dump_recursive(node->successors[val], log);
+                    dump_recursive(successor, log);
                     log << "back from recursive call (for successors[" << val
-                        << "]) to node with var_id = " << node->var_id
+                        << "]) to node with var_id = " << node.var_id
                         << endl;
                 } else {
                     log << "no child for value " << val << endl;
                 }
             }
-            if (node->star_successor) {
+            if (node.star_successor != -1) {
                 log << "recursive call for star_successor" << endl;
-                dump_recursive(node->star_successor, log);
+                dump_recursive(node.star_successor, log);
                 log << "back from recursive call (for star_successor) "
-                    << "to node with var_id = " << node->var_id << endl;
+                    << "to node with var_id = " << node.var_id << endl;
             } else {
                 log << "no star_successor" << endl;
             }
@@ -211,7 +264,8 @@ void MatchTree::dump_recursive(Node *node, utils::LogProxy &log) const {
 
 void MatchTree::dump(utils::LogProxy &log) const {
     if (log.is_at_least_debug()) {
-        dump_recursive(root, log);
+        assert(finalized);
+        dump_recursive(0, log);
     }
 }
 }
@@ -20,6 +20,12 @@ class Projection;
 /*
   Successor Generator for abstract operators.
 
+  The match tree is built from linked nodes by calling insert for all
+  abstract operators. Afterwards, finalize() converts it into flat vectors
+  with the nodes in breadth-first order, which are used for all queries.
+  This keeps the nodes close together in memory and avoids following
+  pointers when computing applicable operators during PDB construction.
+
   NOTE: MatchTree keeps a reference to the task proxy passed to the constructor.
   Therefore, users of the class must ensure that the task lives at least as long
   as the match tree.
@@ -30,13 +36,32 @@ class MatchTree {
     Projection projection;
     struct Node;
     Node *root;
+
+    struct FlatNode {
+        // Pattern index of the variable tested by the node, -1 for leaves.
+        int var_id;
+        int var_multiplier;
+        int var_domain_size;
+        // Position of the successor for value 0 in successor_ids.
+        int successors_begin;
+        int star_successor;
+        // Range of the operators applicable at this node in node_operator_ids.
+        int operators_begin;
+        int operators_end;
+    };
+    std::vector<FlatNode> nodes;
+    // Successor node IDs (or -1) for all values of all inner nodes.
+    std::vector<int> successor_ids;
+    std::vector<int> node_operator_ids;
+    bool finalized;
+
     void insert_recursive(int op_id,
                           const std::vector<FactPair> &regression_preconditions,
                           int pre_index,
                           Node **edge_from_parent);
     void get_applicable_operator_ids_recursive(
-        Node *node, int state_index, std::vector<int> &operator_ids) const;
-    void dump_recursive(Node *node, utils::LogProxy &log) const;
+        int node_id, int state_index, std::vector<int> &operator_ids) const;
+    void dump_recursive(int node_id, utils::LogProxy &log) const;
 public:
     /*
       Initialize an empty match tree. We copy projection to ensure that the
@@ -49,6 +74,13 @@ public:
        enlarging it. */
     void insert(int op_id, const std::vector<FactPair> &regression_preconditions);
 
+    /*
+      Convert the tree into its flat representation. This must be called
+      once after all operators have been inserted and before querying the
+      tree.
+    */
+    void finalize();
+
     /*
       Extracts all IDs of applicable abstract operators for the abstract state
       given by state_index (the index is converted back to variable/values
@@ -6,6 +6,9 @@
 
 #include "../algorithms/max_cliques.h"
 
+#include <algorithm>
+#include <cassert>
+
 using namespace std;
 
 namespace pdbs {
@@ -60,6 +63,68 @@ shared_ptr<vector<PatternClique>> compute_pattern_cliques(
     return max_cliques;
 }
 
+shared_ptr<vector<PatternClique>> compute_pattern_cliques_with_new_pattern(
+    const PatternCollection &patterns,
+    const vector<PatternClique> &known_pattern_cliques,
+    const VariableAdditivity &are_additive) {
+    assert(!patterns.empty());
+    PatternID new_pattern_id = patterns.size() - 1;
+    const Pattern &new_pattern = patterns.back();
+    vector<bool> is_additive_with_new_pattern(new_pattern_id);
+    for (PatternID pattern_id = 0; pattern_id < new_pattern_id; ++pattern_id) {
+        is_additive_with_new_pattern[pattern_id] = are_patterns_additive(
+            new_pattern, patterns[pattern_id], are_additive);
+    }
+
+    shared_ptr<vector<PatternClique>> max_cliques =
+        make_shared<vector<PatternClique>>();
+    vector<PatternClique> subcliques;
+    subcliques.reserve(known_pattern_cliques.size());
+    for (const PatternClique &known_clique : known_pattern_cliques) {
+        PatternClique subclique;
+        for (PatternID pattern_id : known_clique) {
+            if (is_additive_with_new_pattern[pattern_id]) {
+                subclique.push_back(pattern_id);
+            }
+        }
+        if (subclique.size() != known_clique.size()) {
+            // The new pattern cannot extend this clique, so it stays maximal.
+            max_cliques->push_back(known_clique);
+        }
+        sort(subclique.begin(), subclique.end());
+        subcliques.push_back(move(subclique));
+    }
+    if (subcliques.empty()) {
+        // There are no other patterns.
+        subcliques.emplace_back();
+    }
+
+    /*
+      Keep the subcliques that are not contained in another one. Checking
+      larger subcliques first means we only need to compare against
+      subcliques that have already been kept.
+    */
+    stable_sort(subcliques.begin(), subcliques.end(),
+                [](const PatternClique &clique1, const PatternClique &clique2) {
+                    return clique1.size() > clique2.size();
+                });
+    size_t num_old_cliques = max_cliques->size();
+    for (PatternClique &subclique : subcliques) {
+        bool is_contained = any_of(
+            max_cliques->begin() + num_old_cliques, max_cliques->end(),
+            [&subclique](const PatternClique &clique) {
+                // The kept cliques already contain the new pattern.
+                return includes(clique.begin(), clique.end() - 1,
+                                subclique.begin(), subclique.end());
+            });
+        if (!is_contained) {
+            subclique.push_back(new_pattern_id);
+            max_cliques->push_back(move(subclique));
+        }
+    }
+    return max_cliques;
+}
+
 vector<PatternClique> compute_pattern_cliques_with_pattern(
     const PatternCollection &patterns,
     const vector<PatternClique> &known_pattern_cliques,
@@ -25,6 +25,22 @@ extern bool are_patterns_additive(const Pattern &pattern1,
 extern std::shared_ptr<std::vector<PatternClique>> compute_pattern_cliques(
     const PatternCollection &patterns, const VariableAdditivity &are_additive);
 
+/*
+  Given the maximal pattern cliques of all patterns except the last one,
+  compute the maximal pattern cliques of all patterns. This implements the
+  incremental update described for compute_pattern_cliques_with_pattern
+  below, except that we do not compute the maximal cliques of G_N from
+  scratch. For every old maximal clique S, the subclique S' of patterns
+  additive with the new pattern P is a clique of G_N, and every maximal
+  clique of G_N is such a subclique. Therefore, the new maximal cliques are
+  the old cliques with S' != S plus the cliques S' \union {P} for all
+  subcliques S' that are not contained in another one.
+*/
+extern std::shared_ptr<std::vector<PatternClique>> compute_pattern_cliques_with_new_pattern(
+    const PatternCollection &patterns,
+    const std::vector<PatternClique> &known_pattern_cliques,
+    const VariableAdditivity &are_additive);
+
 /*
   We compute pattern cliques S with the property that we could
   add the new pattern P to S and still have a pattern clique.
@@ -55,7 +55,7 @@ public:
             "maximum abstraction size for combo strategy",
             "1000000",
             plugins::Bounds("1", "infinity"));
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
     }
 };
 
@@ -35,6 +35,8 @@ PatternCollectionInformation PatternCollectionGeneratorDisjointCegar::compute_pa
         max_collection_size,
         max_time,
         use_wildcard_plans,
+        num_threads,
+        max_pdb_construction_memory,
         log,
         rng,
         task,
@@ -75,7 +77,7 @@ public:
             "infinity",
             plugins::Bounds("0.0", "infinity"));
         add_cegar_wildcard_option_to_feature(*this);
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
         utils::add_rng_options(*this);
 
         add_cegar_implementation_notes_to_feature(*this);
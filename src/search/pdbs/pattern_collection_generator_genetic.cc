@@ -1,8 +1,9 @@
 #include "pattern_collection_generator_genetic.h"
 
+#include "pattern_database.h"
+#include "pattern_database_factory.h"
 #include "utils.h"
 #include "validation.h"
-#include "zero_one_pdbs.h"
 
 #include "../task_proxy.h"
 
@@ -11,6 +12,7 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -161,13 +163,40 @@ bool PatternCollectionGeneratorGenetic::mark_used_variables(
 
 void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values) {
     TaskProxy task_proxy(*task);
-    for (size_t i = 0; i < pattern_collections.size(); ++i) {
+    OperatorsProxy operators = task_proxy.get_operators();
+    vector<int> operator_costs;
+    operator_costs.reserve(operators.size());
+    for (OperatorProxy op : operators) {
+        operator_costs.push_back(op.get_cost());
+    }
+
+    /*
+      We first determine the PDBs which the zero-one cost partitionings of
+      all valid pattern collections consist of. PDBs that occur several times
+      are only evaluated once, and PDBs from earlier evaluations are looked
+      up in the cache. The remaining PDBs are computed concurrently.
+    */
+    struct PDBRequest {
+        vector<int> key;
+        Pattern pattern;
+        vector<int> operator_costs;
+        int pdb_id;
+    };
+    int num_evaluated_collections = pattern_collections.size();
+    // Pattern collections after removing irrelevant variables, or nullptr if invalid.
+    vector<shared_ptr<PatternCollection>> evaluated_collections(
+        num_evaluated_collections);
+    // The IDs of the PDBs of each collection, indexing pdb_mean_h_values.
+    vector<vector<int>> collection_pdb_ids(num_evaluated_collections);
+    vector<double> pdb_mean_h_values;
+    utils::HashMap<vector<int>, int> pdb_ids_by_key;
+    vector<PDBRequest> requests;
+    for (int i = 0; i < num_evaluated_collections; ++i) {
         const auto &collection = pattern_collections[i];
         if (log.is_at_least_debug()) {
             log << "evaluate pattern collection " << (i + 1) << " of "
                 << pattern_collections.size() << endl;
         }
-        double fitness = 0;
         bool pattern_valid = true;
         vector<bool> variables_used(task_proxy.get_variables().size(), false);
         shared_ptr<PatternCollection> pattern_collection = make_shared<PatternCollection>();
@@ -197,14 +226,80 @@ void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values)
             pattern_collection->push_back(pattern);
         }
         if (!pattern_valid) {
+            continue;
+        }
+        evaluated_collections[i] = pattern_collection;
+
+        vector<int> remaining_operator_costs = operator_costs;
+        for (const Pattern &pattern : *pattern_collection) {
+            vector<int> key = pattern;
+            key.push_back(-1);
+            vector<int> relevant_operator_ids;
+            for (OperatorProxy op : operators) {
+                if (is_operator_relevant(pattern, op)) {
+                    int op_id = op.get_id();
+                    key.push_back(op_id);
+                    key.push_back(remaining_operator_costs[op_id]);
+                    relevant_operator_ids.push_back(op_id);
+                }
+            }
+
+            int pdb_id;
+            auto it = pdb_ids_by_key.find(key);
+            if (it != pdb_ids_by_key.end()) {
+                pdb_id = it->second;
+            } else {
+                pdb_id = pdb_mean_h_values.size();
+                pdb_ids_by_key[key] = pdb_id;
+                auto cached = mean_h_cache.find(key);
+                if (cached != mean_h_cache.end()) {
+                    pdb_mean_h_values.push_back(cached->second);
+                } else {
+                    pdb_mean_h_values.push_back(0);
+                    requests.push_back(
+                        {move(key), pattern, remaining_operator_costs, pdb_id});
+                }
+            }
+            collection_pdb_ids[i].push_back(pdb_id);
+
+            /* Set cost of relevant operators to 0 for further patterns
+               (action cost partitioning). */
+            for (int op_id : relevant_operator_ids) {
+                remaining_operator_costs[op_id] = 0;
+            }
+        }
+    }
+
+    utils::SharedBudget memory_budget(max_pdb_construction_memory);
+    utils::parallel_for(
+        requests.size(), num_threads, [&](int i) {
+            const PDBRequest &request = requests[i];
+            size_t estimated_memory =
+                estimate_pdb_memory(task_proxy, request.pattern);
+            memory_budget.acquire(estimated_memory);
+            pdb_mean_h_values[request.pdb_id] = compute_pdb(
+                task_proxy, request.pattern,
+                request.operator_costs)->compute_mean_finite_h();
+            memory_budget.release(estimated_memory);
+        });
+    for (PDBRequest &request : requests) {
+        mean_h_cache[move(request.key)] = pdb_mean_h_values[request.pdb_id];
+    }
+
+    for (int i = 0; i < num_evaluated_collections; ++i) {
+        const shared_ptr<PatternCollection> &pattern_collection =
+            evaluated_collections[i];
+        double fitness = 0;
+        if (!pattern_collection) {
             /* Set fitness to a very small value to cover cases in which all
                patterns are invalid. */
             fitness = 0.001;
         } else {
-            /* Generate the pattern collection heuristic and get its fitness
-               value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
-            fitness = zero_one_pdbs.compute_approx_mean_finite_h();
+            /* The fitness of the zero-one pattern collection heuristic is
+               the sum of the mean h-values of its PDBs. */
+            for (int pdb_id : collection_pdb_ids[i]) {
+                fitness += pdb_mean_h_values[pdb_id];
+            }
             // Update the best heuristic found so far.
             if (fitness > best_fitness) {
                 best_fitness = fitness;
@@ -291,6 +386,12 @@ PatternCollectionInformation PatternCollectionGeneratorGenetic::compute_patterns
     const shared_ptr<AbstractTask> &task_) {
     task = task_;
     genetic_algorithm();
+    if (log.is_at_least_normal()) {
+        log << "PDBs computed for evaluating pattern collections: "
+            << mean_h_cache.size() << endl;
+    }
+    // The cache is only valid for the current task.
+    utils::HashMap<vector<int>, double>().swap(mean_h_cache);
 
     TaskProxy task_proxy(*task);
     assert(best_patterns);
@@ -345,7 +446,7 @@ public:
             "fitness) if its patterns are not disjoint",
             "false");
         utils::add_rng_options(*this);
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
 
         document_note(
             "Note",
@@ -382,6 +483,15 @@ public:
             "generation. Therefore the mean heuristic values are normalized and "
             "converted into probabilities and Roulette Wheel Selection is used.\n",
             true);
+        document_note(
+            "Parallelization",
+            "The option num_threads also sets the number of threads that "
+            "compute the PDBs for evaluating the pattern collections. The mean "
+            "heuristic value of each PDB is cached, so pattern collections "
+            "that share patterns (under the same cost partitioning) do not "
+            "compute their PDBs again. This does not change the generated "
+            "pattern collection.",
+            true);
 
         document_language_support("action costs", "supported");
         document_language_support("conditional effects", "not supported");
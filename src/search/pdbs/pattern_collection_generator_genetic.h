@@ -4,6 +4,8 @@
 #include "pattern_generator.h"
 #include "types.h"
 
+#include "../utils/hash.h"
+
 #include <memory>
 #include <vector>
 
@@ -40,6 +42,15 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     std::shared_ptr<PatternCollection> best_patterns;
     double best_fitness;
 
+    /*
+      Mean finite h-values of all PDBs computed in earlier evaluations.
+      Under zero-one cost partitioning, the PDB for a pattern depends on the
+      pattern and on the remaining costs of the operators relevant to it.
+      The key is the pattern, followed by -1 and the IDs and remaining
+      costs of these operators.
+    */
+    utils::HashMap<std::vector<int>, double> mean_h_cache;
+
     /*
       The fitness values (from evaluate) are used as probabilities. Then
       num_collections many pattern collections are chosen from the vector of all
@@ -75,6 +86,10 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
       ( = summed up mean h-values (dead ends are ignored) of all PDBs in the
       collection) computed. The overall best heuristic is eventually updated and
       saved for further episodes.
+
+      PDBs that are not in mean_h_cache are computed concurrently. Since
+      their mean h-values are summed up in the order of the patterns
+      afterwards, the fitness values do not depend on the number of threads.
     */
     void evaluate(std::vector<double> &fitness_values);
     bool is_pattern_too_large(const Pattern &pattern) const;
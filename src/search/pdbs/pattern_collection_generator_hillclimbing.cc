@@ -17,11 +17,13 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -133,6 +135,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
     int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -159,16 +162,24 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        compute_pdb(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+    // The PDBs of the new candidates are independent and computed concurrently.
+    shared_ptr<PDBCollection> new_pdbs = compute_pdbs(
+        task_proxy, new_patterns, num_threads, max_pdb_construction_memory, 1,
+        hill_climbing_timer);
+    if (hill_climbing_timer->is_expired()) {
+        throw HillClimbingTimeout();
+    }
+    for (const shared_ptr<PatternDatabase> &new_pdb : *new_pdbs) {
+        candidate_pdbs.push_back(new_pdb);
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+    }
     return max_pdb_size;
 }
 
@@ -205,50 +216,71 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     int improvement = 0;
     int best_pdb_index = -1;
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
-    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
-        const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
-        if (!pdb) {
-            /* candidate pattern is too large or has already been added to
-               the canonical heuristic. */
-            continue;
-        }
-        /*
-          If a candidate's size added to the current collection's size exceeds
-          the maximum collection size, then forget the pdb.
-        */
-        int combined_size = current_pdbs->get_size() + pdb->get_size();
-        if (combined_size > collection_max_size) {
-            candidate_pdbs[i] = nullptr;
-            continue;
+    /*
+      We store the values of all samples in one vector and compute the
+      h-values of all samples in the PDBs of the current collection up
+      front. Each candidate then only needs to rank all samples at once.
+    */
+    int num_variables = samples.empty() ? 0 : samples[0].size();
+    vector<int> sample_values;
+    sample_values.reserve(samples.size() * num_variables);
+    for (const State &sample : samples) {
+        sample.unpack();
+        const vector<int> &values = sample.get_unpacked_values();
+        sample_values.insert(sample_values.end(), values.begin(), values.end());
+    }
+    const PDBCollection &pdbs = *current_pdbs->get_pattern_databases();
+    vector<vector<int>> samples_pdb_h_values(
+        num_samples, vector<int>(pdbs.size()));
+    vector<int> h_values;
+    for (size_t pdb_id = 0; pdb_id < pdbs.size(); ++pdb_id) {
+        pdbs[pdb_id]->get_values(sample_values, num_variables, h_values);
+        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+            samples_pdb_h_values[sample_id][pdb_id] = h_values[sample_id];
         }
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        vector<PatternClique> pattern_cliques =
-            current_pdbs->get_pattern_cliques(pdb->get_pattern());
-        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
-            const State &sample = samples[sample_id];
-            assert(utils::in_bounds(sample_id, samples_h_values));
-            int h_collection = samples_h_values[sample_id];
-            if (is_heuristic_improved(
-                    *pdb, sample, h_collection,
-                    *current_pdbs->get_pattern_databases(), pattern_cliques)) {
-                ++count;
+    /*
+      Candidates are evaluated concurrently. The samples and their h-values
+      are only read, and each candidate only writes its own entries of
+      candidate_pdbs and counts. Workers cannot throw, so they stop taking
+      candidates once the time limit is reached and we throw afterwards.
+    */
+    int num_candidates = candidate_pdbs.size();
+    vector<int> counts(num_candidates, 0);
+    atomic<bool> timed_out(false);
+    utils::parallel_for(
+        num_candidates, num_threads, [&](int i) {
+            if (timed_out || hill_climbing_timer->is_expired()) {
+                timed_out = true;
+                return;
             }
-        }
+            const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
+            if (!pdb) {
+                /* candidate pattern is too large or has already been added to
+                   the canonical heuristic. */
+                return;
+            }
+            /*
+              If a candidate's size added to the current collection's size
+              exceeds the maximum collection size, then forget the pdb.
+            */
+            int combined_size = current_pdbs->get_size() + pdb->get_size();
+            if (combined_size > collection_max_size) {
+                candidate_pdbs[i] = nullptr;
+                return;
+            }
+            counts[i] = count_improved_samples(
+                *pdb, sample_values, num_variables, samples_h_values,
+                samples_pdb_h_values);
+        });
+    if (timed_out) {
+        throw HillClimbingTimeout();
+    }
+
+    // Search for the best improving pattern/pdb in the order of the candidates.
+    for (int i = 0; i < num_candidates; ++i) {
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -262,13 +294,35 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     return make_pair(improvement, best_pdb_index);
 }
 
-bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
-    const PatternDatabase &pdb, const State &sample, int h_collection,
-    const PDBCollection &pdbs, const vector<PatternClique> &pattern_cliques) {
-    const vector<int> &sample_data = sample.get_unpacked_values();
-    // h_pattern: h-value of the new pattern
-    int h_pattern = pdb.get_value(sample_data);
+int PatternCollectionGeneratorHillclimbing::count_improved_samples(
+    const PatternDatabase &pdb, const vector<int> &sample_values,
+    int num_variables, const vector<int> &samples_h_values,
+    const vector<vector<int>> &samples_pdb_h_values) const {
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    int count = 0;
+    vector<PatternClique> pattern_cliques =
+        current_pdbs->get_pattern_cliques(pdb.get_pattern());
+    vector<int> h_values;
+    pdb.get_values(sample_values, num_variables, h_values);
+    for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+        assert(utils::in_bounds(sample_id, samples_h_values));
+        int h_collection = samples_h_values[sample_id];
+        if (is_heuristic_improved(
+                h_values[sample_id], h_collection,
+                samples_pdb_h_values[sample_id], pattern_cliques)) {
+            ++count;
+        }
+    }
+    return count;
+}
 
+bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
+    int h_pattern, int h_collection, const vector<int> &pdb_h_values,
+    const vector<PatternClique> &pattern_cliques) const {
     if (h_pattern == numeric_limits<int>::max()) {
         return true;
     }
@@ -277,18 +331,14 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
     if (h_collection == numeric_limits<int>::max())
         return false;
 
-    vector<int> h_values;
-    h_values.reserve(pdbs.size());
-    for (const shared_ptr<PatternDatabase> &p : pdbs) {
-        int h = p->get_value(sample_data);
+    for (int h : pdb_h_values) {
         if (h == numeric_limits<int>::max())
             return false;
-        h_values.push_back(h);
     }
     for (const PatternClique &clilque : pattern_cliques) {
         int h_clique = 0;
         for (PatternID pattern_id : clilque) {
-            h_clique += h_values[pattern_id];
+            h_clique += pdb_h_values[pattern_id];
         }
         if (h_pattern + h_clique > h_collection) {
             /*
@@ -320,21 +370,6 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     PDBCollection candidate_pdbs;
     // The maximum size over all PDBs in candidate_pdbs.
     int max_pdb_size = 0;
-    for (const shared_ptr<PatternDatabase> &current_pdb :
-         *(current_pdbs->get_pattern_databases())) {
-        int new_max_pdb_size = generate_candidate_pdbs(
-            task_proxy, relevant_neighbours, *current_pdb, generated_patterns,
-            candidate_pdbs);
-        max_pdb_size = max(max_pdb_size, new_max_pdb_size);
-    }
-    /*
-      NOTE: The initial set of candidate patterns (in generated_patterns) is
-      guaranteed to be "normalized" in the sense that there are no duplicates
-      and patterns are sorted.
-    */
-    if (log.is_at_least_normal()) {
-        log << "Done calculating initial candidate PDBs" << endl;
-    }
 
     int num_iterations = 0;
     State initial_state = task_proxy.get_initial_state();
@@ -344,6 +379,22 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     vector<int> samples_h_values;
 
     try {
+        for (const shared_ptr<PatternDatabase> &current_pdb :
+             *(current_pdbs->get_pattern_databases())) {
+            int new_max_pdb_size = generate_candidate_pdbs(
+                task_proxy, relevant_neighbours, *current_pdb, generated_patterns,
+                candidate_pdbs);
+            max_pdb_size = max(max_pdb_size, new_max_pdb_size);
+        }
+        /*
+          NOTE: The initial set of candidate patterns (in generated_patterns)
+          is guaranteed to be "normalized" in the sense that there are no
+          duplicates and patterns are sorted.
+        */
+        if (log.is_at_least_normal()) {
+            log << "Done calculating initial candidate PDBs" << endl;
+        }
+
         while (true) {
             ++num_iterations;
             int init_h = current_pdbs->get_value(initial_state);
@@ -518,6 +569,12 @@ void add_hillclimbing_options(plugins::Feature &feature) {
         "search. This is similar to the techniques used in the original "
         "implementation as described in the paper.",
         true);
+    feature.document_note(
+        "Parallelization",
+        "The option num_threads also sets the number of threads that compute "
+        "the PDBs of new candidate patterns and evaluate the candidates on the "
+        "samples. This does not change the generated pattern collection.",
+        true);
 
     feature.add_option<int>(
         "pdb_max_size",
@@ -552,7 +609,7 @@ void add_hillclimbing_options(plugins::Feature &feature) {
         "infinity",
         plugins::Bounds("0.0", "infinity"));
     utils::add_rng_options(feature);
-    add_generator_options_to_feature(feature);
+    add_collection_generator_options_to_feature(feature);
 }
 
 void check_hillclimbing_options(
@@ -650,16 +707,23 @@ public:
             make_shared<PatternCollectionGeneratorHillclimbing>(options);
 
         plugins::Options heuristic_opts;
+        heuristic_opts.set_unparsed_config(options.get_unparsed_config());
         heuristic_opts.set<utils::Verbosity>(
             "verbosity", options.get<utils::Verbosity>("verbosity"));
         heuristic_opts.set<shared_ptr<AbstractTask>>(
             "transform", options.get<shared_ptr<AbstractTask>>("transform"));
         heuristic_opts.set<bool>(
             "cache_estimates", options.get<bool>("cache_estimates"));
+        heuristic_opts.set<bool>(
+            "cache_estimates_persistently",
+            options.get<bool>("cache_estimates_persistently"));
         heuristic_opts.set<shared_ptr<PatternCollectionGenerator>>(
             "patterns", pgh);
         heuristic_opts.set<double>(
             "max_time_dominance_pruning", options.get<double>("max_time_dominance_pruning"));
+        heuristic_opts.set<int>(
+            "num_threads_dominance_pruning",
+            options.get<int>("num_threads_dominance_pruning"));
 
         return make_shared<CanonicalPDBsHeuristic>(heuristic_opts);
     }
@@ -85,17 +85,32 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
         PDBCollection &candidate_pdbs);
 
     /*
-      Returns true iff the h-value of the new pattern (from pdb) plus the
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the PDB was included into it.
+      sample_values holds the values of all samples one after the other,
+      samples_pdb_h_values[i] the h-values of the i-th sample in all PDBs of
+      the current collection. This method may be called concurrently.
+    */
+    int count_improved_samples(
+        const PatternDatabase &pdb,
+        const std::vector<int> &sample_values,
+        int num_variables,
+        const std::vector<int> &samples_h_values,
+        const std::vector<std::vector<int>> &samples_pdb_h_values) const;
+
+    /*
+      Returns true iff the h-value of the new pattern (h_pattern) plus the
       h-value of all pattern cliques from the current pattern
       collection heuristic if the new pattern was added to it is greater than
-      the h-value of the current pattern collection.
+      the h-value of the current pattern collection. pdb_h_values holds the
+      h-values of the sample for all PDBs of the current collection.
     */
     bool is_heuristic_improved(
-        const PatternDatabase &pdb,
-        const State &sample,
+        int h_pattern,
         int h_collection,
-        const PDBCollection &pdbs,
-        const std::vector<PatternClique> &pattern_cliques);
+        const std::vector<int> &pdb_h_values,
+        const std::vector<PatternClique> &pattern_cliques) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
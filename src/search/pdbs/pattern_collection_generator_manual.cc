@@ -37,7 +37,7 @@ public:
             "patterns",
             "list of patterns (which are lists of variable numbers of the planning "
             "task).");
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
     }
 };
 
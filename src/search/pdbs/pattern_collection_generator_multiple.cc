@@ -260,7 +260,10 @@ void add_multiple_algorithm_implementation_notes_to_feature(
         "exiting early if no new patterns are found for a certain time ('stagnation'). "
         "Further parameters allow enabling blacklisting for the given pattern computation "
         "method after a certain time to force some diversification or to enable said "
-        "blacklisting when stagnating.",
+        "blacklisting when stagnating.\n"
+        "The PDBs of the generated patterns are computed one at a time, so "
+        "num_threads is only used within the computation of each PDB and "
+        "max_pdb_construction_memory is always respected.",
         true);
     feature.document_note(
         "Implementation note about the 'multiple algorithm framework'",
@@ -322,7 +325,7 @@ void add_multiple_options_to_feature(plugins::Feature &feature) {
         "generation is terminated already the first time stagnation_limit is "
         "hit.",
         "true");
-    add_generator_options_to_feature(feature);
+    add_collection_generator_options_to_feature(feature);
     utils::add_rng_options(feature);
 }
 }
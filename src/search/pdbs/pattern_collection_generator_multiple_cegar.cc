@@ -32,6 +32,7 @@ PatternInformation PatternCollectionGeneratorMultipleCegar::compute_pattern(
         max_pdb_size,
         max_time,
         use_wildcard_plans,
+        num_threads,
         silent_log,
         rng,
         task,
@@ -48,6 +48,7 @@ PatternInformation PatternCollectionGeneratorMultipleRandom::compute_pattern(
         cg_neighbors);
 
     PatternInformation result(TaskProxy(*task), move(pattern), log);
+    result.set_pdb_construction_options(num_threads, 1);
     return result;
 }
 
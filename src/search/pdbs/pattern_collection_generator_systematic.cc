@@ -311,7 +311,7 @@ public:
             "Only consider the union of two disjoint patterns if the union has "
             "more information than the individual patterns.",
             "true");
-        add_generator_options_to_feature(*this);
+        add_collection_generator_options_to_feature(*this);
     }
 };
 
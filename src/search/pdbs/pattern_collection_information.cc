@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <unordered_set>
 #include <utility>
 
@@ -24,7 +25,10 @@ PatternCollectionInformation::PatternCollectionInformation(
       patterns(patterns),
       pdbs(nullptr),
       pattern_cliques(nullptr),
-      log(log) {
+      log(log),
+      num_threads(1),
+      max_pdb_construction_memory(numeric_limits<size_t>::max()),
+      pdb_compression_factor(1) {
     assert(patterns);
     validate_and_normalize_patterns(task_proxy, *patterns, log);
 }
@@ -63,12 +67,9 @@ void PatternCollectionInformation::create_pdbs_if_missing() {
         if (log.is_at_least_normal()) {
             log << "Computing PDBs for pattern collection..." << endl;
         }
-        pdbs = make_shared<PDBCollection>();
-        for (const Pattern &pattern : *patterns) {
-            shared_ptr<PatternDatabase> pdb =
-                compute_pdb(task_proxy, pattern);
-            pdbs->push_back(pdb);
-        }
+        pdbs = compute_pdbs(
+            task_proxy, *patterns, num_threads, max_pdb_construction_memory,
+            pdb_compression_factor);
         if (log.is_at_least_normal()) {
             log << "Done computing PDBs for pattern collection: "
                 << timer << endl;
@@ -76,6 +77,29 @@ void PatternCollectionInformation::create_pdbs_if_missing() {
     }
 }
 
+void PatternCollectionInformation::compress_pdbs_if_necessary() {
+    assert(pdbs);
+    /*
+      PDBs set by pattern collection generators are not compressed yet.
+      We replace the collection instead of modifying it because it may
+      be shared with the generator.
+    */
+    bool is_compressed = all_of(
+        pdbs->begin(), pdbs->end(),
+        [&](const shared_ptr<PatternDatabase> &pdb) {
+            return pdb->get_compression_factor() == pdb_compression_factor;
+        });
+    if (!is_compressed) {
+        shared_ptr<PDBCollection> compressed_pdbs = make_shared<PDBCollection>();
+        compressed_pdbs->reserve(pdbs->size());
+        for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
+            compressed_pdbs->push_back(
+                make_shared<PatternDatabase>(*pdb, pdb_compression_factor));
+        }
+        pdbs = compressed_pdbs;
+    }
+}
+
 void PatternCollectionInformation::create_pattern_cliques_if_missing() {
     if (!pattern_cliques) {
         utils::Timer timer;
@@ -91,6 +115,16 @@ void PatternCollectionInformation::create_pattern_cliques_if_missing() {
     }
 }
 
+void PatternCollectionInformation::set_pdb_construction_options(
+    int num_threads_, size_t max_pdb_construction_memory_,
+    int pdb_compression_factor_) {
+    assert(num_threads_ >= 1);
+    assert(pdb_compression_factor_ >= 1);
+    num_threads = num_threads_;
+    max_pdb_construction_memory = max_pdb_construction_memory_;
+    pdb_compression_factor = pdb_compression_factor_;
+}
+
 void PatternCollectionInformation::set_pdbs(const shared_ptr<PDBCollection> &pdbs_) {
     pdbs = pdbs_;
     assert(information_is_valid());
@@ -109,6 +143,7 @@ shared_ptr<PatternCollection> PatternCollectionInformation::get_patterns() const
 
 shared_ptr<PDBCollection> PatternCollectionInformation::get_pdbs() {
     create_pdbs_if_missing();
+    compress_pdbs_if_necessary();
     return pdbs;
 }
 
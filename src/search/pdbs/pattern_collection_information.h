@@ -5,6 +5,7 @@
 
 #include "../task_proxy.h"
 
+#include <cstddef>
 #include <memory>
 
 namespace utils {
@@ -30,8 +31,12 @@ class PatternCollectionInformation {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
     utils::LogProxy &log;
+    int num_threads;
+    std::size_t max_pdb_construction_memory;
+    int pdb_compression_factor;
 
     void create_pdbs_if_missing();
+    void compress_pdbs_if_necessary();
     void create_pattern_cliques_if_missing();
 
     bool information_is_valid() const;
@@ -42,6 +47,14 @@ public:
         utils::LogProxy &log);
     ~PatternCollectionInformation() = default;
 
+    /*
+      Set the number of threads and the memory budget (in bytes) used for
+      computing missing PDBs (see compute_pdbs) and the compression factor
+      of all returned PDBs (see PatternDatabase).
+    */
+    void set_pdb_construction_options(
+        int num_threads, std::size_t max_pdb_construction_memory,
+        int pdb_compression_factor);
     void set_pdbs(const std::shared_ptr<PDBCollection> &pdbs);
     void set_pattern_cliques(
         const std::shared_ptr<std::vector<PatternClique>> &pattern_cliques);
@@ -2,9 +2,11 @@
 
 #include "../task_utils/task_properties.h"
 
+#include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -49,6 +51,25 @@ int Projection::rank(const vector<int> &state) const {
     return index;
 }
 
+void Projection::rank(
+    const vector<int> &states, int num_variables, vector<int> &ranks) const {
+    assert(num_variables > 0);
+    assert(states.size() % num_variables == 0);
+    size_t num_states = states.size() / num_variables;
+    ranks.assign(num_states, 0);
+    /*
+      We rank variable by variable, so the inner loop performs the same
+      multiply-add for all states and can be vectorized by the compiler.
+    */
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        int multiplier = hash_multipliers[i];
+        const int *values = states.data() + pattern[i];
+        for (size_t j = 0; j < num_states; ++j) {
+            ranks[j] += multiplier * values[j * num_variables];
+        }
+    }
+}
+
 int Projection::unrank(int index, int var) const {
     int temp = index / hash_multipliers[var];
     return temp % domain_sizes[var];
@@ -58,19 +79,123 @@ PatternDatabase::PatternDatabase(
     Projection &&projection,
     vector<int> &&distances)
     : projection(move(projection)),
-      distances(move(distances)) {
+      compression_factor(1) {
+    assert(static_cast<int>(distances.size()) ==
+           this->projection.get_num_abstract_states());
+    pack_distances(distances);
+    utils::release_vector_memory(distances);
+}
+
+PatternDatabase::PatternDatabase(
+    const PatternDatabase &pdb, int compression_factor)
+    : projection(pdb.projection),
+      compression_factor(compression_factor) {
+    assert(compression_factor >= 1);
+    int num_states = projection.get_num_abstract_states();
+    int num_entries = (num_states - 1) / compression_factor + 1;
+    vector<int> distances(num_entries, numeric_limits<int>::max());
+    for (int state_index = 0; state_index < num_states; ++state_index) {
+        int &entry = distances[state_index / compression_factor];
+        entry = min(entry, pdb.get_distance(state_index));
+    }
+    pack_distances(distances);
+}
+
+PatternDatabase::PatternDatabase(
+    Projection &&projection, int compression_factor, int bits_per_entry,
+    const shared_ptr<const uint64_t> &packed_distances,
+    size_t num_packed_words)
+    : projection(move(projection)),
+      compression_factor(compression_factor),
+      packed_distances(packed_distances),
+      num_packed_words(num_packed_words) {
+    set_bits_per_entry(bits_per_entry);
+    assert(num_packed_words == compute_num_packed_words(
+               this->projection.get_num_abstract_states(),
+               compression_factor, bits_per_entry));
+}
+
+size_t PatternDatabase::compute_num_packed_words(
+    int num_abstract_states, int compression_factor, int bits_per_entry) {
+    size_t num_entries = (num_abstract_states - 1) / compression_factor + 1;
+    size_t entries_per_word = 64 / bits_per_entry;
+    return (num_entries + entries_per_word - 1) / entries_per_word;
+}
+
+void PatternDatabase::set_bits_per_entry(int bits) {
+    assert(bits == 1 || bits == 2 || bits == 4 || bits == 8 ||
+           bits == 16 || bits == 32);
+    bits_per_entry = bits;
+    log_entries_per_word = 6;
+    for (int width = 1; width < bits; width *= 2) {
+        --log_entries_per_word;
+    }
+    entry_mask = (uint64_t(1) << bits_per_entry) - 1;
+}
+
+void PatternDatabase::pack_distances(const vector<int> &distances) {
+    int max_finite_distance = 0;
+    for (int distance : distances) {
+        if (distance != numeric_limits<int>::max()) {
+            max_finite_distance = max(max_finite_distance, distance);
+        }
+    }
+    // Find the smallest width that leaves the largest value for dead ends.
+    int bits = 1;
+    while (bits < 32 &&
+           static_cast<uint64_t>(max_finite_distance) >= (uint64_t(1) << bits) - 1) {
+        bits *= 2;
+    }
+    set_bits_per_entry(bits);
+
+    int entries_per_word = 1 << log_entries_per_word;
+    num_packed_words =
+        (distances.size() + entries_per_word - 1) / entries_per_word;
+    shared_ptr<vector<uint64_t>> words =
+        make_shared<vector<uint64_t>>(num_packed_words, 0);
+    for (size_t i = 0; i < distances.size(); ++i) {
+        uint64_t value = distances[i] == numeric_limits<int>::max() ?
+            entry_mask : distances[i];
+        (*words)[i >> log_entries_per_word] |=
+            value << ((i & (entries_per_word - 1)) * bits_per_entry);
+    }
+    // Share ownership of the vector, but point to its data.
+    packed_distances = shared_ptr<const uint64_t>(words, words->data());
+}
+
+int PatternDatabase::get_distance(int state_index) const {
+    int entry_index = compression_factor == 1 ?
+        state_index : state_index / compression_factor;
+    int entries_per_word = 1 << log_entries_per_word;
+    uint64_t value =
+        (packed_distances.get()[entry_index >> log_entries_per_word] >>
+         ((entry_index & (entries_per_word - 1)) * bits_per_entry)) & entry_mask;
+    if (value == entry_mask) {
+        return numeric_limits<int>::max();
+    }
+    return static_cast<int>(value);
 }
 
 int PatternDatabase::get_value(const vector<int> &state) const {
-    return distances[projection.rank(state)];
+    return get_distance(projection.rank(state));
+}
+
+void PatternDatabase::get_values(
+    const vector<int> &states, int num_variables, vector<int> &values) const {
+    projection.rank(states, num_variables, values);
+    for (int &value : values) {
+        value = get_distance(value);
+    }
 }
 
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+    int num_states = projection.get_num_abstract_states();
+    for (int state_index = 0; state_index < num_states; ++state_index) {
+        int distance = get_distance(state_index);
+        if (distance != numeric_limits<int>::max()) {
+            sum += distance;
             ++size;
         }
     }
@@ -80,4 +205,30 @@ double PatternDatabase::compute_mean_finite_h() const {
         return sum / size;
     }
 }
+
+PDBCollectionRanker::PDBCollectionRanker(const PDBCollection &pdbs) {
+    pattern_ends.reserve(pdbs.size());
+    for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+        const Projection &projection = pdb->get_projection();
+        const Pattern &pattern = projection.get_pattern();
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            variables.push_back(pattern[i]);
+            multipliers.push_back(projection.get_multiplier(i));
+        }
+        pattern_ends.push_back(variables.size());
+    }
+}
+
+void PDBCollectionRanker::rank(
+    const vector<int> &state, vector<int> &ranks) const {
+    ranks.resize(pattern_ends.size());
+    int entry = 0;
+    for (size_t i = 0; i < pattern_ends.size(); ++i) {
+        int rank = 0;
+        for (int end = pattern_ends[i]; entry < end; ++entry) {
+            rank += multipliers[entry] * state[variables[entry]];
+        }
+        ranks[i] = rank;
+    }
+}
 }
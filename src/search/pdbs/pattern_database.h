@@ -5,6 +5,8 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace pdbs {
@@ -19,6 +21,15 @@ public:
     // Compute the hash index (aka. the rank) of the given concrete state.
     int rank(const std::vector<int> &state) const;
 
+    /*
+      Compute the ranks of several concrete states at once. The states are
+      given by their values, which are stored one state after the other in
+      states with num_variables values per state.
+    */
+    void rank(
+        const std::vector<int> &states, int num_variables,
+        std::vector<int> &ranks) const;
+
     /*
       Compute the value of a given variable in the abstract state given as
       (hash) index.
@@ -42,16 +53,74 @@ class PatternDatabase {
     Projection projection;
 
     /*
-      final h-values for abstract-states.
-      dead-ends are represented by numeric_limits<int>::max()
+      final h-values for abstract-states, bit-packed into 64-bit words.
+      Each entry uses the smallest number of bits out of 1, 2, 4, 8, 16
+      and 32 that suffices for all finite h-values. The largest value an
+      entry can hold represents dead ends.
+
+      With a compression factor k > 1, an entry holds the minimal h-value
+      of k abstract states with consecutive ranks.
+
+      The words are either owned by the PDB or belong to a memory-mapped
+      PDB file (see pattern_database_files.h), which packed_distances keeps
+      alive.
     */
-    std::vector<int> distances;
+    int compression_factor;
+    int bits_per_entry;
+    int log_entries_per_word;
+    std::uint64_t entry_mask;
+    std::shared_ptr<const std::uint64_t> packed_distances;
+    std::size_t num_packed_words;
+
+    void set_bits_per_entry(int bits_per_entry);
+    void pack_distances(const std::vector<int> &distances);
 public:
+    /*
+      Dead ends in distances must be represented by
+      numeric_limits<int>::max().
+    */
     PatternDatabase(
         Projection &&projection,
         std::vector<int> &&distances);
+    /*
+      Create a copy of pdb whose distance table entries each hold the
+      minimal h-value of compression_factor abstract states with
+      consecutive ranks. The resulting heuristic is admissible but not
+      necessarily consistent.
+    */
+    PatternDatabase(const PatternDatabase &pdb, int compression_factor);
+    /*
+      Create a PDB that uses the given packed distance table (as returned
+      by get_packed_distances) without copying it.
+    */
+    PatternDatabase(
+        Projection &&projection, int compression_factor, int bits_per_entry,
+        const std::shared_ptr<const std::uint64_t> &packed_distances,
+        std::size_t num_packed_words);
+    /*
+      Return the h-value of the given state. Dead ends are represented by
+      numeric_limits<int>::max().
+    */
     int get_value(const std::vector<int> &state) const;
 
+    /*
+      Compute the h-values of several states at once. The states are given
+      as for Projection::rank.
+    */
+    void get_values(
+        const std::vector<int> &states, int num_variables,
+        std::vector<int> &values) const;
+
+    /*
+      Return the h-value of the abstract state with the given rank. Dead
+      ends are represented by numeric_limits<int>::max().
+    */
+    int get_distance(int state_index) const;
+
+    const Projection &get_projection() const {
+        return projection;
+    }
+
     const Pattern &get_pattern() const {
         return projection.get_pattern();
     }
@@ -61,6 +130,34 @@ public:
         return projection.get_num_abstract_states();
     }
 
+    int get_compression_factor() const {
+        return compression_factor;
+    }
+
+    int get_bits_per_entry() const {
+        return bits_per_entry;
+    }
+
+    const std::uint64_t *get_packed_distances() const {
+        return packed_distances.get();
+    }
+
+    std::size_t get_num_packed_words() const {
+        return num_packed_words;
+    }
+
+    // Return the memory (in bytes) of the distance table.
+    std::size_t get_distance_table_memory() const {
+        return num_packed_words * sizeof(std::uint64_t);
+    }
+
+    /*
+      Return the number of packed words needed for a PDB with the given
+      number of abstract states, compression factor and entry width.
+    */
+    static std::size_t compute_num_packed_words(
+        int num_abstract_states, int compression_factor, int bits_per_entry);
+
     /*
       Return the average h-value over all states, where dead-ends are
       ignored (they neither increase the sum of all h-values nor the
@@ -71,6 +168,25 @@ public:
     */
     double compute_mean_finite_h() const;
 };
+
+/*
+  Ranks states for all PDBs of a collection at once. The pattern variables
+  and hash multipliers of all PDBs are stored in one contiguous table, so
+  ranking a state for the whole collection does not follow the pointers
+  to the individual projections.
+*/
+class PDBCollectionRanker {
+    std::vector<int> variables;
+    std::vector<int> multipliers;
+    // The entries of the i-th PDB end at pattern_ends[i] in the table.
+    std::vector<int> pattern_ends;
+public:
+    PDBCollectionRanker() = default;
+    explicit PDBCollectionRanker(const PDBCollection &pdbs);
+
+    // Set ranks[i] to the rank of the given state in the i-th PDB.
+    void rank(const std::vector<int> &state, std::vector<int> &ranks) const;
+};
 }
 
 #endif
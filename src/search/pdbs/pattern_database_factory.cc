@@ -6,27 +6,58 @@
 
 #include "../algorithms/priority_queues.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
 #include "../utils/math.h"
+#include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <limits>
+#include <memory>
 #include <vector>
 
 using namespace std;
 
 namespace pdbs {
+/*
+  Distances are computed layer by layer with a bucket queue if all
+  abstract operators cost at most this much. Otherwise, we use Dijkstra's
+  algorithm with a general priority queue.
+*/
+static const int MAX_COST_FOR_LAYERED_SEARCH = 100;
+/*
+  Number of states of a layer that a thread regresses before the
+  resulting distance updates are applied. This bounds the memory used
+  for buffering updates.
+*/
+static const int STATES_PER_BLOCK = 1 << 12;
+static const int INF = numeric_limits<int>::max();
+
 class PatternDatabaseFactory {
     const TaskProxy &task_proxy;
     VariablesProxy variables;
     Projection projection;
     vector<int> variable_to_index;
     vector<AbstractOperator> abstract_ops;
+    /*
+      Preconditions of the abstract operators for progression search.
+      They are only computed for searching plans with lower bounds.
+    */
+    bool compute_progression_preconditions;
+    vector<vector<FactPair>> progression_preconditions;
     vector<FactPair> abstract_goals;
     vector<int> distances;
     vector<int> generating_op_ids;
+    int initial_state_index;
+    int initial_state_distance;
+    // Abstract operator IDs of the plan that compute_plan extracts.
+    vector<int> abstract_plan;
+    int num_expanded_states;
     vector<vector<OperatorID>> wildcard_plan;
+    int num_threads;
 
     void compute_variable_to_index(const Pattern &pattern);
 
@@ -58,7 +89,7 @@ class PatternDatabaseFactory {
         vector<FactPair> &pre_pairs,
         vector<FactPair> &eff_pairs,
         const vector<FactPair> &effects_without_pre,
-        vector<AbstractOperator> &operators) const;
+        vector<AbstractOperator> &operators);
 
     /*
       Computes all abstract operators for a given concrete operator (by
@@ -69,7 +100,7 @@ class PatternDatabaseFactory {
     void build_abstract_operators_for_op(
         const OperatorProxy &op,
         int cost,
-        vector<AbstractOperator> &operators) const;
+        vector<AbstractOperator> &operators);
 
     void compute_abstract_operators(const vector<int> &operator_costs);
 
@@ -80,6 +111,7 @@ class PatternDatabaseFactory {
       Node class used by MatchTree.
     */
     unique_ptr<MatchTree> compute_match_tree() const;
+    unique_ptr<MatchTree> compute_progression_match_tree() const;
 
     void compute_abstract_goals();
 
@@ -91,8 +123,32 @@ class PatternDatabaseFactory {
     */
     bool is_goal_state(int state_index) const;
 
+    int compute_max_abstract_operator_cost() const;
+
     void compute_distances(const MatchTree &match_tree, bool compute_plan);
 
+    /*
+      Compute the goal distances like compute_distances, but expand the
+      abstract states in layers of equal distance, using circular buckets
+      for the next max_cost layers. The states of a layer are regressed
+      concurrently by num_threads threads. The distances do not depend on
+      the number of threads.
+    */
+    void compute_distances_by_layers(const MatchTree &match_tree, int max_cost);
+
+    // Follow the generating operators stored by compute_distances.
+    void compute_abstract_plan_from_generating_ops();
+
+    /*
+      Search an optimal abstract plan with A* from the abstract initial
+      state. The goal distances of the given PDBs, whose patterns are
+      subsets of the pattern, are lower bounds for the goal distances in
+      the projection, and their maximum is a consistent heuristic.
+    */
+    void search_abstract_plan(
+        const MatchTree &progression_match_tree,
+        const PDBCollection &lower_bound_pdbs);
+
     void compute_plan(
         const MatchTree &match_tree,
         const shared_ptr<utils::RandomNumberGenerator> &rng,
@@ -104,9 +160,19 @@ public:
         const vector<int> &operator_costs = vector<int>(),
         bool compute_plan = false,
         const shared_ptr<utils::RandomNumberGenerator> &rng = nullptr,
-        bool compute_wildcard_plan = false);
+        bool compute_wildcard_plan = false,
+        int num_threads = 1,
+        const PDBCollection *lower_bound_pdbs = nullptr);
     ~PatternDatabaseFactory() = default;
 
+    int get_initial_state_distance() const {
+        return initial_state_distance;
+    }
+
+    int get_num_expanded_states() const {
+        return num_expanded_states;
+    }
+
     shared_ptr<PatternDatabase> extract_pdb() {
         return make_shared<PatternDatabase>(
             move(projection),
@@ -163,7 +229,7 @@ void PatternDatabaseFactory::multiply_out(
     vector<FactPair> &pre_pairs,
     vector<FactPair> &eff_pairs,
     const vector<FactPair> &effects_without_pre,
-    vector<AbstractOperator> &operators) const {
+    vector<AbstractOperator> &operators) {
     if (pos == static_cast<int>(effects_without_pre.size())) {
         // All effects without precondition have been checked: insert op.
         if (!eff_pairs.empty()) {
@@ -171,6 +237,13 @@ void PatternDatabaseFactory::multiply_out(
                 build_abstract_operator(
                     prev_pairs, pre_pairs, eff_pairs,
                     concrete_op_id, cost));
+            if (compute_progression_preconditions) {
+                vector<FactPair> preconditions(prev_pairs);
+                preconditions.insert(
+                    preconditions.end(), pre_pairs.begin(), pre_pairs.end());
+                sort(preconditions.begin(), preconditions.end());
+                progression_preconditions.push_back(move(preconditions));
+            }
         }
     } else {
         // For each possible value for the current variable, build an
@@ -201,7 +274,7 @@ void PatternDatabaseFactory::multiply_out(
 void PatternDatabaseFactory::build_abstract_operators_for_op(
     const OperatorProxy &op,
     int cost,
-    vector<AbstractOperator> &operators) const {
+    vector<AbstractOperator> &operators) {
     // All variable value pairs that are a prevail condition
     vector<FactPair> prev_pairs;
     // All variable value pairs that are a precondition (value != -1)
@@ -268,6 +341,16 @@ unique_ptr<MatchTree> PatternDatabaseFactory::compute_match_tree() const {
         const AbstractOperator &op = abstract_ops[op_id];
         match_tree->insert(op_id, op.get_regression_preconditions());
     }
+    match_tree->finalize();
+    return match_tree;
+}
+
+unique_ptr<MatchTree> PatternDatabaseFactory::compute_progression_match_tree() const {
+    unique_ptr<MatchTree> match_tree = utils::make_unique_ptr<MatchTree>(task_proxy, projection);
+    for (size_t op_id = 0; op_id < abstract_ops.size(); ++op_id) {
+        match_tree->insert(op_id, progression_preconditions[op_id]);
+    }
+    match_tree->finalize();
     return match_tree;
 }
 
@@ -349,57 +432,295 @@ void PatternDatabaseFactory::compute_distances(
     }
 }
 
-void PatternDatabaseFactory::compute_plan(
-    const MatchTree &match_tree,
-    const shared_ptr<utils::RandomNumberGenerator> &rng,
-    bool compute_wildcard_plan) {
+int PatternDatabaseFactory::compute_max_abstract_operator_cost() const {
+    int max_cost = 0;
+    for (const AbstractOperator &op : abstract_ops) {
+        max_cost = max(max_cost, op.get_cost());
+    }
+    return max_cost;
+}
+
+void PatternDatabaseFactory::compute_distances_by_layers(
+    const MatchTree &match_tree, int max_cost) {
+    int num_states = projection.get_num_abstract_states();
+    distances.assign(num_states, numeric_limits<int>::max());
+
+    /*
+      All states in a bucket have the same tentative distance because
+      successors are at most max_cost layers away from the current layer.
+    */
+    int num_buckets = max_cost + 1;
+    vector<vector<int>> buckets(num_buckets);
+    int64_t num_queued_states = 0;
+    for (int state_index = 0; state_index < num_states; ++state_index) {
+        if (is_goal_state(state_index)) {
+            distances[state_index] = 0;
+            buckets[0].push_back(state_index);
+            ++num_queued_states;
+        }
+    }
+
     /*
-      Using the generating operators computed during Dijkstra, we start
-      from the initial state and follow the generating operator to the
-      next state. Then we compute all operators of the same cost inducing
-      the same abstract transition and randomly pick one of them to
-      set for the next state. We iterate until reaching a goal state.
-      Note that this kind of plan extraction does not uniformly at random
-      consider all successor of a state but rather uses the arbitrarily
-      chosen generating operator to settle on one successor state, which
-      is biased by the number of operators leading to the same successor
-      from the given state.
+      Call improve(predecessor, cost) for all predecessors of the given
+      state whose distance would be improved by regressing the state.
     */
-    State initial_state = task_proxy.get_initial_state();
-    initial_state.unpack();
-    int current_state =
-        projection.rank(initial_state.get_unpacked_values());
-    if (distances[current_state] != numeric_limits<int>::max()) {
+    auto regress = [&](int state_index, int distance, vector<int> &op_ids,
+                       const auto &improve) {
+        if (distances[state_index] < distance) {
+            // The state has been reached on a cheaper path.
+            return;
+        }
+        op_ids.clear();
+        match_tree.get_applicable_operator_ids(state_index, op_ids);
+        for (int op_id : op_ids) {
+            const AbstractOperator &op = abstract_ops[op_id];
+            int predecessor = state_index + op.get_hash_effect();
+            int alternative_cost = distance + op.get_cost();
+            if (alternative_cost < distances[predecessor]) {
+                improve(predecessor, alternative_cost);
+            }
+        }
+    };
+
+    struct Update {
+        int state_index;
+        int distance;
+    };
+    vector<vector<Update>> updates(num_threads);
+    vector<vector<int>> applicable_operator_ids(num_threads);
+    // Only created once a layer is large enough to be split.
+    unique_ptr<utils::ThreadPool> thread_pool;
+    vector<int> layer;
+    for (int distance = 0; num_queued_states > 0; ++distance) {
+        vector<int> &bucket = buckets[distance % num_buckets];
+        /*
+          Zero-cost operators add states to the current layer, so we
+          repeat until its bucket remains empty.
+        */
+        while (!bucket.empty()) {
+            layer.clear();
+            swap(layer, bucket);
+            num_queued_states -= layer.size();
+            /*
+              Regressing the states in the order of their indices makes
+              accesses to the distances and the match tree more local.
+            */
+            sort(layer.begin(), layer.end());
+            int layer_size = layer.size();
+            for (int block_start = 0; block_start < layer_size;
+                 block_start += num_threads * STATES_PER_BLOCK) {
+                int block_size = min(layer_size - block_start,
+                                     num_threads * STATES_PER_BLOCK);
+                int num_chunks = (block_size + STATES_PER_BLOCK - 1) /
+                    STATES_PER_BLOCK;
+                int chunk_size = (block_size + num_chunks - 1) / num_chunks;
+                if (num_chunks == 1) {
+                    // Apply the updates directly instead of buffering them.
+                    for (int i = block_start; i < block_start + block_size; ++i) {
+                        regress(layer[i], distance, applicable_operator_ids[0],
+                                [&](int predecessor, int alternative_cost) {
+                                    distances[predecessor] = alternative_cost;
+                                    buckets[alternative_cost % num_buckets].push_back(
+                                        predecessor);
+                                    ++num_queued_states;
+                                });
+                    }
+                    continue;
+                }
+                /*
+                  Distances are only read while regressing the states of
+                  a block and only written while applying the updates
+                  afterwards. Applying the updates in the order of the
+                  chunks yields the same distances as processing the
+                  states sequentially.
+                */
+                if (!thread_pool) {
+                    thread_pool = utils::make_unique_ptr<utils::ThreadPool>(
+                        num_threads);
+                }
+                thread_pool->run(
+                    num_chunks, [&](int chunk) {
+                        vector<Update> &chunk_updates = updates[chunk];
+                        vector<int> &op_ids = applicable_operator_ids[chunk];
+                        chunk_updates.clear();
+                        int begin = block_start + chunk * chunk_size;
+                        int end = min(begin + chunk_size, block_start + block_size);
+                        for (int i = begin; i < end; ++i) {
+                            regress(layer[i], distance, op_ids,
+                                    [&](int predecessor, int alternative_cost) {
+                                        chunk_updates.push_back(
+                                            {predecessor, alternative_cost});
+                                    });
+                        }
+                    });
+                for (int chunk = 0; chunk < num_chunks; ++chunk) {
+                    for (const Update &update : updates[chunk]) {
+                        if (update.distance < distances[update.state_index]) {
+                            distances[update.state_index] = update.distance;
+                            buckets[update.distance % num_buckets].push_back(
+                                update.state_index);
+                            ++num_queued_states;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void PatternDatabaseFactory::compute_abstract_plan_from_generating_ops() {
+    int current_state = initial_state_index;
+    initial_state_distance = distances[current_state];
+    if (initial_state_distance != INF) {
         while (!is_goal_state(current_state)) {
             int op_id = generating_op_ids[current_state];
             assert(op_id != -1);
+            abstract_plan.push_back(op_id);
+            current_state -= abstract_ops[op_id].get_hash_effect();
+        }
+    }
+    utils::release_vector_memory(generating_op_ids);
+}
+
+void PatternDatabaseFactory::search_abstract_plan(
+    const MatchTree &progression_match_tree,
+    const PDBCollection &lower_bound_pdbs) {
+    /*
+      For each lower bound PDB, store the hash multipliers of the pattern
+      variables in the PDB (0 for variables that are not in the PDB).
+    */
+    int num_vars = projection.get_pattern().size();
+    vector<vector<int>> lower_bound_multipliers;
+    for (const shared_ptr<PatternDatabase> &pdb : lower_bound_pdbs) {
+        // Compressed PDBs are not consistent.
+        assert(pdb->get_compression_factor() == 1);
+        vector<int> multipliers(num_vars, 0);
+        const Projection &pdb_projection = pdb->get_projection();
+        const Pattern &pdb_pattern = pdb_projection.get_pattern();
+        for (size_t i = 0; i < pdb_pattern.size(); ++i) {
+            int var_index = variable_to_index[pdb_pattern[i]];
+            assert(var_index != -1);
+            multipliers[var_index] = pdb_projection.get_multiplier(i);
+        }
+        lower_bound_multipliers.push_back(move(multipliers));
+    }
+    vector<int> values(num_vars);
+    auto compute_lower_bound = [&](int state_index) {
+        for (int var = 0; var < num_vars; ++var) {
+            values[var] = projection.unrank(state_index, var);
+        }
+        int lower_bound = 0;
+        for (size_t i = 0; i < lower_bound_pdbs.size(); ++i) {
+            const vector<int> &multipliers = lower_bound_multipliers[i];
+            int pdb_index = 0;
+            for (int var = 0; var < num_vars; ++var) {
+                pdb_index += values[var] * multipliers[var];
+            }
+            lower_bound = max(
+                lower_bound, lower_bound_pdbs[i]->get_distance(pdb_index));
+        }
+        return lower_bound;
+    };
+
+    /*
+      Since the heuristic is consistent, the g-value of a state is
+      optimal when the state is expanded and we can ignore all later
+      queue entries of the state.
+    */
+    int num_states = projection.get_num_abstract_states();
+    vector<int> g_values(num_states, INF);
+    vector<int> reaching_op_ids(num_states, -1);
+    vector<bool> expanded(num_states, false);
+    priority_queues::AdaptiveQueue<int> open_list;
+    initial_state_distance = INF;
+    num_expanded_states = 0;
+    int init_h = compute_lower_bound(initial_state_index);
+    if (init_h != INF) {
+        g_values[initial_state_index] = 0;
+        open_list.push(init_h, initial_state_index);
+    }
+    vector<int> applicable_operator_ids;
+    while (!open_list.empty()) {
+        int state_index = open_list.pop().second;
+        if (expanded[state_index]) {
+            continue;
+        }
+        if (is_goal_state(state_index)) {
+            initial_state_distance = g_values[state_index];
+            for (int current_state = state_index;
+                 current_state != initial_state_index;) {
+                int op_id = reaching_op_ids[current_state];
+                abstract_plan.push_back(op_id);
+                current_state += abstract_ops[op_id].get_hash_effect();
+            }
+            reverse(abstract_plan.begin(), abstract_plan.end());
+            break;
+        }
+        expanded[state_index] = true;
+        ++num_expanded_states;
+
+        int g = g_values[state_index];
+        applicable_operator_ids.clear();
+        progression_match_tree.get_applicable_operator_ids(
+            state_index, applicable_operator_ids);
+        for (int op_id : applicable_operator_ids) {
             const AbstractOperator &op = abstract_ops[op_id];
-            int successor_state = current_state - op.get_hash_effect();
-
-            // Compute equivalent ops
-            vector<OperatorID> cheapest_operators;
-            vector<int> applicable_operator_ids;
-            match_tree.get_applicable_operator_ids(successor_state, applicable_operator_ids);
-            for (int applicable_op_id : applicable_operator_ids) {
-                const AbstractOperator &applicable_op = abstract_ops[applicable_op_id];
-                int predecessor = successor_state + applicable_op.get_hash_effect();
-                if (predecessor == current_state && op.get_cost() == applicable_op.get_cost()) {
-                    cheapest_operators.emplace_back(applicable_op.get_concrete_op_id());
+            int successor = state_index - op.get_hash_effect();
+            int successor_g = g + op.get_cost();
+            if (successor_g < g_values[successor]) {
+                int h = compute_lower_bound(successor);
+                if (h == INF) {
+                    continue;
                 }
+                g_values[successor] = successor_g;
+                reaching_op_ids[successor] = op_id;
+                open_list.push(successor_g + h, successor);
             }
-            if (compute_wildcard_plan) {
-                rng->shuffle(cheapest_operators);
-                wildcard_plan.push_back(move(cheapest_operators));
-            } else {
-                OperatorID random_op_id = *rng->choose(cheapest_operators);
-                wildcard_plan.emplace_back();
-                wildcard_plan.back().push_back(random_op_id);
-            }
+        }
+    }
+}
+
+void PatternDatabaseFactory::compute_plan(
+    const MatchTree &match_tree,
+    const shared_ptr<utils::RandomNumberGenerator> &rng,
+    bool compute_wildcard_plan) {
+    /*
+      We start from the initial state and follow the operators of the
+      abstract plan. For each step, we compute all operators of the same
+      cost inducing the same abstract transition and randomly pick one of
+      them. Note that this kind of plan extraction does not uniformly at
+      random consider all successor of a state but rather uses the
+      arbitrarily chosen plan operator to settle on one successor state,
+      which is biased by the number of operators leading to the same
+      successor from the given state.
+    */
+    int current_state = initial_state_index;
+    for (int op_id : abstract_plan) {
+        const AbstractOperator &op = abstract_ops[op_id];
+        int successor_state = current_state - op.get_hash_effect();
 
-            current_state = successor_state;
+        // Compute equivalent ops
+        vector<OperatorID> cheapest_operators;
+        vector<int> applicable_operator_ids;
+        match_tree.get_applicable_operator_ids(successor_state, applicable_operator_ids);
+        for (int applicable_op_id : applicable_operator_ids) {
+            const AbstractOperator &applicable_op = abstract_ops[applicable_op_id];
+            int predecessor = successor_state + applicable_op.get_hash_effect();
+            if (predecessor == current_state && op.get_cost() == applicable_op.get_cost()) {
+                cheapest_operators.emplace_back(applicable_op.get_concrete_op_id());
+            }
         }
+        if (compute_wildcard_plan) {
+            rng->shuffle(cheapest_operators);
+            wildcard_plan.push_back(move(cheapest_operators));
+        } else {
+            OperatorID random_op_id = *rng->choose(cheapest_operators);
+            wildcard_plan.emplace_back();
+            wildcard_plan.back().push_back(random_op_id);
+        }
+
+        current_state = successor_state;
     }
-    utils::release_vector_memory(generating_op_ids);
 }
 
 /*
@@ -413,19 +734,55 @@ PatternDatabaseFactory::PatternDatabaseFactory(
     const vector<int> &operator_costs,
     bool compute_plan,
     const shared_ptr<utils::RandomNumberGenerator> &rng,
-    bool compute_wildcard_plan)
+    bool compute_wildcard_plan,
+    int num_threads,
+    const PDBCollection *lower_bound_pdbs)
     : task_proxy(task_proxy),
       variables(task_proxy.get_variables()),
-      projection(task_proxy, pattern) {
+      projection(task_proxy, pattern),
+      compute_progression_preconditions(lower_bound_pdbs != nullptr),
+      initial_state_index(-1),
+      initial_state_distance(INF),
+      num_expanded_states(0),
+      num_threads(num_threads) {
+    assert(num_threads >= 1);
     assert(operator_costs.empty() ||
            operator_costs.size() == task_proxy.get_operators().size());
+    assert(compute_plan || !lower_bound_pdbs);
     compute_variable_to_index(pattern);
     compute_abstract_operators(operator_costs);
     unique_ptr<MatchTree> match_tree = compute_match_tree();
     compute_abstract_goals();
-    compute_distances(*match_tree, compute_plan);
+    if (compute_plan) {
+        State initial_state = task_proxy.get_initial_state();
+        initial_state.unpack();
+        initial_state_index =
+            projection.rank(initial_state.get_unpacked_values());
+    }
+
+    if (lower_bound_pdbs) {
+        // Only search for the plan and leave the distances empty.
+        search_abstract_plan(
+            *compute_progression_match_tree(), *lower_bound_pdbs);
+        utils::release_vector_memory(progression_preconditions);
+        this->compute_plan(*match_tree, rng, compute_wildcard_plan);
+        return;
+    }
+
+    /*
+      Plan extraction relies on the generating operators stored by
+      Dijkstra's algorithm, so the layered search is only used for PDBs
+      without plans.
+    */
+    int max_cost = compute_max_abstract_operator_cost();
+    if (!compute_plan && max_cost <= MAX_COST_FOR_LAYERED_SEARCH) {
+        compute_distances_by_layers(*match_tree, max_cost);
+    } else {
+        compute_distances(*match_tree, compute_plan);
+    }
 
     if (compute_plan) {
+        compute_abstract_plan_from_generating_ops();
         this->compute_plan(*match_tree, rng, compute_wildcard_plan);
     }
 }
@@ -434,11 +791,53 @@ shared_ptr<PatternDatabase> compute_pdb(
     const TaskProxy &task_proxy,
     const Pattern &pattern,
     const vector<int> &operator_costs,
-    const shared_ptr<utils::RandomNumberGenerator> &rng) {
-    PatternDatabaseFactory pdb_factory(task_proxy, pattern, operator_costs, false, rng);
+    const shared_ptr<utils::RandomNumberGenerator> &rng,
+    int num_threads) {
+    PatternDatabaseFactory pdb_factory(
+        task_proxy, pattern, operator_costs, false, rng, false, num_threads);
     return pdb_factory.extract_pdb();
 }
 
+size_t estimate_pdb_memory(
+    const TaskProxy &task_proxy, const Pattern &pattern) {
+    size_t num_abstract_states = 1;
+    VariablesProxy variables = task_proxy.get_variables();
+    for (int var_id : pattern) {
+        num_abstract_states *= variables[var_id].get_domain_size();
+    }
+    return num_abstract_states * sizeof(int);
+}
+
+shared_ptr<PDBCollection> compute_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    int num_threads,
+    size_t max_construction_memory,
+    int compression_factor,
+    const utils::CountdownTimer *timer) {
+    int num_patterns = patterns.size();
+    shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>(num_patterns);
+    utils::SharedBudget memory_budget(max_construction_memory);
+    // Threads that are not needed for computing PDBs concurrently are used within PDBs.
+    int threads_per_pdb = max(1, num_threads / max(1, num_patterns));
+    utils::parallel_for(
+        num_patterns, num_threads, [&](int i) {
+            if (timer && timer->is_expired()) {
+                return;
+            }
+            size_t estimated_memory = estimate_pdb_memory(task_proxy, patterns[i]);
+            memory_budget.acquire(estimated_memory);
+            shared_ptr<PatternDatabase> pdb = compute_pdb(
+                task_proxy, patterns[i], vector<int>(), nullptr, threads_per_pdb);
+            if (compression_factor > 1) {
+                pdb = make_shared<PatternDatabase>(*pdb, compression_factor);
+            }
+            (*pdbs)[i] = pdb;
+            memory_budget.release(estimated_memory);
+        });
+    return pdbs;
+}
+
 tuple<shared_ptr<PatternDatabase>, vector<vector<OperatorID>>>
 compute_pdb_and_plan(
     const TaskProxy &task_proxy,
@@ -451,4 +850,21 @@ compute_pdb_and_plan(
                pdb_factory.extract_pdb(), pdb_factory.extract_wildcard_plan()
     };
 }
+
+tuple<int, vector<vector<OperatorID>>, int> compute_plan_with_lower_bounds(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const PDBCollection &lower_bound_pdbs,
+    const vector<int> &operator_costs,
+    const shared_ptr<utils::RandomNumberGenerator> &rng,
+    bool compute_wildcard_plan) {
+    PatternDatabaseFactory pdb_factory(
+        task_proxy, pattern, operator_costs, true, rng, compute_wildcard_plan,
+        1, &lower_bound_pdbs);
+    return {
+               pdb_factory.get_initial_state_distance(),
+               pdb_factory.extract_wildcard_plan(),
+               pdb_factory.get_num_expanded_states()
+    };
+}
 }
@@ -5,11 +5,13 @@
 
 #include "../task_proxy.h"
 
+#include <limits>
 #include <memory>
 #include <tuple>
 #include <vector>
 
 namespace utils {
+class CountdownTimer;
 class RandomNumberGenerator;
 }
 
@@ -22,12 +24,43 @@ namespace pdbs {
   If operator_costs is given, it must contain one integer for each operator
   of the task, specifying the cost that should be considered for that operator
   instead of its original cost.
+
+  If all operators cost at most 100, the abstract state space is explored
+  layer by layer and the states of a layer are regressed by up to
+  num_threads threads. The resulting PDB does not depend on num_threads.
 */
 extern std::shared_ptr<PatternDatabase> compute_pdb(
     const TaskProxy &task_proxy,
     const Pattern &pattern,
     const std::vector<int> &operator_costs = std::vector<int>(),
-    const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr);
+    const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr,
+    int num_threads = 1);
+
+/*
+  Estimate the memory (in bytes) needed while computing the PDB for the
+  given pattern by the size of its unpacked distance table.
+*/
+extern std::size_t estimate_pdb_memory(
+    const TaskProxy &task_proxy, const Pattern &pattern);
+
+/*
+  Compute PDBs for all given patterns like compute_pdb() above, using up
+  to num_threads threads. The PDBs are returned in the order of the
+  patterns. A PDB is only computed concurrently with others if the
+  estimated memory (in bytes) of all PDBs under construction stays within
+  max_construction_memory (see estimate_pdb_memory). If there are fewer patterns than threads, the
+  remaining threads are used for computing the individual PDBs. Each PDB
+  is compressed with the given compression factor (see PatternDatabase)
+  as soon as it has been computed. If a timer is given, PDBs that have not
+  been started when it expires are not computed and remain nullptr.
+*/
+extern std::shared_ptr<PDBCollection> compute_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    int num_threads = 1,
+    std::size_t max_construction_memory = std::numeric_limits<std::size_t>::max(),
+    int compression_factor = 1,
+    const utils::CountdownTimer *timer = nullptr);
 
 /*
   In addition to computing a PDB for the given task and pattern like
@@ -50,6 +83,30 @@ extern std::tuple<std::shared_ptr<PatternDatabase>,
     const std::vector<int> &operator_costs = std::vector<int>(),
     const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr,
     bool compute_wildcard_plan = false);
+
+/*
+  Compute an abstract plan like compute_pdb_and_plan() above, but without
+  computing the PDB. Instead, A* searches for an optimal plan from the
+  abstract initial state. Its heuristic is the maximum over the given PDBs,
+  which must have been computed for the same operator costs, must not be
+  compressed and must have patterns that are subsets of the given pattern.
+  The goal distances of coarser projections are lower bounds for the goal
+  distances in finer ones, so if the lower bounds are good, the search only
+  expands a small part of the abstract state space.
+
+  Return the goal distance of the abstract initial state
+  (numeric_limits<int>::max() if it is unsolvable), the plan and the number
+  of expanded abstract states. The plan is optimal but may differ from the
+  one computed by compute_pdb_and_plan().
+*/
+extern std::tuple<int, std::vector<std::vector<OperatorID>>, int>
+compute_plan_with_lower_bounds(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const PDBCollection &lower_bound_pdbs,
+    const std::vector<int> &operator_costs = std::vector<int>(),
+    const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr,
+    bool compute_wildcard_plan = false);
 }
 
 #endif
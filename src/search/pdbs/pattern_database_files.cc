@@ -0,0 +1,163 @@
+#include "pattern_database_files.h"
+
+#include "pattern_database.h"
+
+#include "../persistent_data.h"
+
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace std;
+using persistent_data::WordReader;
+using persistent_data::write_word;
+
+namespace pdbs {
+static const uint64_t MAGIC = 0x53424450445f4446ULL;
+static const uint64_t VERSION = 1;
+
+static bool is_valid_pattern(const TaskProxy &task_proxy, const Pattern &pattern) {
+    int num_variables = task_proxy.get_variables().size();
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        if (pattern[i] < 0 || pattern[i] >= num_variables ||
+            (i > 0 && pattern[i] <= pattern[i - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool is_valid_entry_width(uint64_t bits_per_entry) {
+    return bits_per_entry == 1 || bits_per_entry == 2 ||
+           bits_per_entry == 4 || bits_per_entry == 8 ||
+           bits_per_entry == 16 || bits_per_entry == 32;
+}
+
+static shared_ptr<PatternDatabase> read_pdb(
+    const TaskProxy &task_proxy, WordReader &reader,
+    const shared_ptr<const char> &contents) {
+    uint64_t pattern_size = reader.read();
+    if (!reader.is_valid() || pattern_size > task_proxy.get_variables().size()) {
+        return nullptr;
+    }
+    Pattern pattern;
+    for (uint64_t i = 0; i < pattern_size; ++i) {
+        pattern.push_back(static_cast<int>(reader.read()));
+    }
+    uint64_t compression_factor = reader.read();
+    uint64_t bits_per_entry = reader.read();
+    uint64_t num_words = reader.read();
+    if (!reader.is_valid() || !is_valid_pattern(task_proxy, pattern) ||
+        compression_factor < 1 ||
+        compression_factor > static_cast<uint64_t>(numeric_limits<int>::max()) ||
+        !is_valid_entry_width(bits_per_entry)) {
+        return nullptr;
+    }
+    Projection projection(task_proxy, pattern);
+    if (num_words != PatternDatabase::compute_num_packed_words(
+            projection.get_num_abstract_states(), compression_factor,
+            bits_per_entry)) {
+        return nullptr;
+    }
+    const uint64_t *words = reader.skip(num_words);
+    if (!reader.is_valid()) {
+        return nullptr;
+    }
+    // The PDB keeps the contents of the file alive.
+    return make_shared<PatternDatabase>(
+        move(projection), compression_factor, bits_per_entry,
+        shared_ptr<const uint64_t>(contents, words), num_words);
+}
+
+shared_ptr<PDBCollection> load_pdbs(
+    const TaskProxy &task_proxy, const string &configuration,
+    utils::LogProxy &log) {
+    uint64_t task_hash = task_properties::compute_task_hash(task_proxy);
+    string path = persistent_data::get_path(task_hash, configuration, "pdbs");
+    size_t size = 0;
+    shared_ptr<const char> contents = persistent_data::map_file(path, size);
+    if (!contents) {
+        return nullptr;
+    }
+
+    WordReader reader(
+        reinterpret_cast<const uint64_t *>(contents.get()),
+        size / sizeof(uint64_t));
+    bool is_valid = size % sizeof(uint64_t) == 0 &&
+        reader.read() == MAGIC &&
+        reader.read() == VERSION &&
+        reader.read() == task_hash;
+    uint64_t configuration_length = reader.read();
+    uint64_t num_pdbs = reader.read();
+    const char *stored_configuration = reinterpret_cast<const char *>(
+        reader.skip((configuration_length + 7) / 8));
+    is_valid = is_valid && reader.is_valid() &&
+        configuration_length == configuration.size() &&
+        memcmp(stored_configuration, configuration.data(),
+               configuration_length) == 0;
+
+    shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>();
+    for (uint64_t i = 0; is_valid && i < num_pdbs; ++i) {
+        shared_ptr<PatternDatabase> pdb = read_pdb(task_proxy, reader, contents);
+        if (pdb) {
+            pdbs->push_back(pdb);
+        } else {
+            is_valid = false;
+        }
+    }
+    if (!is_valid || !reader.is_at_end()) {
+        if (log.is_warning()) {
+            log << "Warning: ignoring invalid PDB file " << path << endl;
+        }
+        return nullptr;
+    }
+    if (log.is_at_least_normal()) {
+        log << "Loaded " << pdbs->size() << " PDBs from " << path << endl;
+    }
+    return pdbs;
+}
+
+void save_pdbs(
+    const TaskProxy &task_proxy, const string &configuration,
+    const PDBCollection &pdbs, utils::LogProxy &log) {
+    uint64_t task_hash = task_properties::compute_task_hash(task_proxy);
+    string path = persistent_data::get_path(task_hash, configuration, "pdbs");
+    bool success = persistent_data::write_file(
+        path, [&](ostream &stream) {
+            write_word(stream, MAGIC);
+            write_word(stream, VERSION);
+            write_word(stream, task_hash);
+            write_word(stream, configuration.size());
+            write_word(stream, pdbs.size());
+            vector<char> padded_configuration(
+                (configuration.size() + 7) / 8 * 8, '\0');
+            copy(configuration.begin(), configuration.end(),
+                 padded_configuration.begin());
+            stream.write(padded_configuration.data(), padded_configuration.size());
+            for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+                const Pattern &pattern = pdb->get_pattern();
+                write_word(stream, pattern.size());
+                for (int var : pattern) {
+                    write_word(stream, var);
+                }
+                write_word(stream, pdb->get_compression_factor());
+                write_word(stream, pdb->get_bits_per_entry());
+                write_word(stream, pdb->get_num_packed_words());
+                stream.write(
+                    reinterpret_cast<const char *>(pdb->get_packed_distances()),
+                    pdb->get_num_packed_words() * sizeof(uint64_t));
+            }
+        });
+    if (!success) {
+        if (log.is_warning()) {
+            log << "Warning: could not write PDB file " << path << endl;
+        }
+    } else if (log.is_at_least_normal()) {
+        log << "Stored " << pdbs.size() << " PDBs in " << path << endl;
+    }
+}
+}
@@ -0,0 +1,59 @@
+#ifndef PDBS_PATTERN_DATABASE_FILES_H
+#define PDBS_PATTERN_DATABASE_FILES_H
+
+#include "types.h"
+
+#include "../task_proxy.h"
+
+#include <memory>
+#include <string>
+
+namespace utils {
+class LogProxy;
+}
+
+namespace pdbs {
+/*
+  PDB collections can be stored in files, so that later planner runs on
+  the same task (e.g., with different search settings or in later
+  portfolio configurations) can reuse them instead of computing them
+  again.
+
+  Files are stored in the directory for persistent data (see
+  persistent_data.h). The name of a file is derived from a hash of the
+  task and a hash of the configuration of the pattern generator that
+  computed the PDBs. Files are validated with the task hash and the
+  complete configuration string before they are used.
+
+  Apart from the configuration string, all fields of a file are 64-bit
+  unsigned integers in native byte order:
+    magic number, format version, task hash,
+    length of the configuration string, number of PDBs,
+    configuration string (padded with zeros to a multiple of 8 bytes),
+    and for each PDB:
+      pattern size, pattern variables, compression factor,
+      bits per entry, number of packed words, packed distance table.
+
+  Loaded files are memory-mapped where possible, so the distance tables
+  are neither copied nor read completely when the PDBs are loaded.
+*/
+
+/*
+  Return the PDBs stored for the given task and configuration or nullptr
+  if there is no valid file for them.
+*/
+extern std::shared_ptr<PDBCollection> load_pdbs(
+    const TaskProxy &task_proxy, const std::string &configuration,
+    utils::LogProxy &log);
+
+/*
+  Store the given PDBs for the given task and configuration. Failing to
+  write the file is not an error, since the PDBs can always be
+  recomputed.
+*/
+extern void save_pdbs(
+    const TaskProxy &task_proxy, const std::string &configuration,
+    const PDBCollection &pdbs, utils::LogProxy &log);
+}
+
+#endif
@@ -1,14 +1,53 @@
 #include "pattern_generator.h"
 
+#include "pattern_database.h"
+#include "pattern_database_files.h"
 #include "utils.h"
 
+#include "../persistent_data.h"
+
 #include "../plugins/plugin.h"
 
+#include <limits>
+
 using namespace std;
 
 namespace pdbs {
+static size_t get_memory_in_bytes(int memory_in_mb) {
+    if (memory_in_mb == numeric_limits<int>::max()) {
+        return numeric_limits<size_t>::max();
+    }
+    return static_cast<size_t>(memory_in_mb) * 1024 * 1024;
+}
+
 PatternCollectionGenerator::PatternCollectionGenerator(const plugins::Options &opts)
-    : log(utils::get_log_from_options(opts)) {
+    : log(utils::get_log_from_options(opts)),
+      num_threads(opts.get<int>("num_threads")),
+      max_pdb_construction_memory(
+          get_memory_in_bytes(opts.get<int>("max_pdb_construction_memory"))),
+      pdb_compression_factor(opts.get<int>("pdb_compression_factor")),
+      cache_pdbs_persistently(opts.get<bool>("cache_pdbs_persistently")),
+      configuration(opts.get_normalized_config()) {
+}
+
+static bool can_cache_pdbs(
+    const string &configuration, utils::LogProxy &log) {
+    if (!persistent_data::has_directory()) {
+        if (log.is_warning()) {
+            log << "Warning: PDBs should be cached persistently, but no "
+                << "directory has been given with --persistent-data-directory."
+                << endl;
+        }
+        return false;
+    }
+    if (configuration.empty()) {
+        if (log.is_warning()) {
+            log << "Warning: PDBs of a generator without configuration "
+                << "string cannot be cached persistently." << endl;
+        }
+        return false;
+    }
+    return true;
 }
 
 PatternCollectionInformation PatternCollectionGenerator::generate(
@@ -17,14 +56,37 @@ PatternCollectionInformation PatternCollectionGenerator::generate(
         log << "Generating patterns using: " << name() << endl;
     }
     utils::Timer timer;
+    TaskProxy task_proxy(*task);
+    bool use_cache = cache_pdbs_persistently && can_cache_pdbs(configuration, log);
+    if (use_cache) {
+        shared_ptr<PDBCollection> pdbs = load_pdbs(task_proxy, configuration, log);
+        if (pdbs) {
+            PatternCollectionInformation pci =
+                get_pattern_collection_info(task_proxy, pdbs, log);
+            pci.set_pdb_construction_options(
+                num_threads, max_pdb_construction_memory, pdb_compression_factor);
+            dump_pattern_collection_generation_statistics(
+                name(), timer(), pci, log);
+            return pci;
+        }
+    }
     PatternCollectionInformation pci = compute_patterns(task);
+    pci.set_pdb_construction_options(
+        num_threads, max_pdb_construction_memory, pdb_compression_factor);
+    if (use_cache) {
+        save_pdbs(task_proxy, configuration, *pci.get_pdbs(), log);
+    }
     dump_pattern_collection_generation_statistics(
         name(), timer(), pci, log);
     return pci;
 }
 
 PatternGenerator::PatternGenerator(const plugins::Options &opts)
-    : log(utils::get_log_from_options(opts)) {
+    : log(utils::get_log_from_options(opts)),
+      num_threads(opts.get<int>("num_threads")),
+      pdb_compression_factor(opts.get<int>("pdb_compression_factor")),
+      cache_pdbs_persistently(opts.get<bool>("cache_pdbs_persistently")),
+      configuration(opts.get_normalized_config()) {
 }
 
 PatternInformation PatternGenerator::generate(
@@ -33,7 +95,28 @@ PatternInformation PatternGenerator::generate(
         log << "Generating pattern using: " << name() << endl;
     }
     utils::Timer timer;
+    TaskProxy task_proxy(*task);
+    bool use_cache = cache_pdbs_persistently && can_cache_pdbs(configuration, log);
+    shared_ptr<PDBCollection> loaded_pdbs;
+    if (use_cache) {
+        loaded_pdbs = load_pdbs(task_proxy, configuration, log);
+    }
+    if (loaded_pdbs && loaded_pdbs->size() == 1) {
+        const shared_ptr<PatternDatabase> &pdb = loaded_pdbs->front();
+        PatternInformation pattern_info(task_proxy, pdb->get_pattern(), log);
+        pattern_info.set_pdb(pdb);
+        pattern_info.set_pdb_construction_options(
+            num_threads, pdb_compression_factor);
+        dump_pattern_generation_statistics(
+            name(), timer.stop(), pattern_info, log);
+        return pattern_info;
+    }
     PatternInformation pattern_info = compute_pattern(task);
+    pattern_info.set_pdb_construction_options(
+        num_threads, pdb_compression_factor);
+    if (use_cache) {
+        save_pdbs(task_proxy, configuration, {pattern_info.get_pdb()}, log);
+    }
     dump_pattern_generation_statistics(
         name(),
         timer.stop(),
@@ -42,10 +125,77 @@ PatternInformation PatternGenerator::generate(
     return pattern_info;
 }
 
+static void add_pdb_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "pdb_compression_factor",
+        "number of abstract states with consecutive ranks that share an entry "
+        "of the distance table of a PDB. Each entry stores the minimal "
+        "h-value of its states, so the table shrinks by this factor, at the "
+        "cost of a less informed heuristic. The heuristic remains admissible "
+        "but may become inconsistent for values larger than 1. "
+        "Independently of this option, each entry uses only as many bits as "
+        "needed for the largest finite h-value of the PDB (rounded up to a "
+        "power of 2).",
+        "1",
+        plugins::Bounds("1", "infinity"));
+    feature.add_option<bool>(
+        "cache_pdbs_persistently",
+        "store the computed PDBs in the directory given with the command line "
+        "option --persistent-data-directory and load them from there instead "
+        "of generating patterns and computing PDBs in later planner runs on "
+        "the same task with the same configuration of this generator "
+        "(ignoring options that do not affect the PDBs, such as num_threads "
+        "and verbosity). Note "
+        "that generators with time limits or random seeds may compute "
+        "different patterns in different runs, so the loaded PDBs are those "
+        "of the first run.",
+        "false");
+    feature.mark_result_independent("cache_pdbs_persistently");
+}
+
 void add_generator_options_to_feature(plugins::Feature &feature) {
     utils::add_log_options_to_feature(feature);
 }
 
+void add_collection_generator_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "num_threads",
+        "number of threads used to compute independent PDBs concurrently. "
+        "If there are fewer PDBs than threads, the remaining threads are "
+        "used within the computation of each PDB. "
+        "The resulting PDBs do not depend on this number. Note that each "
+        "additional thread reserves address space for its stack and memory "
+        "allocator, which counts towards the memory limit of the planner.",
+        "1",
+        plugins::Bounds("1", "infinity"));
+    feature.mark_result_independent("num_threads");
+    feature.add_option<int>(
+        "max_pdb_construction_memory",
+        "maximum estimated memory in MiB of all PDBs that are computed "
+        "concurrently. The memory of a PDB is estimated by the size of its "
+        "distance table. Larger PDBs are computed when no other PDB is "
+        "under construction.",
+        "infinity",
+        plugins::Bounds("1", "infinity"));
+    feature.mark_result_independent("max_pdb_construction_memory");
+    add_pdb_options_to_feature(feature);
+    add_generator_options_to_feature(feature);
+}
+
+void add_single_generator_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "num_threads",
+        "number of threads used to compute the PDB of the pattern. If all "
+        "operators cost at most 100, the states of each layer of the "
+        "regression search are processed concurrently. The resulting PDB "
+        "does not depend on this number.",
+        "1",
+        plugins::Bounds("1", "infinity"));
+    feature.mark_result_independent("num_threads");
+    add_pdb_options_to_feature(feature);
+    add_generator_options_to_feature(feature);
+}
+
 static class PatternCollectionGeneratorCategoryPlugin : public plugins::TypedCategoryPlugin<PatternCollectionGenerator> {
 public:
     PatternCollectionGeneratorCategoryPlugin() : TypedCategoryPlugin("PatternCollectionGenerator") {
@@ -7,6 +7,7 @@
 
 #include "../utils/logging.h"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -28,6 +29,12 @@ class PatternCollectionGenerator {
         const std::shared_ptr<AbstractTask> &task) = 0;
 protected:
     mutable utils::LogProxy log;
+    // Used for computing PDBs of the generated pattern collection.
+    const int num_threads;
+    const std::size_t max_pdb_construction_memory;
+    const int pdb_compression_factor;
+    const bool cache_pdbs_persistently;
+    const std::string configuration;
 public:
     explicit PatternCollectionGenerator(const plugins::Options &opts);
     virtual ~PatternCollectionGenerator() = default;
@@ -42,6 +49,11 @@ class PatternGenerator {
         const std::shared_ptr<AbstractTask> &task) = 0;
 protected:
     mutable utils::LogProxy log;
+    // Used for computing the PDB of the generated pattern.
+    const int num_threads;
+    const int pdb_compression_factor;
+    const bool cache_pdbs_persistently;
+    const std::string configuration;
 public:
     explicit PatternGenerator(const plugins::Options &opts);
     virtual ~PatternGenerator() = default;
@@ -50,6 +62,9 @@ public:
 };
 
 extern void add_generator_options_to_feature(plugins::Feature &feature);
+extern void add_collection_generator_options_to_feature(
+    plugins::Feature &feature);
+extern void add_single_generator_options_to_feature(plugins::Feature &feature);
 }
 
 #endif
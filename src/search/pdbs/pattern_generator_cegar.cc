@@ -36,6 +36,7 @@ PatternInformation PatternGeneratorCEGAR::compute_pattern(
         max_pdb_size,
         max_time,
         use_wildcard_plans,
+        num_threads,
         log,
         rng,
         task,
@@ -65,7 +66,7 @@ public:
             "infinity",
             plugins::Bounds("0.0", "infinity"));
         add_cegar_wildcard_option_to_feature(*this);
-        add_generator_options_to_feature(*this);
+        add_single_generator_options_to_feature(*this);
         utils::add_rng_options(*this);
 
         add_cegar_implementation_notes_to_feature(*this);
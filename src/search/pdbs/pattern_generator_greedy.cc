@@ -57,7 +57,7 @@ public:
             "maximal number of abstract states in the pattern database.",
             "1000000",
             plugins::Bounds("1", "infinity"));
-        add_generator_options_to_feature(*this);
+        add_single_generator_options_to_feature(*this);
     }
 };
 
@@ -36,7 +36,7 @@ public:
             "pattern",
             "list of variable numbers of the planning task that should be used as "
             "pattern.");
-        add_generator_options_to_feature(*this);
+        add_single_generator_options_to_feature(*this);
     }
 };
 
@@ -70,7 +70,7 @@ public:
             "infinity",
             plugins::Bounds("0.0", "infinity"));
         add_random_pattern_bidirectional_option_to_feature(*this);
-        add_generator_options_to_feature(*this);
+        add_single_generator_options_to_feature(*this);
         utils::add_rng_options(*this);
 
         add_random_pattern_implementation_notes_to_feature(*this);
@@ -5,6 +5,7 @@
 #include "validation.h"
 
 #include <cassert>
+#include <vector>
 
 using namespace std;
 
@@ -15,7 +16,9 @@ PatternInformation::PatternInformation(
     utils::LogProxy &log)
     : task_proxy(task_proxy),
       pattern(move(pattern)),
-      pdb(nullptr) {
+      pdb(nullptr),
+      num_threads(1),
+      pdb_compression_factor(1) {
     validate_and_normalize_pattern(task_proxy, this->pattern, log);
 }
 
@@ -25,8 +28,19 @@ bool PatternInformation::information_is_valid() const {
 
 void PatternInformation::create_pdb_if_missing() {
     if (!pdb) {
-        pdb = compute_pdb(task_proxy, pattern);
+        pdb = compute_pdb(task_proxy, pattern, vector<int>(), nullptr, num_threads);
     }
+    if (pdb->get_compression_factor() != pdb_compression_factor) {
+        pdb = make_shared<PatternDatabase>(*pdb, pdb_compression_factor);
+    }
+}
+
+void PatternInformation::set_pdb_construction_options(
+    int num_threads_, int pdb_compression_factor_) {
+    assert(num_threads_ >= 1);
+    assert(pdb_compression_factor_ >= 1);
+    num_threads = num_threads_;
+    pdb_compression_factor = pdb_compression_factor_;
 }
 
 void PatternInformation::set_pdb(const shared_ptr<PatternDatabase> &pdb_) {
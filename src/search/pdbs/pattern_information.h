@@ -27,6 +27,8 @@ class PatternInformation {
     TaskProxy task_proxy;
     Pattern pattern;
     std::shared_ptr<PatternDatabase> pdb;
+    int num_threads;
+    int pdb_compression_factor;
 
     void create_pdb_if_missing();
 
@@ -35,6 +37,12 @@ public:
     PatternInformation(
         const TaskProxy &task_proxy, Pattern pattern, utils::LogProxy &log);
 
+    /*
+      Set the number of threads used for computing a missing PDB and the
+      compression factor of the returned PDB (see PatternDatabase).
+    */
+    void set_pdb_construction_options(
+        int num_threads, int pdb_compression_factor);
     void set_pdb(const std::shared_ptr<PatternDatabase> &pdb);
 
     TaskProxy get_task_proxy() const {
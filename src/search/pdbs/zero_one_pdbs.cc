@@ -38,6 +38,7 @@ ZeroOnePDBs::ZeroOnePDBs(
 
         pattern_databases.push_back(pdb);
     }
+    ranker = PDBCollectionRanker(pattern_databases);
 }
 
 
@@ -47,9 +48,11 @@ int ZeroOnePDBs::get_value(const State &state) const {
       heuristic values of all patterns in the pattern collection.
     */
     state.unpack();
+    vector<int> ranks;
+    ranker.rank(state.get_unpacked_values(), ranks);
     int h_val = 0;
-    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
-        int pdb_value = pdb->get_value(state.get_unpacked_values());
+    for (size_t i = 0; i < ranks.size(); ++i) {
+        int pdb_value = pattern_databases[i]->get_distance(ranks[i]);
         if (pdb_value == numeric_limits<int>::max())
             return numeric_limits<int>::max();
         h_val += pdb_value;
@@ -1,6 +1,7 @@
 #ifndef PDBS_ZERO_ONE_PDBS_H
 #define PDBS_ZERO_ONE_PDBS_H
 
+#include "pattern_database.h"
 #include "types.h"
 
 class State;
@@ -13,6 +14,7 @@ class LogProxy;
 namespace pdbs {
 class ZeroOnePDBs {
     PDBCollection pattern_databases;
+    PDBCollectionRanker ranker;
 public:
     ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns);
     ~ZeroOnePDBs() = default;
@@ -0,0 +1,133 @@
+#include "persistent_data.h"
+
+#include "utils/hash.h"
+#include "utils/system.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace persistent_data {
+static string data_directory;
+
+void set_directory(const string &directory) {
+    data_directory = directory;
+}
+
+bool has_directory() {
+    return !data_directory.empty();
+}
+
+string get_path(const string &filename) {
+    assert(has_directory());
+    if (data_directory.back() == '/') {
+        return data_directory + filename;
+    }
+    return data_directory + "/" + filename;
+}
+
+static uint64_t compute_configuration_hash(const string &configuration) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, static_cast<int>(configuration.size()));
+    for (char c : configuration) {
+        utils::feed(hash_state, static_cast<int>(c));
+    }
+    return hash_state.get_hash64();
+}
+
+string get_path(
+    uint64_t task_hash, const string &configuration, const string &extension) {
+    ostringstream filename;
+    filename << hex << setfill('0') << setw(16) << task_hash << "-"
+             << setw(16) << compute_configuration_hash(configuration)
+             << "." << extension;
+    return get_path(filename.str());
+}
+
+shared_ptr<const char> map_file(const string &path, size_t &size) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    int file_descriptor = open(path.c_str(), O_RDONLY);
+    if (file_descriptor == -1) {
+        return nullptr;
+    }
+    struct stat file_stat;
+    if (fstat(file_descriptor, &file_stat) == -1 || file_stat.st_size == 0) {
+        close(file_descriptor);
+        return nullptr;
+    }
+    size = file_stat.st_size;
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    // The mapping remains valid after closing the file.
+    close(file_descriptor);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    size_t mapped_size = size;
+    return shared_ptr<const char>(
+        static_cast<const char *>(mapping),
+        [mapped_size](const char *data) {
+            munmap(const_cast<char *>(data), mapped_size);
+        });
+#else
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file) {
+        return nullptr;
+    }
+    size = file.tellg();
+    if (size == 0) {
+        return nullptr;
+    }
+    // Reading into 64-bit words makes sure that the data is aligned.
+    shared_ptr<vector<uint64_t>> buffer =
+        make_shared<vector<uint64_t>>((size + 7) / 8);
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char *>(buffer->data()), size)) {
+        return nullptr;
+    }
+    return shared_ptr<const char>(
+        buffer, reinterpret_cast<const char *>(buffer->data()));
+#endif
+}
+
+bool write_file(const string &path, const function<void(ostream &)> &write) {
+    string temporary_path = path + ".tmp" + to_string(utils::get_process_id());
+    {
+        ofstream file(temporary_path, ios::binary | ios::trunc);
+        if (!file) {
+            return false;
+        }
+        write(file);
+        if (!file.flush()) {
+            file.close();
+            remove(temporary_path.c_str());
+            return false;
+        }
+    }
+#if OPERATING_SYSTEM == WINDOWS
+    // Renaming does not replace existing files on Windows.
+    remove(path.c_str());
+#endif
+    if (rename(temporary_path.c_str(), path.c_str()) != 0) {
+        remove(temporary_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void write_word(ostream &stream, uint64_t word) {
+    stream.write(reinterpret_cast<const char *>(&word), sizeof(word));
+}
+}
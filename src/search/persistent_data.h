@@ -0,0 +1,102 @@
+#ifndef PERSISTENT_DATA_H
+#define PERSISTENT_DATA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace persistent_data {
+/*
+  Planner components can store expensive precomputations (e.g., pattern
+  databases) in files of a common directory, so that later planner runs
+  on the same task can reuse them. Each component is responsible for
+  choosing unique file names and for validating the files it loads.
+*/
+
+// Set the directory holding the files. This has to happen before the search.
+extern void set_directory(const std::string &directory);
+
+// Return true iff a directory has been set.
+extern bool has_directory();
+
+// Return the path of the file with the given name in the directory.
+extern std::string get_path(const std::string &filename);
+
+/*
+  Return the path of the file for the given task and configuration string
+  of a planner component. The file name consists of the task hash and a
+  hash of the configuration. Files still have to be validated, since
+  different configurations may have the same hash.
+*/
+extern std::string get_path(
+    std::uint64_t task_hash, const std::string &configuration,
+    const std::string &extension);
+
+/*
+  Return the contents of the given file or nullptr if it does not exist
+  or cannot be read, and set size to its size in bytes. Where possible,
+  the file is memory-mapped read-only, so only the accessed parts are
+  read from disk. The contents are aligned to 8 bytes.
+*/
+extern std::shared_ptr<const char> map_file(
+    const std::string &path, std::size_t &size);
+
+/*
+  Write the file by calling write with a stream. The data is written to
+  a temporary file first, which then replaces the given file, so other
+  processes never see incomplete files. Return true iff successful.
+*/
+extern bool write_file(
+    const std::string &path,
+    const std::function<void(std::ostream &)> &write);
+
+// Write a 64-bit word in native byte order.
+extern void write_word(std::ostream &stream, std::uint64_t word);
+
+/*
+  Reads 64-bit words from the contents of a file. Reading past the end of
+  the file invalidates the reader.
+*/
+class WordReader {
+    const std::uint64_t *words;
+    std::size_t num_words;
+    std::size_t position;
+    bool valid;
+public:
+    WordReader(const std::uint64_t *words, std::size_t num_words)
+        : words(words), num_words(num_words), position(0), valid(true) {
+    }
+
+    std::uint64_t read() {
+        if (position >= num_words) {
+            valid = false;
+            return 0;
+        }
+        return words[position++];
+    }
+
+    // Return a pointer to the next count words and skip them.
+    const std::uint64_t *skip(std::uint64_t count) {
+        if (count > num_words - position) {
+            valid = false;
+            return nullptr;
+        }
+        const std::uint64_t *result = words + position;
+        position += count;
+        return result;
+    }
+
+    bool is_valid() const {
+        return valid;
+    }
+
+    bool is_at_end() const {
+        return position == num_words;
+    }
+};
+}
+
+#endif
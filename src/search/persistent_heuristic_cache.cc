@@ -0,0 +1,304 @@
+#include "persistent_heuristic_cache.h"
+
+#include "task_proxy.h"
+
+#include "task_utils/task_properties.h"
+
+#include "utils/hash.h"
+#include "utils/logging.h"
+#include "utils/memory.h"
+#include "utils/system.h"
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace persistent_heuristic_cache {
+/*
+  Slots consist of the key of the heuristic (EMPTY_KEY for unused slots,
+  BUSY_KEY for slots that are being written), the heuristic value and the
+  packed state.
+*/
+static const uint64_t EMPTY_KEY = 0;
+static const uint64_t BUSY_KEY = numeric_limits<uint64_t>::max();
+static const size_t VALUE_OFFSET = sizeof(uint64_t);
+static const size_t STATE_OFFSET = VALUE_OFFSET + sizeof(int32_t);
+static const uint64_t MAGIC = 0x45484341435f4446ULL;
+static const uint32_t VERSION = 1;
+// Number of slots we look at before we consider the table to be full.
+static const size_t MAX_PROBES = 64;
+
+struct PersistentHeuristicCache::Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t bins_per_state;
+    uint64_t task_hash;
+    uint64_t num_slots;
+    uint64_t num_entries;
+};
+
+static string cache_filename;
+static size_t cache_size_in_bytes = 0;
+static unique_ptr<PersistentHeuristicCache> cache;
+
+// Slot keys are accessed concurrently by all planner runs sharing the file.
+static atomic_ref<uint64_t> get_slot_key(char *slot) {
+    return atomic_ref<uint64_t>(*reinterpret_cast<uint64_t *>(slot));
+}
+
+static void exit_with_cache_error(const string &filename, const string &reason) {
+    cerr << "Error using persistent heuristic cache " << filename << ": "
+         << reason << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
+PersistentHeuristicCache::PersistentHeuristicCache(
+    const string &filename, size_t size_in_bytes, uint64_t task_hash,
+    int bins_per_state, utils::LogProxy &log)
+    : bins_per_state(bins_per_state),
+      slot_size(0),
+      num_slots(0),
+      file_size(0),
+      file_descriptor(-1),
+      data(nullptr),
+      header(nullptr),
+      reported_full_table(false) {
+    // Round up to keep the keys of all slots 8-byte aligned.
+    size_t state_size = bins_per_state * sizeof(PackedStateBin);
+    slot_size = (STATE_OFFSET + state_size + 7) / 8 * 8;
+    num_slots = max<size_t>(
+        1, (max(size_in_bytes, sizeof(Header)) - sizeof(Header)) / slot_size);
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    static_assert(atomic_ref<uint64_t>::is_always_lock_free,
+                  "Sharing the cache between processes needs lock-free atomics.");
+    file_descriptor = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file_descriptor == -1) {
+        exit_with_cache_error(filename, strerror(errno));
+    }
+    /*
+      Other planner runs may open the file at the same time. The lock makes
+      sure that only one of them creates it and that the others only read
+      its header once it is complete.
+    */
+    if (flock(file_descriptor, LOCK_EX) == -1) {
+        exit_with_cache_error(filename, strerror(errno));
+    }
+
+    struct stat file_stat;
+    if (fstat(file_descriptor, &file_stat) == -1) {
+        exit_with_cache_error(filename, strerror(errno));
+    }
+    size_t existing_size = file_stat.st_size;
+    bool is_new = existing_size == 0;
+    if (!is_new) {
+        Header existing;
+        bool is_valid =
+            existing_size >= sizeof(Header) &&
+            pread(file_descriptor, &existing, sizeof(Header), 0) ==
+            static_cast<ssize_t>(sizeof(Header)) &&
+            existing.magic == MAGIC &&
+            existing.version == VERSION &&
+            existing.bins_per_state == static_cast<uint32_t>(bins_per_state) &&
+            existing.task_hash == task_hash &&
+            existing_size == sizeof(Header) + existing.num_slots * slot_size;
+        if (!is_valid) {
+            /*
+              Other planner runs may still use the file, so we must neither
+              clear nor resize it.
+            */
+            if (log.is_warning()) {
+                log << "Warning: persistent heuristic cache " << filename
+                    << " was created for a different task or state size "
+                    << "and is not used." << endl;
+            }
+            close(file_descriptor);
+            file_descriptor = -1;
+            return;
+        }
+        num_slots = existing.num_slots;
+    }
+    file_size = sizeof(Header) + num_slots * slot_size;
+    // Extending the empty file fills all slots with EMPTY_KEY.
+    if (is_new && ftruncate(file_descriptor, file_size) == -1) {
+        exit_with_cache_error(filename, strerror(errno));
+    }
+
+    void *mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, file_descriptor, 0);
+    if (mapping == MAP_FAILED) {
+        exit_with_cache_error(filename, strerror(errno));
+    }
+    data = static_cast<char *>(mapping);
+    header = reinterpret_cast<Header *>(data);
+    if (is_new) {
+        header->magic = MAGIC;
+        header->version = VERSION;
+        header->bins_per_state = bins_per_state;
+        header->task_hash = task_hash;
+        header->num_slots = num_slots;
+        header->num_entries = 0;
+    }
+    if (flock(file_descriptor, LOCK_UN) == -1) {
+        exit_with_cache_error(filename, strerror(errno));
+    }
+#else
+    utils::unused_variable(task_hash);
+    exit_with_cache_error(
+        filename, "memory-mapped files are not supported on this platform");
+#endif
+
+    if (log.is_at_least_normal()) {
+        log << "Persistent heuristic cache " << filename << ": "
+            << atomic_ref<uint64_t>(header->num_entries).load(
+            memory_order_relaxed) << " stored values, "
+            << num_slots << " slots" << endl;
+    }
+}
+
+PersistentHeuristicCache::~PersistentHeuristicCache() {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    if (data) {
+        munmap(data, file_size);
+    }
+    if (file_descriptor != -1) {
+        close(file_descriptor);
+    }
+#endif
+}
+
+char *PersistentHeuristicCache::get_slot(size_t index) const {
+    assert(index < num_slots);
+    return data + sizeof(Header) + index * slot_size;
+}
+
+bool PersistentHeuristicCache::is_usable() const {
+    return data != nullptr;
+}
+
+size_t PersistentHeuristicCache::get_first_index(
+    uint64_t key, const PackedStateBin *buffer) const {
+    utils::HashState hash_state;
+    utils::feed(hash_state, key);
+    for (int i = 0; i < bins_per_state; ++i) {
+        utils::feed(hash_state, buffer[i]);
+    }
+    return hash_state.get_hash64() % num_slots;
+}
+
+bool PersistentHeuristicCache::has_state(
+    const char *slot, const PackedStateBin *buffer) const {
+    return memcmp(slot + STATE_OFFSET, buffer,
+                  bins_per_state * sizeof(PackedStateBin)) == 0;
+}
+
+bool PersistentHeuristicCache::lookup(
+    uint64_t key, const PackedStateBin *buffer, int &value) const {
+    assert(key != EMPTY_KEY && key != BUSY_KEY);
+    size_t index = get_first_index(key, buffer);
+    size_t max_probes = min(MAX_PROBES, num_slots);
+    for (size_t probe = 0; probe < max_probes; ++probe) {
+        char *slot = get_slot(index);
+        uint64_t slot_key = get_slot_key(slot).load(memory_order_acquire);
+        if (slot_key == EMPTY_KEY) {
+            return false;
+        }
+        if (slot_key == key && has_state(slot, buffer)) {
+            int32_t stored_value;
+            memcpy(&stored_value, slot + VALUE_OFFSET, sizeof(stored_value));
+            value = stored_value;
+            return true;
+        }
+        if (++index == num_slots) {
+            index = 0;
+        }
+    }
+    return false;
+}
+
+void PersistentHeuristicCache::store(
+    uint64_t key, const PackedStateBin *buffer, int value,
+    utils::LogProxy &log) {
+    assert(key != EMPTY_KEY && key != BUSY_KEY);
+    size_t index = get_first_index(key, buffer);
+    size_t max_probes = min(MAX_PROBES, num_slots);
+    for (size_t probe = 0; probe < max_probes; ++probe) {
+        char *slot = get_slot(index);
+        atomic_ref<uint64_t> slot_key = get_slot_key(slot);
+        uint64_t current_key = slot_key.load(memory_order_acquire);
+        if (current_key == EMPTY_KEY &&
+            slot_key.compare_exchange_strong(
+                current_key, BUSY_KEY, memory_order_acquire)) {
+            /*
+              We own the slot now. Write the key last, so that readers only
+              see the slot once it is complete.
+            */
+            int32_t stored_value = value;
+            memcpy(slot + VALUE_OFFSET, &stored_value, sizeof(stored_value));
+            memcpy(slot + STATE_OFFSET, buffer,
+                   bins_per_state * sizeof(PackedStateBin));
+            slot_key.store(key, memory_order_release);
+            atomic_ref<uint64_t>(header->num_entries).fetch_add(
+                1, memory_order_relaxed);
+            return;
+        }
+        // A failed exchange has loaded the key that another run has written.
+        if (current_key == key && has_state(slot, buffer)) {
+            return;
+        }
+        if (++index == num_slots) {
+            index = 0;
+        }
+    }
+    if (!reported_full_table && log.is_warning()) {
+        log << "Persistent heuristic cache is full, "
+            << "new values are no longer stored." << endl;
+        reported_full_table = true;
+    }
+}
+
+void set_cache_file(const string &filename, int size_in_mb) {
+    assert(!cache);
+    cache_filename = filename;
+    cache_size_in_bytes = static_cast<size_t>(size_in_mb) * 1024 * 1024;
+}
+
+PersistentHeuristicCache *get_cache(const State &state, utils::LogProxy &log) {
+    if (cache_filename.empty()) {
+        return nullptr;
+    }
+    if (!cache) {
+        const StateRegistry *registry = state.get_registry();
+        assert(registry);
+        cache = utils::make_unique_ptr<PersistentHeuristicCache>(
+            cache_filename, cache_size_in_bytes,
+            task_properties::compute_task_hash(state.get_task()),
+            registry->get_state_size_in_bytes() / sizeof(PackedStateBin),
+            log);
+    }
+    return cache->is_usable() ? cache.get() : nullptr;
+}
+
+uint64_t compute_key(const string &configuration) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, static_cast<int>(configuration.size()));
+    for (char c : configuration) {
+        utils::feed(hash_state, static_cast<int>(c));
+    }
+    uint64_t key = hash_state.get_hash64();
+    return (key == EMPTY_KEY || key == BUSY_KEY) ? 1 : key;
+}
+}
@@ -0,0 +1,89 @@
+#ifndef PERSISTENT_HEURISTIC_CACHE_H
+#define PERSISTENT_HEURISTIC_CACHE_H
+
+#include "state_registry.h"
+
+#include <cstdint>
+#include <string>
+
+class State;
+
+namespace utils {
+class LogProxy;
+}
+
+namespace persistent_heuristic_cache {
+/*
+  Heuristic values stored in a memory-mapped file, so that they outlive
+  the search. This allows reusing them in later phases of iterated
+  searches and in later planner runs of a portfolio on the same task.
+
+  The file contains a hash table with a fixed number of slots (using
+  linear probing). Each slot stores a packed state, a key identifying the
+  configuration of the heuristic that computed the value, and the value
+  itself. Storing the complete packed state instead of its hash makes
+  sure that hash collisions never lead to wrong values. The file header
+  stores a hash of the planning task and the size of packed states.
+  Files created for a different task or state size are not used (and not
+  modified). Once the table is full, new values are no longer stored.
+
+  All heuristics of a planner run share the same file, and concurrent
+  planner runs may share it as well. A file lock protects the creation
+  of the file, and slots are claimed and published with atomic
+  operations on their keys, so that readers never see incomplete slots.
+  Only registered states can be cached.
+*/
+class PersistentHeuristicCache {
+    struct Header;
+
+    int bins_per_state;
+    std::size_t slot_size;
+    std::size_t num_slots;
+    std::size_t file_size;
+    int file_descriptor;
+    char *data;
+    Header *header;
+    bool reported_full_table;
+
+    char *get_slot(std::size_t index) const;
+    std::size_t get_first_index(
+        std::uint64_t key, const PackedStateBin *buffer) const;
+    bool has_state(const char *slot, const PackedStateBin *buffer) const;
+public:
+    PersistentHeuristicCache(
+        const std::string &filename, std::size_t size_in_bytes,
+        std::uint64_t task_hash, int bins_per_state, utils::LogProxy &log);
+    ~PersistentHeuristicCache();
+
+    // Return false if the file could not be used (see above).
+    bool is_usable() const;
+
+    /*
+      Return true and set value if a value for the given heuristic key and
+      packed state is stored. Return false otherwise.
+    */
+    bool lookup(std::uint64_t key, const PackedStateBin *buffer, int &value) const;
+    void store(std::uint64_t key, const PackedStateBin *buffer, int value,
+               utils::LogProxy &log);
+};
+
+/*
+  Set the file that holds the persistent heuristic cache and its size in
+  MiB. This has to happen before the first call to get_cache.
+*/
+extern void set_cache_file(const std::string &filename, int size_in_mb);
+
+/*
+  Return the persistent heuristic cache for the task of the given
+  registered state, opening (or creating) the cache file on the first
+  call. Return nullptr if no cache file has been set or if the file
+  belongs to a different task.
+*/
+extern PersistentHeuristicCache *get_cache(
+    const State &state, utils::LogProxy &log);
+
+// Compute a key for the heuristic with the given configuration string.
+extern std::uint64_t compute_key(const std::string &configuration);
+}
+
+#endif
@@ -17,4 +17,12 @@ const string &Options::get_unparsed_config() const {
 void Options::set_unparsed_config(const string &config) {
     unparsed_config = config;
 }
+
+const string &Options::get_normalized_config() const {
+    return normalized_config;
+}
+
+void Options::set_normalized_config(const string &config) {
+    normalized_config = config;
+}
 }
@@ -68,6 +68,7 @@ struct OptionsAnyCaster<std::vector<T>> {
 class Options {
     std::unordered_map<std::string, Any> storage;
     std::string unparsed_config;
+    std::string normalized_config;
 public:
     explicit Options();
     /*
@@ -118,6 +119,17 @@ public:
     bool contains(const std::string &key) const;
     const std::string &get_unparsed_config() const;
     void set_unparsed_config(const std::string &config);
+
+    /*
+      The normalized configuration lists all options that influence the
+      results of the constructed object, including default values, in a
+      canonical form. Configurations that only differ in spelling or in
+      options marked as result-independent have the same normalized
+      configuration, so it can identify persistently stored results. It
+      is empty for options not created by the parser.
+    */
+    const std::string &get_normalized_config() const;
+    void set_normalized_config(const std::string &config);
 };
 
 template<typename T>
@@ -56,6 +56,16 @@ string Feature::get_subcategory() const {
     return subcategory;
 }
 
+void Feature::mark_result_independent(const string &key) {
+    for (ArgumentInfo &argument : arguments) {
+        if (argument.key == key) {
+            argument.affects_result = false;
+            return;
+        }
+    }
+    ABORT("Feature " + this->key + " has no option " + key + ".");
+}
+
 const vector<ArgumentInfo> &Feature::get_arguments() const {
     return arguments;
 }
@@ -63,6 +63,13 @@ public:
     void document_note(
         const std::string &title, const std::string &note, bool long_text = false);
 
+    /*
+      Declare that the option with the given key does not influence the
+      results of the constructed object. Such options are left out of
+      normalized configurations (see Options::get_normalized_config).
+    */
+    void mark_result_independent(const std::string &key);
+
     const Type &get_type() const;
     std::string get_key() const;
     std::string get_title() const;
@@ -20,7 +20,8 @@ ArgumentInfo::ArgumentInfo(
       type(type),
       default_value(default_value),
       bounds(bounds),
-      lazy_construction(lazy_construction) {
+      lazy_construction(lazy_construction),
+      affects_result(true) {
 }
 
 bool ArgumentInfo::is_optional() const {
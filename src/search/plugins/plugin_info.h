@@ -20,6 +20,12 @@ struct ArgumentInfo {
     // TODO: once we switch to builder, this should no longer be necessary.
     bool lazy_construction;
 
+    /*
+      False for options that do not influence the results of the
+      constructed object, e.g., options for logging or parallelization.
+    */
+    bool affects_result;
+
     ArgumentInfo(
         const std::string &key,
         const std::string &help,
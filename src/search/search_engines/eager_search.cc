@@ -6,12 +6,14 @@
 #include "../pruning_method.h"
 
 #include "../algorithms/ordered_set.h"
-#include "../plugins/options.h"
+#include "../plugins/plugin.h"
 #include "../task_utils/successor_generator.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <limits>
 #include <memory>
 #include <optional.hh>
 #include <set>
@@ -22,6 +24,7 @@ namespace eager_search {
 EagerSearch::EagerSearch(const plugins::Options &opts)
     : SearchEngine(opts),
       reopen_closed_nodes(opts.get<bool>("reopen_closed")),
+      f_bound_pruning(opts.get<bool>("f_bound_pruning")),
       open_list(opts.get<shared_ptr<OpenListFactory>>("open")->
                 create_state_open_list()),
       f_evaluator(opts.get<shared_ptr<Evaluator>>("f_eval", nullptr)),
@@ -32,6 +35,10 @@ EagerSearch::EagerSearch(const plugins::Options &opts)
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
     }
+    if (f_bound_pruning && !f_evaluator) {
+        cerr << "f_bound_pruning requires an f_eval" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
 }
 
 void EagerSearch::initialize() {
@@ -80,12 +87,15 @@ void EagerSearch::initialize() {
       Note: we consider the initial state as reached by a preferred
       operator.
     */
-    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    EvaluationContext eval_context(
+        initial_state, 0, true, &statistics, false, get_cutoff(0));
 
     statistics.inc_evaluated_states();
 
     if (open_list->is_dead_end(eval_context)) {
         log << "Initial state is a dead end." << endl;
+    } else if (is_pruned_by_f_bound(eval_context)) {
+        log << "Initial state exceeds the bound." << endl;
     } else {
         if (search_progress.check_progress(eval_context))
             statistics.print_checkpoint_line(0);
@@ -218,7 +228,8 @@ SearchStatus EagerSearch::step() {
             int succ_g = node->get_g() + get_adjusted_cost(op);
 
             EvaluationContext succ_eval_context(
-                succ_state, succ_g, is_preferred, &statistics);
+                succ_state, succ_g, is_preferred, &statistics, false,
+                get_cutoff(node->get_real_g() + op.get_cost()));
             statistics.inc_evaluated_states();
 
             if (open_list->is_dead_end(succ_eval_context)) {
@@ -226,6 +237,13 @@ SearchStatus EagerSearch::step() {
                 statistics.inc_dead_ends();
                 continue;
             }
+            /*
+              Unlike dead ends, states exceeding the bound are not marked:
+              they may be reached again later with a lower g-value.
+            */
+            if (is_pruned_by_f_bound(succ_eval_context)) {
+                continue;
+            }
             succ_node.open(*node, op, get_adjusted_cost(op));
 
             open_list->insert(succ_eval_context, succ_state.get_id());
@@ -236,6 +254,15 @@ SearchStatus EagerSearch::step() {
         } else if (succ_node.get_g() > node->get_g() + get_adjusted_cost(op)) {
             // We found a new cheapest path to an open or closed state.
             if (reopen_closed_nodes) {
+                int succ_g = node->get_g() + get_adjusted_cost(op);
+                EvaluationContext succ_eval_context(
+                    succ_state, succ_g, is_preferred, &statistics, false,
+                    get_cutoff(node->get_real_g() + op.get_cost()));
+
+                // As for new states, the node is left untouched if pruned.
+                if (is_pruned_by_f_bound(succ_eval_context)) {
+                    continue;
+                }
                 if (succ_node.is_closed()) {
                     /*
                       TODO: It would be nice if we had a way to test
@@ -248,9 +275,6 @@ SearchStatus EagerSearch::step() {
                 }
                 succ_node.reopen(*node, op, get_adjusted_cost(op));
 
-                EvaluationContext succ_eval_context(
-                    succ_state, succ_node.get_g(), is_preferred, &statistics);
-
                 /*
                   Note: our old code used to retrieve the h value from
                   the search node here. Our new code recomputes it as
@@ -281,6 +305,25 @@ SearchStatus EagerSearch::step() {
     return IN_PROGRESS;
 }
 
+int EagerSearch::get_cutoff(int real_g) const {
+    /*
+      With f-bound pruning, states with real_g + h >= bound are pruned, so
+      heuristics do not need to compute values beyond bound - real_g.
+      This requires that f-values are expressed in terms of the real
+      operator costs.
+    */
+    if (!f_bound_pruning || bound == numeric_limits<int>::max() ||
+        cost_type != NORMAL) {
+        return EvaluationResult::INFTY;
+    }
+    return max(bound - real_g, 0);
+}
+
+bool EagerSearch::is_pruned_by_f_bound(EvaluationContext &eval_context) {
+    return f_bound_pruning && cost_type == NORMAL &&
+           eval_context.get_evaluator_value_or_infinity(f_evaluator.get()) >= bound;
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
@@ -308,6 +351,15 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 }
 
 void add_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<bool>(
+        "f_bound_pruning",
+        "prune states whose f_eval value is at least the bound. This is only "
+        "safe if f_eval never overestimates the cost of the cheapest plan "
+        "through a state, e.g., g+h for an admissible heuristic h. Some "
+        "heuristics (e.g., lmcut, cpdbs and operatorcounting) use the "
+        "remaining bound to stop their computation early. Only used with "
+        "cost_type=normal.",
+        "false");
     SearchEngine::add_pruning_option(feature);
     SearchEngine::add_options_to_feature(feature);
 }
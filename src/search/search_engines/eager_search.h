@@ -17,6 +17,7 @@ class Feature;
 namespace eager_search {
 class EagerSearch : public SearchEngine {
     const bool reopen_closed_nodes;
+    const bool f_bound_pruning;
 
     std::unique_ptr<StateOpenList> open_list;
     std::shared_ptr<Evaluator> f_evaluator;
@@ -30,6 +31,8 @@ class EagerSearch : public SearchEngine {
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
+    int get_cutoff(int real_g) const;
+    bool is_pruned_by_f_bound(EvaluationContext &eval_context);
 
 protected:
     virtual void initialize() override;
@@ -1,5 +1,6 @@
 #include "task_properties.h"
 
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
 #include "../utils/system.h"
@@ -100,6 +101,60 @@ int get_num_total_effects(const TaskProxy &task_proxy) {
     return num_effects;
 }
 
+static void feed_string(utils::HashState &hash_state, const string &str) {
+    utils::feed(hash_state, static_cast<int>(str.size()));
+    for (char c : str) {
+        utils::feed(hash_state, static_cast<int>(c));
+    }
+}
+
+static void feed_conditions(
+    utils::HashState &hash_state, const ConditionsProxy &conditions) {
+    utils::feed(hash_state, static_cast<int>(conditions.size()));
+    for (FactProxy fact : conditions) {
+        utils::feed(hash_state, fact.get_pair());
+    }
+}
+
+static void feed_operator(utils::HashState &hash_state, const OperatorProxy &op) {
+    feed_string(hash_state, op.get_name());
+    utils::feed(hash_state, op.get_cost());
+    feed_conditions(hash_state, op.get_preconditions());
+    EffectsProxy effects = op.get_effects();
+    utils::feed(hash_state, static_cast<int>(effects.size()));
+    for (EffectProxy effect : effects) {
+        feed_conditions(hash_state, effect.get_conditions());
+        utils::feed(hash_state, effect.get_fact().get_pair());
+    }
+}
+
+uint64_t compute_task_hash(const TaskProxy &task_proxy) {
+    utils::HashState hash_state;
+    VariablesProxy variables = task_proxy.get_variables();
+    utils::feed(hash_state, static_cast<int>(variables.size()));
+    for (VariableProxy var : variables) {
+        utils::feed(hash_state, var.get_domain_size());
+        utils::feed(hash_state, var.get_axiom_layer());
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            feed_string(hash_state, var.get_fact(value).get_name());
+        }
+    }
+    OperatorsProxy operators = task_proxy.get_operators();
+    utils::feed(hash_state, static_cast<int>(operators.size()));
+    for (OperatorProxy op : operators) {
+        feed_operator(hash_state, op);
+    }
+    AxiomsProxy axioms = task_proxy.get_axioms();
+    utils::feed(hash_state, static_cast<int>(axioms.size()));
+    for (OperatorProxy axiom : axioms) {
+        feed_operator(hash_state, axiom);
+    }
+    feed_conditions(hash_state, task_proxy.get_goals());
+    State initial_state = task_proxy.get_initial_state();
+    utils::feed(hash_state, initial_state.get_unpacked_values());
+    return hash_state.get_hash64();
+}
+
 void print_variable_statistics(const TaskProxy &task_proxy) {
     const int_packer::IntPacker &state_packer = g_state_packers[task_proxy];
 
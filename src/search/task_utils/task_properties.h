@@ -6,6 +6,8 @@
 
 #include "../algorithms/int_packer.h"
 
+#include <cstdint>
+
 namespace task_properties {
 inline bool is_applicable(OperatorProxy op, const State &state) {
     for (FactProxy precondition : op.get_preconditions()) {
@@ -76,6 +78,13 @@ std::vector<FactPair> get_fact_pairs(const FactProxyCollection &facts) {
     return fact_pairs;
 }
 
+/*
+  Return a hash of the complete task (variables and fact names, operators,
+  axioms, goals and initial state). It identifies the task in files that
+  are reused across planner runs.
+*/
+extern std::uint64_t compute_task_hash(const TaskProxy &task_proxy);
+
 extern void print_variable_statistics(const TaskProxy &task_proxy);
 extern void dump_pddl(const State &state);
 extern void dump_fdr(const State &state);
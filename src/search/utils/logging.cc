@@ -27,6 +27,7 @@ void add_log_options_to_feature(plugins::Feature &feature) {
         "verbosity",
         "Option to specify the verbosity level.",
         "normal");
+    feature.mark_result_independent("verbosity");
 }
 
 LogProxy get_log_from_options(const plugins::Options &options) {
@@ -44,6 +45,10 @@ LogProxy get_silent_log() {
     return utils::get_log_from_options(opts);
 }
 
+LogProxy get_stream_log(ostream &stream, Verbosity verbosity) {
+    return LogProxy(make_shared<Log>(stream, verbosity));
+}
+
 ContextError::ContextError(const string &msg)
     : Exception(msg) {
 }
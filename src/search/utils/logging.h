@@ -41,6 +41,10 @@ public:
         : stream(std::cout), verbosity(verbosity), line_has_started(false) {
     }
 
+    Log(std::ostream &stream, Verbosity verbosity)
+        : stream(stream), verbosity(verbosity), line_has_started(false) {
+    }
+
     template<typename T>
     Log &operator<<(const T &elem) {
         if (!line_has_started) {
@@ -63,6 +67,14 @@ public:
         return *this;
     }
 
+    /*
+      Write output that already consists of complete lines with their
+      prefixes, e.g. the output of a log that writes to a buffer.
+    */
+    void write_lines(const std::string &lines) {
+        stream << lines;
+    }
+
     Verbosity get_verbosity() const {
         return verbosity;
     }
@@ -103,6 +115,14 @@ public:
         return *this;
     }
 
+    void write_lines(const std::string &lines) {
+        log->write_lines(lines);
+    }
+
+    Verbosity get_verbosity() const {
+        return log->get_verbosity();
+    }
+
     bool is_at_least_normal() const {
         return log->get_verbosity() >= Verbosity::NORMAL;
     }
@@ -132,6 +152,12 @@ extern LogProxy g_log;
 extern void add_log_options_to_feature(plugins::Feature &feature);
 extern LogProxy get_log_from_options(const plugins::Options &options);
 extern LogProxy get_silent_log();
+/*
+  Return a log with the given verbosity that writes to the given stream,
+  e.g. to buffer the output of concurrent computations until it can be
+  written to another log with write_lines.
+*/
+extern LogProxy get_stream_log(std::ostream &stream, Verbosity verbosity);
 
 class ContextError : public utils::Exception {
 public:
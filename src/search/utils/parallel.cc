@@ -0,0 +1,136 @@
+#include "parallel.h"
+
+#include <limits>
+
+using namespace std;
+
+namespace utils {
+static thread_local int thread_limit = numeric_limits<int>::max();
+
+int get_thread_limit() {
+    return thread_limit;
+}
+
+ScopedThreadLimit::ScopedThreadLimit(int max_num_threads)
+    : previous_limit(thread_limit) {
+    assert(max_num_threads >= 1);
+    thread_limit = min(thread_limit, max_num_threads);
+}
+
+ScopedThreadLimit::~ScopedThreadLimit() {
+    thread_limit = previous_limit;
+}
+
+ThreadPool::ThreadPool(int num_threads)
+    : job(nullptr),
+      num_items(0),
+      next_item(0),
+      num_started_jobs(0),
+      num_busy_workers(0),
+      shutting_down(false) {
+    assert(num_threads >= 1);
+    num_threads = min(num_threads, thread_limit);
+    workers.reserve(num_threads - 1);
+    for (int i = 1; i < num_threads; ++i) {
+        workers.emplace_back([this]() {work();});
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        shutting_down = true;
+    }
+    job_started.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::work() {
+    int num_seen_jobs = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(pool_mutex);
+            job_started.wait(lock, [&]() {
+                                 return shutting_down ||
+                                 num_started_jobs != num_seen_jobs;
+                             });
+            if (shutting_down) {
+                return;
+            }
+            num_seen_jobs = num_started_jobs;
+        }
+        process_items();
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            --num_busy_workers;
+        }
+        job_finished.notify_one();
+    }
+}
+
+void ThreadPool::process_items() {
+    for (int i = next_item++; i < num_items; i = next_item++) {
+        try {
+            (*job)(i);
+        } catch (...) {
+            lock_guard<mutex> lock(pool_mutex);
+            if (!exception) {
+                exception = current_exception();
+            }
+            next_item = num_items;
+        }
+    }
+}
+
+void ThreadPool::run(int num_items_, const function<void(int)> &function) {
+    if (workers.empty() || num_items_ <= 1) {
+        for (int i = 0; i < num_items_; ++i) {
+            function(i);
+        }
+        return;
+    }
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        job = &function;
+        num_items = num_items_;
+        next_item = 0;
+        num_busy_workers = workers.size();
+        ++num_started_jobs;
+    }
+    job_started.notify_all();
+    process_items();
+    exception_ptr job_exception;
+    {
+        unique_lock<mutex> lock(pool_mutex);
+        job_finished.wait(lock, [&]() {return num_busy_workers == 0;});
+        job = nullptr;
+        swap(job_exception, exception);
+    }
+    if (job_exception) {
+        rethrow_exception(job_exception);
+    }
+}
+
+SharedBudget::SharedBudget(size_t total)
+    : total(total),
+      used(0) {
+}
+
+void SharedBudget::acquire(size_t amount) {
+    unique_lock<mutex> lock(budget_mutex);
+    budget_released.wait(
+        lock, [&]() {return used == 0 || amount <= total - min(used, total);});
+    used += amount;
+}
+
+void SharedBudget::release(size_t amount) {
+    {
+        lock_guard<mutex> lock(budget_mutex);
+        assert(used >= amount);
+        used -= amount;
+    }
+    budget_released.notify_all();
+}
+}
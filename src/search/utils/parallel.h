@@ -0,0 +1,164 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  Return the maximum number of threads that parallel loops started by the
+  calling thread may use (see ScopedThreadLimit).
+*/
+extern int get_thread_limit();
+
+/*
+  Limit the number of threads used by parallel loops that the calling
+  thread starts while the object exists. Computations that already run
+  concurrently use this to run nested parallel loops (e.g. within a shrink
+  strategy) on a single thread, so that the numbers of threads do not
+  multiply.
+*/
+class ScopedThreadLimit {
+    int previous_limit;
+public:
+    explicit ScopedThreadLimit(int max_num_threads);
+    ~ScopedThreadLimit();
+    ScopedThreadLimit(const ScopedThreadLimit &) = delete;
+    ScopedThreadLimit &operator=(const ScopedThreadLimit &) = delete;
+};
+
+/*
+  A fixed set of threads that repeatedly processes jobs together with the
+  calling thread. Creating the threads once avoids paying for their
+  creation in loops that run many short parallel steps.
+*/
+class ThreadPool {
+    std::vector<std::thread> workers;
+    std::mutex pool_mutex;
+    std::condition_variable job_started;
+    std::condition_variable job_finished;
+    const std::function<void(int)> *job;
+    int num_items;
+    std::atomic<int> next_item;
+    int num_started_jobs;
+    int num_busy_workers;
+    bool shutting_down;
+    std::exception_ptr exception;
+
+    void work();
+    void process_items();
+public:
+    /*
+      Use num_threads threads, including the calling thread, but no more
+      than get_thread_limit.
+    */
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    /*
+      Call function(i) for all 0 <= i < num_items, using the calling
+      thread and all threads of the pool (see parallel_for). If a call
+      throws an exception, no further items are handed out and the first
+      exception is rethrown in the calling thread.
+    */
+    void run(int num_items, const std::function<void(int)> &function);
+};
+
+/*
+  Call function(i) for all 0 <= i < num_items, using up to num_threads
+  threads (including the calling thread). Items are handed out in
+  increasing order but may finish in any order, so function(i) should
+  only write to data that belongs to item i (e.g., the i-th entry of a
+  preallocated result vector) or synchronize its accesses otherwise.
+  With a single thread, all items are processed in order by the calling
+  thread. The number of threads is capped by get_thread_limit. Exceptions are rethrown in the calling thread.
+
+  Each call creates new threads, so loops that call this many times for
+  few items should use a ThreadPool instead.
+*/
+template<typename Function>
+void parallel_for(int num_items, int num_threads, const Function &function) {
+    assert(num_threads >= 1);
+    num_threads = std::min({num_threads, num_items, get_thread_limit()});
+    if (num_threads <= 1) {
+        for (int i = 0; i < num_items; ++i) {
+            function(i);
+        }
+        return;
+    }
+    ThreadPool thread_pool(num_threads);
+    thread_pool.run(num_items, function);
+}
+
+/*
+  Sort the range [first, last) using up to num_threads threads by sorting
+  equally sized chunks concurrently and then merging them pairwise. If comp
+  is a strict total order, the result does not depend on num_threads.
+*/
+template<typename RandomIt, typename Compare>
+void parallel_sort(
+    RandomIt first, RandomIt last, const Compare &comp, int num_threads) {
+    assert(num_threads >= 1);
+    std::ptrdiff_t size = last - first;
+    num_threads = std::min(num_threads, get_thread_limit());
+    int num_chunks = static_cast<int>(
+        std::min<std::ptrdiff_t>(num_threads, size));
+    if (num_chunks <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+    std::vector<RandomIt> chunk_begin;
+    chunk_begin.reserve(num_chunks + 1);
+    for (int i = 0; i <= num_chunks; ++i) {
+        chunk_begin.push_back(first + size * i / num_chunks);
+    }
+    parallel_for(
+        num_chunks, num_threads,
+        [&](int i) {
+            std::sort(chunk_begin[i], chunk_begin[i + 1], comp);
+        });
+    for (int width = 1; width < num_chunks; width *= 2) {
+        int num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+        parallel_for(
+            num_merges, num_threads,
+            [&](int i) {
+                int left = 2 * i * width;
+                int middle = std::min(left + width, num_chunks);
+                int right = std::min(left + 2 * width, num_chunks);
+                if (middle < right) {
+                    std::inplace_merge(
+                        chunk_begin[left], chunk_begin[middle],
+                        chunk_begin[right], comp);
+                }
+            });
+    }
+}
+
+/*
+  A budget (e.g., of memory) shared by concurrently running computations.
+  acquire() blocks until the requested amount is available. A request
+  exceeding the total budget is granted as soon as nothing else is
+  acquired, so no request blocks forever.
+*/
+class SharedBudget {
+    std::mutex budget_mutex;
+    std::condition_variable budget_released;
+    const std::size_t total;
+    std::size_t used;
+public:
+    explicit SharedBudget(std::size_t total);
+
+    void acquire(std::size_t amount);
+    void release(std::size_t amount);
+};
+}
+
+#endif